@@ -0,0 +1,87 @@
+/**
+ * @file profile_arity.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Compare the push-all/pop-all time of ospp::PriorityQueue for
+ *  different heap arities and element types.
+ */
+
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "queue/queue.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+const int kRuns = 10;
+
+/**
+ * @brief Push <em>keys.size()</em> items into a queue, then pop all of them.
+ * @param keys The keys pushed into the queue.
+ * @return The summary of the times.
+ */
+template<typename T, size_t Arity>
+Summary profileArity(const vector<int64_t>& keys)
+{
+  vector<double> times;
+  times.reserve(kRuns);
+
+  for (int i = 0; i < kRuns; ++i)
+  {
+    ospp::PriorityQueue<T, less<T>, allocator<T>, Arity> pq;
+    times.push_back(timeIt([&]() {
+      for (auto k : keys)
+        pq.push(T(k));
+      while (!pq.empty())
+        pq.pop();
+    }));
+  }
+
+  return summarize(times);
+}
+
+/**
+ * @brief Profile arities 2, 4, 8 and 16 for one element type.
+ * @param name The name of the element type.
+ * @param keys The keys pushed into the queue.
+ */
+template<typename T>
+void profileType(const string& name, const vector<int64_t>& keys)
+{
+  cout << "--------- " << name << " (" << sizeof(T) << " bytes)" << endl;
+  cout << "arity 2:  " << profileArity<T, 2>(keys) << endl;
+  cout << "arity 4:  " << profileArity<T, 4>(keys) << endl;
+  cout << "arity 8:  " << profileArity<T, 8>(keys) << endl;
+  cout << "arity 16: " << profileArity<T, 16>(keys) << endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+
+  auto randEngine = default_random_engine(31);
+  auto uniDist = uniform_int_distribution<int64_t>();
+  vector<int64_t> keys;
+  keys.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    keys.push_back(uniDist(randEngine));
+
+  cout << "elements: " << count << ", runs: " << kRuns << endl;
+  profileType<int>("int", keys);
+  profileType<double>("double", keys);
+  profileType<Payload<32>>("struct", keys);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file profile_bheap.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Compare the flat layout of ospp::PriorityQueue with the B-heap
+ *  layout over heap sizes from 1K items up to a given size. Each run fills a
+ *  heap and then times a fixed number of hold operations, a pop followed by a
+ *  push of a slightly larger key, which keeps the heap at the same size.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "queue/queue.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+const int kRuns = 3;
+const size_t kHolds = 1000000;
+const size_t kPage = 4096;
+
+/**
+ * Allocator that aligns every buffer to a page, so that the blocks of a
+ * B-heap line up with pages.
+ */
+template<typename T>
+struct PageAllocator
+{
+  using value_type = T;
+
+  PageAllocator() = default;
+  template<typename U>
+  PageAllocator(const PageAllocator<U>&) {}
+
+  T* allocate(size_t n)
+  {
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, kPage, n * sizeof(T)))
+      throw bad_alloc();
+    return static_cast<T*>(ptr);
+  }
+
+  void deallocate(T *ptr, size_t) { free(ptr); }
+
+  template<typename U>
+  bool operator==(const PageAllocator<U>&) const { return true; }
+  template<typename U>
+  bool operator!=(const PageAllocator<U>&) const { return false; }
+};
+
+/**
+ * @brief Fill a queue with <em>count</em> random keys, then time the holds.
+ * @param count The number of items in the queue.
+ * @return The summary of the times per hold operation, in seconds.
+ */
+template<typename Queue>
+Summary profileHold(size_t count)
+{
+  vector<double> times;
+  times.reserve(kRuns);
+
+  for (int i = 0; i < kRuns; ++i)
+  {
+    auto randEngine = default_random_engine(41 + i);
+    auto uniDist = uniform_int_distribution<int64_t>(0, 1 << 30);
+
+    Queue pq;
+    pq.reserve(count);
+    for (size_t j = 0; j < count; ++j)
+      pq.push(uniDist(randEngine));
+
+    times.push_back(timeIt([&]() {
+      for (size_t j = 0; j < kHolds; ++j) {
+        auto key = pq.top();
+        pq.pop();
+        pq.push(key + uniDist(randEngine));
+      }
+    }) / kHolds);
+  }
+
+  return summarize(times);
+}
+
+template<size_t Arity, typename Layout>
+using Queue = ospp::PriorityQueue<int64_t, less<int64_t>,
+                                  PageAllocator<int64_t>, Arity,
+                                  ospp::DoublingGrowth, ospp::TopDownPop,
+                                  Layout>;
+
+/**
+ * @brief Print the mean time per hold in nanoseconds.
+ */
+void printNanos(const Summary& s)
+{
+  cout << setw(12) << fixed << setprecision(1) << s.mean * 1e9;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  size_t limit = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10000000;
+
+  cout << "int64 keys, " << kHolds << " holds per run, " << kRuns
+       << " runs, mean ns per hold" << endl;
+  cout << setw(10) << "items"
+       << setw(12) << "flat 2" << setw(12) << "flat 4"
+       << setw(12) << "bheap 2" << endl;
+
+  for (size_t count = 1000; count <= limit; count *= 10)
+  {
+    cout << setw(10) << count;
+    printNanos(profileHold<Queue<2, ospp::FlatLayout>>(count));
+    printNanos(profileHold<Queue<4, ospp::FlatLayout>>(count));
+    printNanos(profileHold<Queue<2, ospp::BHeapLayout<kPage>>>(count));
+    cout << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
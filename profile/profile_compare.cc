@@ -0,0 +1,104 @@
+/**
+ * @file profile_compare.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Count the comparisons made by ospp::PriorityQueue::pop with the
+ *  top-down and the bottom-up pop policies, using a composite key with a
+ *  string tie-breaker as the item.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "queue/queue.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+/**
+ * Composite key: a coarse priority, broken by a name.
+ */
+struct Task
+{
+  int32_t priority;
+  string name;
+};
+
+/**
+ * Compares tasks and counts how many times it is called.
+ */
+struct CountingLess
+{
+  uint64_t *count;
+
+  bool operator()(const Task& a, const Task& b) const
+  {
+    ++*count;
+    if (a.priority != b.priority)
+      return a.priority < b.priority;
+    return a.name < b.name;
+  }
+};
+
+/**
+ * @brief Push all the tasks, then pop all of them.
+ * @param tasks The tasks.
+ * @param label The name printed for the policy.
+ */
+template<size_t Arity, typename Pop>
+void profilePop(const vector<Task>& tasks, const string& label)
+{
+  uint64_t count = 0;
+  ospp::PriorityQueue<Task, CountingLess, allocator<Task>, Arity,
+                      ospp::DoublingGrowth, Pop> pq(CountingLess{&count});
+  pq.reserve(tasks.size());
+
+  for (const auto& t : tasks)
+    pq.push(t);
+
+  count = 0;
+  auto seconds = timeIt([&]() {
+    while (!pq.empty())
+      pq.pop();
+  });
+
+  cout << label << " arity " << Arity << ":  comparisons/pop: "
+       << static_cast<double>(count) / tasks.size()
+       << "  seconds: " << seconds << endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+
+  auto randEngine = default_random_engine(31);
+  auto priorityDist = uniform_int_distribution<int32_t>(0, 1000);
+  auto nameDist = uniform_int_distribution<int>(0, 1 << 20);
+
+  vector<Task> tasks;
+  tasks.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    tasks.push_back(Task{priorityDist(randEngine),
+                         "task-" + to_string(nameDist(randEngine))});
+  }
+
+  cout << "elements: " << count << endl;
+  profilePop<2, ospp::TopDownPop>(tasks, "top-down ");
+  profilePop<2, ospp::BottomUpPop>(tasks, "bottom-up");
+  profilePop<4, ospp::TopDownPop>(tasks, "top-down ");
+  profilePop<4, ospp::BottomUpPop>(tasks, "bottom-up");
+
+  return EXIT_SUCCESS;
+}
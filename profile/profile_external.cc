@@ -0,0 +1,115 @@
+/**
+ * @file profile_external.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Push and then pop ten times more data than the memory budget
+ *  of an ospp::ExternalPriorityQueue, and compare it with an in-memory
+ *  ospp::PriorityQueue holding the same keys. Usage:
+ *
+ *    profile_external [budget MiB] [block KiB] [spill directory]
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "queue/external_queue.hh"
+#include "queue/queue.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+const size_t kScale = 10;
+
+/**
+ * Times of a run, in seconds.
+ */
+struct Times
+{
+  double push;
+  double pop;
+};
+
+/**
+ * @brief Push <em>count</em> random keys, then pop them all.
+ * @param pq The queue.
+ * @param count The number of keys.
+ * @return The time to push and to pop all the keys.
+ */
+template<typename Queue>
+Times profileQueue(Queue& pq, size_t count)
+{
+  auto randEngine = default_random_engine(41);
+  auto uniDist = uniform_int_distribution<int64_t>();
+
+  Times times;
+  times.push = timeIt([&]() {
+    for (size_t i = 0; i < count; ++i)
+      pq.push(uniDist(randEngine));
+  });
+
+  int64_t last = 0;
+  times.pop = timeIt([&]() {
+    while (!pq.empty()) {
+      if (pq.top() < last)
+        throw logic_error("keys popped out of order");
+      last = pq.top();
+      pq.pop();
+    }
+  });
+
+  return times;
+}
+
+/**
+ * @brief Print a row of the results.
+ */
+void printRow(const string& name, const Times& times, size_t count)
+{
+  cout << setw(10) << name
+       << setw(12) << times.push * 1e9 / count
+       << setw(12) << times.pop * 1e9 / count
+       << setw(12) << (times.push + times.pop) << endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  size_t budget = (argc > 1 ? strtoul(argv[1], nullptr, 10) : 32) << 20;
+  size_t block = (argc > 2 ? strtoul(argv[2], nullptr, 10) : 1024) << 10;
+  string directory = argc > 3 ? argv[3] : "/tmp";
+  size_t count = kScale * budget / sizeof(int64_t);
+
+  cout << count << " int64 keys, " << (budget >> 20) << " MiB budget, "
+       << (block >> 10) << " KiB blocks, spilled to " << directory << endl;
+  cout << setw(10) << "queue"
+       << setw(12) << "push ns" << setw(12) << "pop ns"
+       << setw(12) << "total s" << endl;
+  cout << fixed << setprecision(1);
+
+  ospp::ExternalPriorityQueue<int64_t> external(budget, directory, block);
+  auto times = profileQueue(external, count);
+  printRow("external", times, count);
+
+  ospp::PriorityQueue<int64_t> memory;
+  printRow("memory", profileQueue(memory, count), count);
+
+  cout << "spills " << external.spills()
+       << ", MiB written " << (external.bytes_written() >> 20)
+       << ", MiB read " << (external.bytes_read() >> 20)
+       << ", disk MiB/s "
+       << (external.bytes_written() + external.bytes_read()) / 1048576.0
+            / (times.push + times.pop)
+       << endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file profile_mmap.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Compare ospp::PriorityQueue on std::allocator with
+ *  ospp::MmapAllocator, which grows the buffer with mremap and backs it with
+ *  transparent huge pages. Each run pushes random keys one at a time into an
+ *  empty queue, so the buffer grows from the default capacity, and then times
+ *  a fixed number of hold operations.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "queue/mmap_allocator.hh"
+#include "queue/queue.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+const int kRuns = 3;
+const size_t kHolds = 1000000;
+
+/**
+ * Mean times of a run, in seconds.
+ */
+struct Times
+{
+  double fill;
+  double hold;
+};
+
+/**
+ * @brief Fill a queue with <em>count</em> random keys, then time the holds.
+ * @param count The number of items pushed.
+ * @return The mean time to fill the queue and per hold operation.
+ */
+template<typename Queue>
+Times profileQueue(size_t count)
+{
+  vector<double> fills;
+  vector<double> holds;
+
+  for (int i = 0; i < kRuns; ++i)
+  {
+    auto randEngine = default_random_engine(41 + i);
+    auto uniDist = uniform_int_distribution<int64_t>(0, 1 << 30);
+
+    Queue pq;
+    fills.push_back(timeIt([&]() {
+      for (size_t j = 0; j < count; ++j)
+        pq.push(uniDist(randEngine));
+    }));
+
+    holds.push_back(timeIt([&]() {
+      for (size_t j = 0; j < kHolds; ++j) {
+        auto key = pq.top();
+        pq.pop();
+        pq.push(key + uniDist(randEngine));
+      }
+    }) / kHolds);
+  }
+
+  return Times{summarize(fills).mean, summarize(holds).mean};
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  size_t limit = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000000;
+
+  using StdQueue = ospp::PriorityQueue<int64_t>;
+  using MmapQueue = ospp::PriorityQueue<int64_t, less<int64_t>,
+                                        ospp::MmapAllocator<int64_t>>;
+
+  cout << "int64 keys, " << kRuns << " runs, fill in ms, hold in ns" << endl;
+  cout << setw(10) << "items"
+       << setw(12) << "fill std" << setw(12) << "fill mmap"
+       << setw(12) << "hold std" << setw(12) << "hold mmap" << endl;
+  cout << fixed << setprecision(1);
+
+  for (size_t count = 1000000; count <= limit; count *= 10)
+  {
+    auto heap = profileQueue<StdQueue>(count);
+    auto mapped = profileQueue<MmapQueue>(count);
+    cout << setw(10) << count
+         << setw(12) << heap.fill * 1e3 << setw(12) << mapped.fill * 1e3
+         << setw(12) << heap.hold * 1e9 << setw(12) << mapped.hold * 1e9
+         << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file profile_multi_queue.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Measure the throughput of ospp::MultiQueue against a mutex
+ *  wrapped ospp::PriorityQueue, and the rank error of MultiQueue pops.
+ *
+ *  usage: profile_multi_queue [threads] [operations per thread]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "queue/multi_queue.hh"
+#include "queue/queue.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+const size_t kPrefill = 1 << 20;
+
+/**
+ * A PriorityQueue behind a single lock, with the same interface as MultiQueue.
+ */
+class LockedQueue
+{
+  mutex mLock;
+  ospp::PriorityQueue<uint64_t> mQueue;
+
+public:
+  void push(uint64_t value)
+  {
+    lock_guard<mutex> guard(mLock);
+    mQueue.push(value);
+  }
+
+  bool try_pop(uint64_t& value)
+  {
+    lock_guard<mutex> guard(mLock);
+    if (mQueue.empty())
+      return false;
+    value = mQueue.pop_value();
+    return true;
+  }
+};
+
+/**
+ * @brief Run a mix of pushes and pops on several threads.
+ * @param queue The queue, already holding some items.
+ * @param threads The number of threads.
+ * @param operations The number of push/pop pairs per thread.
+ * @return The number of operations per second.
+ */
+template<typename Queue>
+double throughput(Queue& queue, unsigned threads, size_t operations)
+{
+  vector<thread> workers;
+  auto seconds = timeIt([&]() {
+    for (unsigned t = 0; t < threads; ++t)
+    {
+      workers.emplace_back([&queue, operations, t]() {
+        minstd_rand rand(t + 1);
+        uint64_t value;
+        for (size_t i = 0; i < operations; ++i)
+        {
+          queue.push(rand());
+          queue.try_pop(value);
+        }
+      });
+    }
+    for (auto& w : workers)
+      w.join();
+  });
+
+  return 2.0 * threads * operations / seconds;
+}
+
+/**
+ * Fenwick tree used to count the keys still in the queue below a given key.
+ */
+class Fenwick
+{
+  vector<int64_t> mTree;
+
+public:
+  explicit Fenwick(size_t n) : mTree(n + 1) {}
+
+  void add(size_t i, int64_t delta)
+  {
+    for (++i; i < mTree.size(); i += i & (~i + 1))
+      mTree[i] += delta;
+  }
+
+  int64_t prefix(size_t i) const
+  {
+    int64_t sum = 0;
+    for (; i > 0; i -= i & (~i + 1))
+      sum += mTree[i];
+    return sum;
+  }
+};
+
+/**
+ * @brief Pop every key from a MultiQueue on several threads and compute the
+ *  rank of each popped key among the keys still in the queue.
+ * @details Each pop takes a ticket right after it returns, and the pops are
+ *  replayed in ticket order against a Fenwick tree of the remaining keys.
+ * @param threads The number of threads.
+ */
+void rankError(unsigned threads)
+{
+  ospp::MultiQueue<uint64_t> queue(threads);
+
+  vector<uint64_t> keys(kPrefill);
+  for (size_t i = 0; i < kPrefill; ++i)
+    keys[i] = i;
+  shuffle(keys.begin(), keys.end(), default_random_engine(41));
+  for (auto k : keys)
+    queue.push(k);
+
+  vector<pair<uint64_t, uint64_t>> log(kPrefill);
+  atomic<size_t> ticket(0);
+  vector<thread> workers;
+  for (unsigned t = 0; t < threads; ++t)
+  {
+    workers.emplace_back([&]() {
+      uint64_t value;
+      while (queue.try_pop(value))
+      {
+        auto n = ticket.fetch_add(1);
+        log[n] = make_pair(n, value);
+      }
+    });
+  }
+  for (auto& w : workers)
+    w.join();
+
+  Fenwick present(kPrefill);
+  for (size_t i = 0; i < kPrefill; ++i)
+    present.add(i, 1);
+
+  double sum = 0;
+  int64_t worst = 0;
+  for (const auto& entry : log)
+  {
+    auto rank = present.prefix(entry.second);
+    sum += rank;
+    worst = max(worst, rank);
+    present.add(entry.second, -1);
+  }
+
+  cout << "rank error:  mean: " << sum / kPrefill << "  max: " << worst
+       << "  shards: " << queue.shards() << endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  unsigned threads = argc > 1
+    ? static_cast<unsigned>(strtoul(argv[1], nullptr, 10))
+    : max(1u, thread::hardware_concurrency());
+  size_t operations = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1000000;
+
+  cout << "threads: " << threads << ", operations per thread: "
+       << operations << endl;
+
+  {
+    LockedQueue queue;
+    for (size_t i = 0; i < kPrefill; ++i)
+      queue.push(i * 2654435761u);
+    cout << "locked PriorityQueue ops/s: "
+         << throughput(queue, threads, operations) << endl;
+  }
+
+  {
+    ospp::MultiQueue<uint64_t> queue(threads);
+    for (size_t i = 0; i < kPrefill; ++i)
+      queue.push(i * 2654435761u);
+    cout << "MultiQueue ops/s:           "
+         << throughput(queue, threads, operations) << endl;
+  }
+
+  rankError(threads);
+
+  return EXIT_SUCCESS;
+}
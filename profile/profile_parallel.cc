@@ -0,0 +1,130 @@
+/**
+ * @file profile_parallel.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Measure how building an ospp::PriorityQueue from a range and
+ *  draining it in sorted order scale with the number of threads, from one
+ *  thread up to the number of hardware threads, or up to the number given as
+ *  the first argument. The build with one thread is the sequential bottom-up
+ *  heapify, and the drain with one thread is the in-place heap sort.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "queue/parallel_queue.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+const int kRuns = 3;
+const size_t kItems = 20000000;
+
+/**
+ * @brief Time building a queue from the keys and draining it.
+ * @param buildTimes Gets the time to build the queue.
+ * @param drainTimes Gets the time to drain it.
+ * @return False if the queue was not drained in order.
+ */
+template<size_t Arity>
+bool profileThreads(const vector<int64_t>& keys, size_t threads,
+                    vector<double>& buildTimes, vector<double>& drainTimes)
+{
+  using Queue = ospp::PriorityQueue<int64_t, less<int64_t>,
+                                    allocator<int64_t>, Arity>;
+
+  Queue pq;
+  buildTimes.push_back(timeIt([&]() {
+    pq = ospp::parallel_build<Queue>(keys.begin(), keys.end(), threads);
+  }));
+
+  vector<int64_t> drained;
+  drained.reserve(keys.size());
+  drainTimes.push_back(timeIt([&]() {
+    ospp::parallel_drain_sorted(pq, back_inserter(drained), threads);
+  }));
+
+  return drained.size() == keys.size() &&
+         is_sorted(drained.begin(), drained.end());
+}
+
+/**
+ * @brief Print the times for each number of threads, and the speedup over one
+ *  thread.
+ * @return False if a queue was not drained in order.
+ */
+template<size_t Arity>
+bool profileArity(const vector<int64_t>& keys, size_t maxThreads)
+{
+  double buildBase = 0;
+  double drainBase = 0;
+
+  // powers of two, and then all the hardware threads
+  vector<size_t> counts;
+  for (size_t threads = 1; threads < maxThreads; threads *= 2)
+    counts.push_back(threads);
+  counts.push_back(maxThreads);
+
+  for (auto threads : counts)
+  {
+    vector<double> buildTimes, drainTimes;
+    for (int run = 0; run < kRuns; ++run)
+      if (!profileThreads<Arity>(keys, threads, buildTimes, drainTimes))
+        return false;
+
+    auto build = summarize(buildTimes);
+    auto drain = summarize(drainTimes);
+    if (threads == 1) {
+      buildBase = build.min;
+      drainBase = drain.min;
+    }
+
+    cout << setw(6) << Arity << setw(8) << threads
+         << setw(12) << build.min * 1e3 << setw(9) << buildBase / build.min
+         << setw(12) << drain.min * 1e3 << setw(9) << drainBase / drain.min
+         << endl;
+  }
+
+  return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+  size_t maxThreads = argc > 1 ? strtoul(argv[1], nullptr, 10)
+                               : thread::hardware_concurrency();
+  maxThreads = max<size_t>(1, maxThreads);
+
+  auto randEngine = default_random_engine(41);
+  auto uniDist = uniform_int_distribution<int64_t>(0, 1000000000);
+  vector<int64_t> keys;
+  keys.reserve(kItems);
+  for (size_t i = 0; i < kItems; ++i)
+    keys.push_back(uniDist(randEngine));
+
+  cout << kItems << " items, up to " << maxThreads << " threads, "
+       << kRuns << " runs, best time in ms" << endl;
+  cout << setw(6) << "arity" << setw(8) << "threads"
+       << setw(12) << "build" << setw(9) << "speedup"
+       << setw(12) << "drain" << setw(9) << "speedup" << endl;
+  cout << fixed << setprecision(1);
+
+  if (!profileArity<2>(keys, maxThreads) ||
+      !profileArity<4>(keys, maxThreads)) {
+    cerr << "a queue was drained out of order" << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
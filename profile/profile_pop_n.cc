@@ -0,0 +1,167 @@
+/**
+ * @file profile_pop_n.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Compare ospp::PriorityQueue::pop_n with a loop of top and pop,
+ *  on a dispatcher workload: a heap of a million items gives up its best
+ *  <em>k</em> items every tick, and then gets as many new items, so that its
+ *  size stays the same. Only the time spent popping is measured.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "queue/queue.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+const int kRuns = 3;
+const size_t kItems = 1000000;
+const size_t kTicks = 2000;
+
+/**
+ * Item types, made from a key and compared by it.
+ */
+using Item64 = Payload<64>;
+
+int64_t keyOf(int64_t item) { return item; }
+int64_t keyOf(const Item64& item) { return item.key; }
+int64_t keyOf(const string& item) { return stoll(item); }
+
+template<typename Item>
+Item makeItem(int64_t key) { return Item(key); }
+
+/**
+ * @brief Make a string that sorts like its key: the zero padded digits.
+ */
+template<>
+string makeItem<string>(int64_t key)
+{
+  auto digits = to_string(key);
+  return string(20 - digits.size(), '0') + digits;
+}
+
+/**
+ * @brief Pop the best items with a loop of top and pop.
+ */
+template<typename Queue, typename Item>
+void popLoop(Queue& pq, size_t k, vector<Item>& out)
+{
+  for (size_t i = 0; i < k; ++i)
+  {
+    out.push_back(pq.top());
+    pq.pop();
+  }
+}
+
+/**
+ * @brief Pop the best items with pop_n.
+ */
+template<typename Queue, typename Item>
+void popBatch(Queue& pq, size_t k, vector<Item>& out)
+{
+  pq.pop_n(k, back_inserter(out));
+}
+
+/**
+ * @brief Run the ticks on a fresh heap.
+ * @param pop Pops <em>k</em> items into a vector.
+ * @param k The number of items popped per tick.
+ * @param seed The seed of the random keys.
+ * @param checksum Set to the sum of the keys popped, to compare the methods.
+ * @return The time spent popping per item, in seconds.
+ */
+template<typename Item, typename Pop>
+double runTicks(Pop pop, size_t k, unsigned seed, int64_t& checksum)
+{
+  auto randEngine = default_random_engine(seed);
+  auto uniDist = uniform_int_distribution<int64_t>(0, 1000000000);
+
+  ospp::PriorityQueue<Item> pq;
+  pq.reserve(kItems + k);
+  for (size_t i = 0; i < kItems; ++i)
+    pq.push(makeItem<Item>(uniDist(randEngine)));
+
+  vector<Item> out;
+  out.reserve(k);
+  double time = 0;
+  checksum = 0;
+  for (size_t t = 0; t < kTicks; ++t)
+  {
+    out.clear();
+    time += timeIt([&]() { pop(pq, k, out); });
+
+    // the new items are no better than the ones popped
+    for (auto& item : out)
+    {
+      checksum += keyOf(item);
+      pq.push(makeItem<Item>(keyOf(item) + uniDist(randEngine)));
+    }
+  }
+
+  return time / (kTicks * k);
+}
+
+/**
+ * @brief Time both methods on the same ticks.
+ * @return False if they popped different items.
+ */
+template<typename Item>
+bool profileItem(const string& name)
+{
+  using Queue = ospp::PriorityQueue<Item>;
+
+  for (size_t k = 32; k <= 256; k *= 2)
+  {
+    vector<double> loopTimes, batchTimes;
+    for (int run = 0; run < kRuns; ++run)
+    {
+      int64_t loopSum, batchSum;
+      loopTimes.push_back(runTicks<Item>(popLoop<Queue, Item>, k, 41 + run,
+                                         loopSum));
+      batchTimes.push_back(runTicks<Item>(popBatch<Queue, Item>, k, 41 + run,
+                                          batchSum));
+      if (loopSum != batchSum)
+        return false;
+    }
+
+    auto loop = summarize(loopTimes);
+    auto batch = summarize(batchTimes);
+    cout << setw(12) << name << setw(6) << k
+         << setw(12) << loop.mean * 1e9 << setw(12) << batch.mean * 1e9
+         << setw(10) << loop.mean / batch.mean << endl;
+  }
+
+  return true;
+}
+
+} // anonymous namespace
+
+int main()
+{
+  cout << kItems << " items, " << kTicks << " ticks, " << kRuns
+       << " runs, mean ns per popped item" << endl;
+  cout << setw(12) << "item" << setw(6) << "k"
+       << setw(12) << "top+pop" << setw(12) << "pop_n"
+       << setw(10) << "speedup" << endl;
+  cout << fixed << setprecision(1);
+
+  if (!profileItem<int64_t>("int64") || !profileItem<Item64>("payload64") ||
+      !profileItem<string>("string")) {
+    cerr << "the methods popped different items" << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -2,111 +2,427 @@
  * @file profile_queue.cc
  * @author Omar A Serrano
  * @date 2016-04-03
+ *
+ * @description Benchmark suite for ospp::PriorityQueue against
+ *  std::priority_queue, both ordered so that the smallest item pops first.
+ *  Every combination of item type, size and workload is run several times:
+ *  - items: int, double, string (20 characters, too long for the small string
+ *    buffer) and a 64-byte struct with a 64-bit key;
+ *  - sizes: powers of ten from 1K up to --max-size (default 1M, at most
+ *    100M);
+ *  - workloads: push then pop all random keys, a hold model at steady state
+ *    (pop, then push a random key), monotone keys (pop, then push the popped
+ *    key plus a small increment, as in event simulation), and push then pop
+ *    all of a sorted and of a reverse sorted input.
+ *  The monotone workload on ints also runs ospp::RadixPriorityQueue.
+ *
+ *  Operations are timed in batches of kBatch. The percentiles are those of
+ *  the time per operation of each batch, over all the runs, and ops/sec is
+ *  the number of operations over the total time. The hold and monotone
+ *  queues are filled before the clock starts. With --json, the results are
+ *  printed as one JSON object per line.
  */
 
-#include <queue>
-#include <iostream>
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <queue>
 #include <random>
+#include <string>
 #include <vector>
-#include <algorithm>
-#include <numeric>
 
-#include "queue.hh"
+#include "queue/queue.hh"
+#include "queue/radix_queue.hh"
+#include "profile_util.hh"
 
 using namespace std;
-using namespace chrono;
+using namespace ospp::profile;
 
-using high_resolution_time_point = high_resolution_clock::time_point;
+namespace {
 
-inline double getSeconds
-  (const high_resolution_time_point &t2,
-   const high_resolution_time_point &t1)
+const size_t kBatch = 64;
+const size_t kMinSize = 1000;
+const size_t kMaxSize = 100000000;
+const int64_t kKeyRange = 1 << 24;
+const int64_t kMaxIncrement = 16;
+
+/**
+ * Item types, made from a key and compared by it. The keys fit in an int for
+ * every workload, even the monotone one at the largest size.
+ */
+using Item64 = Payload<64>;
+
+template<typename Item>
+Item makeItem(int64_t key) { return Item(key); }
+
+/**
+ * @brief Make a string that sorts like its key: the zero padded digits.
+ */
+template<>
+string makeItem<string>(int64_t key)
 {
-  return duration_cast<duration<double>>(t2 - t1).count();
+  auto digits = to_string(key);
+  return string(20 - digits.size(), '0') + digits;
 }
 
-int main()
+int64_t keyOf(int item) { return item; }
+int64_t keyOf(double item) { return static_cast<int64_t>(item); }
+int64_t keyOf(const string& item) { return stoll(item); }
+int64_t keyOf(const Item64& item) { return item.key; }
+
+/**
+ * Times the operations of a run in batches.
+ */
+class OpTimer
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+  explicit OpTimer(vector<double>& perOp)
+    : mPerOp(perOp), mOps(0), mInBatch(0), mSeconds(0)
+  {}
+
+  void start() { mInBatch = 0; mStart = mLast = clock::now(); }
+
+  /**
+   * @brief Count an operation, and time the batch when it is full.
+   */
+  void op()
+  {
+    if (++mInBatch == kBatch)
+      flush();
+  }
+
+  void stop()
+  {
+    flush();
+    mSeconds += std::chrono::duration<double>(mLast - mStart).count();
+  }
+
+  size_t ops() const { return mOps; }
+  double seconds() const { return mSeconds; }
+
+private:
+  void flush()
+  {
+    auto now = clock::now();
+    if (mInBatch > 0)
+      mPerOp.push_back(
+        std::chrono::duration<double>(now - mLast).count() / mInBatch);
+    mOps += mInBatch;
+    mInBatch = 0;
+    mLast = now;
+  }
+
+  vector<double>& mPerOp;
+  size_t mOps;
+  size_t mInBatch;
+  double mSeconds;
+  clock::time_point mStart;
+  clock::time_point mLast;
+};
+
+/**
+ * The queues, both popping the smallest item first.
+ */
+template<typename Item>
+using StdQueue = priority_queue<Item, vector<Item>, greater<Item>>;
+
+template<typename Item>
+using OsppQueue = ospp::PriorityQueue<Item>;
+
+/**
+ * @brief Push all the items, then pop them all.
+ * @return The sum of the keys popped, to compare the queues.
+ */
+template<typename Queue, typename Item>
+int64_t pushPopAll(const vector<Item>& items, OpTimer& timer)
+{
+  Queue pq;
+  int64_t sum = 0;
+
+  timer.start();
+  for (auto& item : items)
+  {
+    pq.push(item);
+    timer.op();
+  }
+  while (!pq.empty())
+  {
+    sum += keyOf(pq.top());
+    pq.pop();
+    timer.op();
+  }
+  timer.stop();
+
+  return sum;
+}
+
+/**
+ * @brief Pop the top and push the next item, once per item, on a queue
+ *  filled with the first items.
+ * @param monotone If true, the next item is the popped key plus the next
+ *  item's key, so the keys never go down.
+ * @return The sum of the keys popped, to compare the queues.
+ */
+template<typename Queue, typename Item>
+int64_t hold(const vector<Item>& fill, const vector<Item>& next,
+             bool monotone, OpTimer& timer)
+{
+  Queue pq;
+  for (auto& item : fill)
+    pq.push(item);
+  int64_t sum = 0;
+
+  timer.start();
+  for (auto& item : next)
+  {
+    auto key = keyOf(pq.top());
+    sum += key;
+    pq.pop();
+    timer.op();
+    if (monotone)
+      pq.push(makeItem<Item>(key + keyOf(item)));
+    else
+      pq.push(item);
+    timer.op();
+  }
+  timer.stop();
+
+  return sum;
+}
+
+/**
+ * The inputs of a workload: the items pushed, and for the hold models, the
+ * items the queue starts with.
+ */
+template<typename Item>
+struct Inputs
+{
+  vector<Item> fill;
+  vector<Item> items;
+};
+
+template<typename Item>
+Inputs<Item> makeInputs(const string& workload, size_t size, unsigned seed)
 {
-  int seed = 31;
   auto randEngine = default_random_engine(seed);
-  auto uniDist = uniform_int_distribution<>();
+  auto keyDist = uniform_int_distribution<int64_t>(0, kKeyRange);
+  auto incDist = uniform_int_distribution<int64_t>(1, kMaxIncrement);
+
+  vector<int64_t> keys(size);
+  for (auto& key : keys)
+    key = keyDist(randEngine);
+
+  Inputs<Item> inputs;
+  if (workload == "sorted")
+    sort(keys.begin(), keys.end());
+  else if (workload == "reverse")
+    sort(keys.begin(), keys.end(), greater<int64_t>());
+  else if (workload == "hold" || workload == "monotone") {
+    for (auto key : keys)
+      inputs.fill.push_back(makeItem<Item>(key));
+    for (auto& key : keys)
+      key = workload == "hold" ? keyDist(randEngine) : incDist(randEngine);
+  }
+
+  for (auto key : keys)
+    inputs.items.push_back(makeItem<Item>(key));
+  return inputs;
+}
+
+/**
+ * @brief Run a workload on a queue.
+ * @return The sum of the keys popped.
+ */
+template<typename Queue, typename Item>
+int64_t runWorkload(const string& workload, const Inputs<Item>& inputs,
+                    OpTimer& timer)
+{
+  if (workload == "hold" || workload == "monotone")
+    return hold<Queue>(inputs.fill, inputs.items, workload == "monotone",
+                       timer);
+  return pushPopAll<Queue>(inputs.items, timer);
+}
+
+/**
+ * Options from the command line.
+ */
+struct Options
+{
+  bool json = false;
+  size_t maxSize = 1000000;
+  int runs = 0;
+};
+
+/**
+ * @brief Get the number of runs for a size: enough to time a few million
+ *  operations, at least 3 and at most 100, unless set on the command line.
+ */
+int runsFor(size_t size, const Options& options)
+{
+  if (options.runs > 0)
+    return options.runs;
+  auto runs = static_cast<int>(2000000 / size);
+  return min(100, max(3, runs));
+}
 
-  // get times for STL's priority queue
-  vector<double> stlValues;
-  stlValues.reserve(1000);
+/**
+ * @brief Time a queue on a workload and print the results.
+ * @param checksum The sum of the keys popped, set by the first queue run and
+ *  checked for the others.
+ * @return False if the queue popped other keys than the first one.
+ */
+template<typename Queue, typename Item>
+bool profileQueue(const string& queue, const string& type,
+                  const string& workload, size_t size,
+                  const Options& options, int64_t& checksum)
+{
+  vector<double> perOp;
+  OpTimer timer(perOp);
+  int runs = runsFor(size, options);
 
-  for (int i = 0; i < 1000; ++i)
+  for (int run = 0; run < runs; ++run)
   {
-    priority_queue<int> stlQueue;
-    auto t1 = high_resolution_clock::now();
-    for (int j = 0; j < 50000; ++j)
-    {
-      auto r = uniDist(randEngine);
-      stlQueue.push(r);
-    }
+    auto inputs = makeInputs<Item>(workload, size, 41 + run);
+    auto sum = runWorkload<Queue>(workload, inputs, timer);
+    if (run > 0)
+      continue;
+    if (checksum == 0)
+      checksum = sum;
+    else if (sum != checksum)
+      return false;
+  }
 
-    vector<double> tmpVec;
-    tmpVec.reserve(50000);
-    for (int j = 0; j < 50000; ++j)
-    {
-      tmpVec.push_back(stlQueue.top());
-      stlQueue.pop();
-    }
+  auto opsPerSec = timer.ops() / timer.seconds();
+  auto p50 = percentile(perOp, 50) * 1e9;
+  auto p90 = percentile(perOp, 90) * 1e9;
+  auto p99 = percentile(perOp, 99) * 1e9;
+  auto p999 = percentile(perOp, 99.9) * 1e9;
+  auto maxNs = *max_element(perOp.begin(), perOp.end()) * 1e9;
 
-    auto t2 = high_resolution_clock::now();
-    stlValues.push_back(getSeconds(t2, t1));
+  if (options.json) {
+    cout << "{\"queue\": \"" << queue << "\", \"type\": \"" << type
+         << "\", \"workload\": \"" << workload << "\", \"size\": " << size
+         << ", \"runs\": " << runs << ", \"ops\": " << timer.ops()
+         << ", \"ops_per_sec\": " << opsPerSec
+         << ", \"batch\": " << kBatch
+         << ", \"p50_ns\": " << p50 << ", \"p90_ns\": " << p90
+         << ", \"p99_ns\": " << p99 << ", \"p999_ns\": " << p999
+         << ", \"max_ns\": " << maxNs << "}" << endl;
+  }
+  else {
+    cout << setw(8) << queue << setw(10) << type << setw(10) << workload
+         << setw(11) << size << setw(14) << opsPerSec
+         << setw(9) << p50 << setw(9) << p90 << setw(9) << p99
+         << setw(10) << p999 << endl;
   }
 
-  // re-seed the engine
-  randEngine.seed(seed);
+  return true;
+}
+
+/**
+ * @brief Time the radix queue on monotone keys, for the items it can hold.
+ * @return False if the queue popped other keys than the heaps.
+ */
+template<typename Item>
+bool profileRadix(const string&, size_t, const Options&, int64_t&)
+{
+  return true;
+}
 
-  // get times for my implementation
-  vector<double> osppValues;
-  osppValues.reserve(1000);
+template<>
+bool profileRadix<int>(const string& type, size_t size,
+                       const Options& options, int64_t& checksum)
+{
+  return profileQueue<ospp::RadixPriorityQueue<int>, int>(
+    "radix", type, "monotone", size, options, checksum);
+}
 
-  for (int i = 0; i < 1000; ++i)
+/**
+ * @brief Run every workload and size on both queues for an item type.
+ * @return False if the queues popped different keys.
+ */
+template<typename Item>
+bool profileType(const string& type, const Options& options)
+{
+  for (auto workload : {"push_pop", "hold", "monotone", "sorted", "reverse"})
   {
-    priority_queue<int> osppQueue;
-    auto t1 = high_resolution_clock::now();
-    for (int j = 0; j < 50000; ++j)
+    for (size_t size = kMinSize; size <= options.maxSize; size *= 10)
     {
-      auto r = uniDist(randEngine);
-      osppQueue.push(r);
+      int64_t checksum = 0;
+      if (!profileQueue<StdQueue<Item>, Item>("std", type, workload, size,
+                                              options, checksum) ||
+          !profileQueue<OsppQueue<Item>, Item>("ospp", type, workload, size,
+                                               options, checksum))
+        return false;
+
+      if (string(workload) == "monotone" &&
+          !profileRadix<Item>(type, size, options, checksum))
+        return false;
     }
+  }
 
-    vector<double> tmpVec;
-    tmpVec.reserve(50000);
-    for (int j = 0; j < 50000; ++j)
-    {
-      tmpVec.push_back(osppQueue.top());
-      osppQueue.pop();
+  return true;
+}
+
+void usage(const char *name)
+{
+  cerr << "usage: " << name << " [--json] [--max-size N] [--runs N]" << endl
+       << "  --json        print one JSON object per line" << endl
+       << "  --max-size N  largest queue, a power of ten from 1000 to "
+       << kMaxSize << " (default 1000000)" << endl
+       << "  --runs N      runs per result (default: 3 to 100 by size)"
+       << endl
+       << "The 64-byte items of a hold model take about 20 GB at 100M."
+       << endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!strcmp(argv[i], "--json"))
+      options.json = true;
+    else if (!strcmp(argv[i], "--max-size") && i + 1 < argc)
+      options.maxSize = strtoull(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--runs") && i + 1 < argc)
+      options.runs = atoi(argv[++i]);
+    else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
     }
+  }
 
-    auto t2 = high_resolution_clock::now();
-    osppValues.push_back(getSeconds(t2, t1));
+  if (options.maxSize < kMinSize || options.maxSize > kMaxSize) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
   }
 
-  // compute min, max, and mean for STL
-  auto stlMinMax = minmax_element(stlValues.begin(), stlValues.end());
-  auto stlMean = accumulate(stlValues.begin(), stlValues.end(), 0.0) / stlValues.size();
-
-  // compute min, max, and mean for OSPP
-  auto osppMinMax = minmax_element(osppValues.begin(), osppValues.end());
-  auto osppMean =
-    accumulate(osppValues.begin(), osppValues.end(), 0.0) / osppValues.size();
-
-  // output for STL
-  cout << "--------- STL" << endl;
-  cout << "min:  " << (*stlMinMax.first) << endl;
-  cout << "max:  " << (*stlMinMax.second) << endl;
-  cout << "mean: " << stlMean << endl;
-
-  // output for OSPP
-  cout << "--------- OSPP" << endl;
-  cout << "min:  " << (*osppMinMax.first) << endl;
-  cout << "max:  " << (*osppMinMax.second) << endl;
-  cout << "mean: " << osppMean << endl;
+  if (!options.json) {
+    cout << "ns per operation, timed in batches of " << kBatch << endl;
+    cout << setw(8) << "queue" << setw(10) << "type" << setw(10) << "workload"
+         << setw(11) << "size" << setw(14) << "ops/sec"
+         << setw(9) << "p50" << setw(9) << "p90" << setw(9) << "p99"
+         << setw(10) << "p99.9" << endl;
+    cout << fixed << setprecision(1);
+  }
+
+  if (!profileType<int>("int", options) ||
+      !profileType<double>("double", options) ||
+      !profileType<string>("string", options) ||
+      !profileType<Item64>("payload64", options)) {
+    cerr << "the queues popped different keys" << endl;
+    return EXIT_FAILURE;
+  }
 
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,148 @@
+/**
+ * @file profile_ring_queue.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Measure the throughput of ospp::RingQueue against a std::deque
+ *  behind a mutex, for one-to-one, many-to-one and many-to-many hand-offs.
+ *
+ *  usage: profile_ring_queue [producers] [consumers] [items per producer]
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "queue/ring_queue.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+const size_t kCapacity = 1024;
+
+/**
+ * A std::deque behind a single lock, bounded like the ring.
+ */
+class LockedDeque
+{
+  mutex mLock;
+  deque<uint64_t> mQueue;
+
+public:
+  void push(uint64_t value)
+  {
+    for (;;)
+    {
+      {
+        lock_guard<mutex> guard(mLock);
+        if (mQueue.size() < kCapacity)
+        {
+          mQueue.push_back(value);
+          return;
+        }
+      }
+      this_thread::yield();
+    }
+  }
+
+  void pop(uint64_t& value)
+  {
+    for (;;)
+    {
+      {
+        lock_guard<mutex> guard(mLock);
+        if (!mQueue.empty())
+        {
+          value = mQueue.front();
+          mQueue.pop_front();
+          return;
+        }
+      }
+      this_thread::yield();
+    }
+  }
+};
+
+/**
+ * @brief Move items from producers to consumers through a queue.
+ * @param producers The number of producer threads.
+ * @param consumers The number of consumer threads. Must divide the total.
+ * @param items The number of items per producer.
+ * @return The number of items per second.
+ */
+template<typename Queue>
+double handOff(Queue& queue, unsigned producers, unsigned consumers,
+               size_t items)
+{
+  auto total = producers * items;
+  vector<thread> workers;
+
+  auto seconds = timeIt([&]() {
+    for (unsigned p = 0; p < producers; ++p)
+    {
+      workers.emplace_back([&queue, items]() {
+        for (size_t i = 0; i < items; ++i)
+          queue.push(i);
+      });
+    }
+    for (unsigned c = 0; c < consumers; ++c)
+    {
+      workers.emplace_back([&queue, total, consumers]() {
+        uint64_t value;
+        for (size_t i = 0; i < total / consumers; ++i)
+          queue.pop(value);
+      });
+    }
+    for (auto& w : workers)
+      w.join();
+  });
+
+  return total / seconds;
+}
+
+/**
+ * @brief Profile a ring kind against the locked deque.
+ * @param name The name of the ring kind.
+ */
+template<ospp::RingKind Kind>
+void profileKind(const string& name, unsigned producers, unsigned consumers,
+                 size_t items)
+{
+  LockedDeque locked;
+  ospp::RingQueue<uint64_t, Kind> ring(kCapacity);
+
+  cout << "--------- " << name << " (" << producers << " -> " << consumers
+       << ")" << endl;
+  cout << "mutex deque items/s: "
+       << handOff(locked, producers, consumers, items) << endl;
+  cout << "ring items/s:        "
+       << handOff(ring, producers, consumers, items) << endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  unsigned producers = argc > 1
+    ? static_cast<unsigned>(strtoul(argv[1], nullptr, 10)) : 4;
+  unsigned consumers = argc > 2
+    ? static_cast<unsigned>(strtoul(argv[2], nullptr, 10)) : 4;
+  size_t items = argc > 3 ? strtoul(argv[3], nullptr, 10) : 1000000;
+
+  // keep the total divisible by the number of consumers
+  items -= items % consumers;
+
+  profileKind<ospp::RingKind::SPSC>("SPSC", 1, 1, items);
+  profileKind<ospp::RingKind::MPSC>("MPSC", producers, 1, items);
+  profileKind<ospp::RingKind::MPMC>("MPMC", producers, consumers, items);
+
+  return EXIT_SUCCESS;
+}
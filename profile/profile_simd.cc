@@ -0,0 +1,108 @@
+/**
+ * @file profile_simd.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Compare the push-all/pop-all time of ospp::PriorityQueue with
+ *  AVX2 child selection against scalar child selection and against the
+ *  scalar binary heap, for int and float keys.
+ */
+
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "queue/queue.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+const int kRuns = 10;
+
+/**
+ * Same order as std::less, but not recognized by the SIMD child selection,
+ * so the queue compares children one by one.
+ */
+template<typename T>
+struct ScalarLess
+{
+  bool operator()(const T& a, const T& b) const { return a < b; }
+};
+
+/**
+ * @brief Push all the keys into a queue, then pop all of them.
+ * @param keys The keys pushed into the queue.
+ * @return The summary of the times.
+ */
+template<typename T, typename Compare, size_t Arity>
+Summary profileQueue(const vector<T>& keys)
+{
+  vector<double> times;
+  times.reserve(kRuns);
+
+  for (int i = 0; i < kRuns; ++i)
+  {
+    ospp::PriorityQueue<T, Compare, allocator<T>, Arity> pq(keys.size());
+    times.push_back(timeIt([&]() {
+      for (auto k : keys)
+        pq.push(k);
+      while (!pq.empty())
+        pq.pop();
+    }));
+  }
+
+  return summarize(times);
+}
+
+/**
+ * @brief Profile one key type.
+ * @param name The name of the key type.
+ * @param keys The keys pushed into the queue.
+ */
+template<typename T>
+void profileType(const string& name, const vector<T>& keys)
+{
+  cout << "--------- " << name << endl;
+  cout << "binary heap, scalar: "
+       << profileQueue<T, ScalarLess<T>, 2>(keys) << endl;
+  cout << "arity 8, scalar:     "
+       << profileQueue<T, ScalarLess<T>, 8>(keys) << endl;
+  cout << "arity 8, simd:       "
+       << profileQueue<T, less<T>, 8>(keys) << endl;
+  cout << "arity 16, scalar:    "
+       << profileQueue<T, ScalarLess<T>, 16>(keys) << endl;
+  cout << "arity 16, simd:      "
+       << profileQueue<T, less<T>, 16>(keys) << endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+
+  auto randEngine = default_random_engine(37);
+  auto uniDist = uniform_int_distribution<int>();
+  vector<int> ikeys;
+  vector<float> fkeys;
+  ikeys.reserve(count);
+  fkeys.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    ikeys.push_back(uniDist(randEngine));
+    fkeys.push_back(static_cast<float>(ikeys.back()));
+  }
+
+  cout << "elements: " << count << ", runs: " << kRuns
+       << ", avx2: " << (ospp::detail::hasAvx2() ? "yes" : "no") << endl;
+  profileType<int>("int", ikeys);
+  profileType<float>("float", fkeys);
+
+  return EXIT_SUCCESS;
+}
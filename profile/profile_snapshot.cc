@@ -0,0 +1,132 @@
+/**
+ * @file profile_snapshot.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Compare three ways to restore a queue after a restart: pushing
+ *  every item again, loading a snapshot into a queue with the default
+ *  allocator, which reads the file, and loading it into a queue with an
+ *  ospp::MmapAllocator, which maps the file. The snapshot is in the page
+ *  cache, as it is right after it was saved. The time to restore and then pop
+ *  a thousand items is measured.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "queue/mmap_allocator.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+const int kRuns = 3;
+const size_t kPops = 1000;
+
+using Queue = ospp::PriorityQueue<int64_t>;
+using MappedQueue = ospp::PriorityQueue<int64_t, less<int64_t>,
+                                        ospp::MmapAllocator<int64_t>>;
+
+/**
+ * @brief Pop the first items of a restored queue.
+ * @return The sum of the items, to compare the methods.
+ */
+template<typename Q>
+int64_t popSome(Q& pq)
+{
+  int64_t sum = 0;
+  for (size_t i = 0; i < kPops && !pq.empty(); ++i)
+  {
+    sum += pq.top();
+    pq.pop();
+  }
+  return sum;
+}
+
+/**
+ * @brief Time restoring a queue and popping from it.
+ * @param restore Fills the queue.
+ * @param checksum Set to the sum of the items popped.
+ * @return The summary of the times, in seconds.
+ */
+template<typename Q>
+Summary profileRestore(function<void(Q&)> restore, int64_t& checksum)
+{
+  vector<double> times;
+  for (int run = 0; run < kRuns; ++run)
+  {
+    times.push_back(timeIt([&]() {
+      Q pq;
+      restore(pq);
+      checksum = popSome(pq);
+    }));
+  }
+  return summarize(times);
+}
+
+} // anonymous namespace
+
+int main()
+{
+  // a file of our own, so that concurrent runs never share a snapshot
+  char path[] = "/tmp/ospp-profile-XXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0) {
+    perror("mkstemp");
+    return EXIT_FAILURE;
+  }
+  close(fd);
+  const string kPath = path;
+
+  cout << kRuns << " runs, best ms to restore and pop " << kPops << " items"
+       << endl;
+  cout << setw(10) << "items" << setw(12) << "push" << setw(12) << "read"
+       << setw(12) << "map" << endl;
+  cout << fixed << setprecision(2);
+
+  auto randEngine = default_random_engine(41);
+  auto uniDist = uniform_int_distribution<int64_t>(0, 1000000000);
+
+  for (size_t items = 100000; items <= 10000000; items *= 10)
+  {
+    vector<int64_t> keys;
+    for (size_t i = 0; i < items; ++i)
+      keys.push_back(uniDist(randEngine));
+    Queue(keys.begin(), keys.end()).save(kPath);
+
+    int64_t pushSum, readSum, mapSum;
+    auto push = profileRestore<Queue>([&](Queue& pq) {
+      for (auto key : keys)
+        pq.push(key);
+    }, pushSum);
+    auto read = profileRestore<Queue>([&](Queue& pq) {
+      pq.load(kPath);
+    }, readSum);
+    auto map = profileRestore<MappedQueue>([&](MappedQueue& pq) {
+      pq.load(kPath);
+    }, mapSum);
+
+    if (pushSum != readSum || pushSum != mapSum) {
+      cerr << "the restored queues popped different items" << endl;
+      remove(kPath.c_str());
+      return EXIT_FAILURE;
+    }
+
+    cout << setw(10) << items << setw(12) << push.min * 1e3
+         << setw(12) << read.min * 1e3 << setw(12) << map.min * 1e3 << endl;
+  }
+
+  remove(kPath.c_str());
+  return EXIT_SUCCESS;
+}
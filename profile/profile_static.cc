@@ -0,0 +1,104 @@
+/**
+ * @file profile_static.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Compare small, short-lived queues: each round builds a queue,
+ *  pushes a handful of keys, and pops them all. std::priority_queue and
+ *  ospp::PriorityQueue allocate a buffer every round, while the small-buffer
+ *  mode and ospp::StaticPriorityQueue keep the items inline.
+ */
+
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "queue/inline_allocator.hh"
+#include "queue/queue.hh"
+#include "queue/static_queue.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+const int kRuns = 5;
+const size_t kCapacity = 64;
+
+using StdQueue = priority_queue<int, vector<int>, greater<int>>;
+using HeapQueue = ospp::PriorityQueue<int>;
+using SmallQueue =
+  ospp::PriorityQueue<int, less<int>, ospp::InlineAllocator<int, kCapacity>>;
+using StaticQueue = ospp::StaticPriorityQueue<int, kCapacity>;
+
+/**
+ * @brief Build a queue per round, push <em>size</em> keys and pop them all.
+ * @param keys The keys, used <em>size</em> at a time.
+ * @param size The number of keys per round.
+ * @return The mean time per key, in nanoseconds.
+ */
+template<typename Queue>
+double profileRounds(const vector<int>& keys, size_t size)
+{
+  vector<double> times;
+  times.reserve(kRuns);
+  long long sink = 0;
+
+  for (int i = 0; i < kRuns; ++i)
+  {
+    times.push_back(timeIt([&]() {
+      for (size_t first = 0; first + size <= keys.size(); first += size)
+      {
+        Queue pq;
+        for (size_t k = first; k < first + size; ++k)
+          pq.push(keys[k]);
+        while (!pq.empty()) {
+          sink += pq.top();
+          pq.pop();
+        }
+      }
+    }));
+  }
+
+  if (sink == 42)
+    cout << "";
+
+  return summarize(times).mean * 1e9 / (keys.size() / size * size);
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10000000;
+
+  auto randEngine = default_random_engine(41);
+  auto uniDist = uniform_int_distribution<int>();
+  vector<int> keys;
+  keys.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    keys.push_back(uniDist(randEngine));
+
+  cout << "keys: " << count << ", runs: " << kRuns
+       << ", mean ns per key pushed and popped" << endl;
+  cout << setw(6) << "size" << setw(16) << "std::pq" << setw(16)
+       << "PriorityQueue" << setw(16) << "small buffer" << setw(16)
+       << "static" << endl;
+  cout << fixed << setprecision(1);
+
+  for (size_t size : {4, 16, 32, 64})
+  {
+    cout << setw(6) << size
+         << setw(16) << profileRounds<StdQueue>(keys, size)
+         << setw(16) << profileRounds<HeapQueue>(keys, size)
+         << setw(16) << profileRounds<SmallQueue>(keys, size)
+         << setw(16) << profileRounds<StaticQueue>(keys, size) << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
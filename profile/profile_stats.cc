@@ -0,0 +1,95 @@
+/**
+ * @file profile_stats.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Dump the work counted by ospp::CountingStats for a queue of a
+ *  million integers, for each arity and pop policy: first while the keys are
+ *  pushed, then while the queue is popped empty. Prints one JSON object per
+ *  queue and phase, one per line, so the output can be fed to other tools.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "queue/queue.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+const size_t kItems = 1000000;
+
+/**
+ * @brief Push the keys, then pop them all, printing the counters of each phase.
+ * @param name The name of the queue in the output.
+ * @param keys The keys to push.
+ * @return False if the queue did not pop the keys in order.
+ */
+template<size_t Arity, typename Pop>
+bool profileQueue(const string& name, const vector<int64_t>& keys)
+{
+  using Queue = ospp::PriorityQueue<int64_t, less<int64_t>,
+                                    allocator<int64_t>, Arity,
+                                    ospp::DoublingGrowth, Pop,
+                                    ospp::FlatLayout, ospp::CountingStats>;
+
+  Queue pq;
+  double pushTime = timeIt([&]() {
+    for (auto key : keys)
+      pq.push(key);
+  });
+  cout << "{\"queue\": \"" << name << "\", \"phase\": \"push\", \"items\": "
+       << keys.size() << ", \"seconds\": " << pushTime
+       << ", \"stats\": " << pq.stats().snapshot() << "}" << endl;
+
+  pq.stats().reset();
+  bool ordered = true;
+  double popTime = timeIt([&]() {
+    auto last = pq.top();
+    while (!pq.empty())
+    {
+      ordered = ordered && !(pq.top() < last);
+      last = pq.top();
+      pq.pop();
+    }
+  });
+  cout << "{\"queue\": \"" << name << "\", \"phase\": \"pop\", \"items\": "
+       << keys.size() << ", \"seconds\": " << popTime
+       << ", \"stats\": " << pq.stats().snapshot() << "}" << endl;
+
+  return ordered;
+}
+
+} // anonymous namespace
+
+int main()
+{
+  auto randEngine = default_random_engine(41);
+  auto uniDist = uniform_int_distribution<int64_t>(0, 1000000000);
+  vector<int64_t> keys;
+  for (size_t i = 0; i < kItems; ++i)
+    keys.push_back(uniDist(randEngine));
+
+  bool ordered =
+    profileQueue<2, ospp::TopDownPop>("arity2-topdown", keys) &&
+    profileQueue<2, ospp::BottomUpPop>("arity2-bottomup", keys) &&
+    profileQueue<4, ospp::TopDownPop>("arity4-topdown", keys) &&
+    profileQueue<4, ospp::BottomUpPop>("arity4-bottomup", keys) &&
+    profileQueue<8, ospp::TopDownPop>("arity8-topdown", keys) &&
+    profileQueue<8, ospp::BottomUpPop>("arity8-bottomup", keys);
+
+  if (!ordered) {
+    cerr << "a queue popped its keys out of order" << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,212 @@
+/**
+ * @file profile_timer_wheel.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Compare ospp::TimerWheel with an ospp::PriorityQueue of
+ *  deadlines with lazy cancellation, on a timer workload: every tick schedules
+ *  a batch of timers a bounded time ahead, cancels most of the timers
+ *  scheduled a while ago, and expires the timers that are due. The heap marks
+ *  a cancelled timer and drops it when it reaches the top.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "queue/queue.hh"
+#include "queue/timer_wheel.hh"
+#include "profile_util.hh"
+
+using namespace std;
+using namespace ospp::profile;
+
+namespace {
+
+const int kRuns = 3;
+const uint64_t kTicks = 20000;
+const size_t kPerTick = 100;
+const double kCancelled = 0.9;
+
+/**
+ * The timers of a run, generated up front so both queues see the same ones.
+ */
+struct Workload
+{
+  uint64_t horizon;
+  uint64_t lag;
+  vector<uint64_t> deadlines;
+  vector<char> cancels;
+};
+
+Workload makeWorkload(uint64_t horizon, unsigned seed)
+{
+  auto randEngine = default_random_engine(seed);
+  auto ahead = uniform_int_distribution<uint64_t>(1, horizon);
+  auto cancel = bernoulli_distribution(kCancelled);
+
+  Workload load{horizon, horizon / 4, {}, {}};
+  for (uint64_t t = 0; t < kTicks; ++t)
+  {
+    for (size_t i = 0; i < kPerTick; ++i)
+    {
+      load.deadlines.push_back(t + ahead(randEngine));
+      load.cancels.push_back(cancel(randEngine));
+    }
+  }
+
+  return load;
+}
+
+/**
+ * @brief Run a workload on a queue.
+ * @details <em>Timers</em> wraps the queue with <em>schedule</em>,
+ *  <em>cancel</em> and <em>advance</em>. At each tick, the timers scheduled
+ *  <em>lag</em> ticks before are cancelled if their cancel flag is set.
+ * @return The number of timers that expired.
+ */
+template<typename Timers>
+size_t runWorkload(const Workload& load)
+{
+  Timers timers(load.deadlines.size());
+  size_t expired = 0;
+
+  for (uint64_t t = 0; t < kTicks; ++t)
+  {
+    auto first = t * kPerTick;
+    for (size_t i = first; i < first + kPerTick; ++i)
+      timers.schedule(load.deadlines[i], i);
+
+    if (t >= load.lag)
+    {
+      auto old = (t - load.lag) * kPerTick;
+      for (size_t i = old; i < old + kPerTick; ++i)
+        if (load.cancels[i])
+          timers.cancel(i);
+    }
+
+    expired += timers.advance(t);
+  }
+
+  return expired;
+}
+
+/**
+ * The timer wheel, with the handle of each timer by id.
+ */
+struct WheelTimers
+{
+  ospp::TimerWheel<size_t> wheel;
+  vector<uint64_t> handles;
+
+  explicit WheelTimers(size_t count)
+    : handles(count)
+  {}
+
+  void schedule(uint64_t deadline, size_t id)
+  {
+    handles[id] = wheel.schedule(deadline, id);
+  }
+
+  void cancel(size_t id)
+  {
+    wheel.cancel(handles[id]);
+  }
+
+  size_t advance(uint64_t now)
+  {
+    return wheel.advance(now, [](size_t) {});
+  }
+};
+
+/**
+ * A heap of deadlines, with a cancelled flag for each timer by id.
+ */
+struct HeapTimers
+{
+  using Timer = pair<uint64_t, size_t>;
+
+  ospp::PriorityQueue<Timer> heap;
+  vector<char> cancelled;
+
+  explicit HeapTimers(size_t count)
+    : cancelled(count)
+  {}
+
+  void schedule(uint64_t deadline, size_t id)
+  {
+    heap.push(Timer(deadline, id));
+  }
+
+  void cancel(size_t id)
+  {
+    cancelled[id] = 1;
+  }
+
+  size_t advance(uint64_t now)
+  {
+    size_t expired = 0;
+    while (!heap.empty() && heap.top().first <= now)
+    {
+      expired += !cancelled[heap.top().second];
+      heap.pop();
+    }
+    return expired;
+  }
+};
+
+/**
+ * @brief Time a queue on the workloads of all the runs.
+ * @return The summary of the times per timer, in seconds.
+ */
+template<typename Timers>
+Summary profileTimers(const vector<Workload>& loads, size_t& expired)
+{
+  vector<double> times;
+  for (auto& load : loads)
+  {
+    times.push_back(timeIt([&]() {
+      expired = runWorkload<Timers>(load);
+    }) / load.deadlines.size());
+  }
+
+  return summarize(times);
+}
+
+} // anonymous namespace
+
+int main()
+{
+  cout << kTicks << " ticks, " << kPerTick << " timers per tick, "
+       << kCancelled * 100 << "% cancelled at a quarter of the horizon, "
+       << kRuns << " runs, mean ns per timer" << endl;
+  cout << setw(10) << "horizon" << setw(12) << "expired"
+       << setw(12) << "heap" << setw(12) << "wheel" << endl;
+  cout << fixed << setprecision(1);
+
+  for (uint64_t horizon = 64; horizon <= 32768; horizon *= 8)
+  {
+    vector<Workload> loads;
+    for (int i = 0; i < kRuns; ++i)
+      loads.push_back(makeWorkload(horizon, 41 + i));
+
+    size_t heapExpired = 0;
+    size_t wheelExpired = 0;
+    auto heap = profileTimers<HeapTimers>(loads, heapExpired);
+    auto wheel = profileTimers<WheelTimers>(loads, wheelExpired);
+    if (heapExpired != wheelExpired) {
+      cerr << "the queues expired different timers" << endl;
+      return EXIT_FAILURE;
+    }
+
+    cout << setw(10) << horizon << setw(12) << wheelExpired
+         << setw(12) << heap.mean * 1e9 << setw(12) << wheel.mean * 1e9
+         << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file profile_util.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ *
+ * @description Small helpers shared by the profiling programs: a wall clock
+ *  timer, summary statistics of repeated runs, and sample payload types.
+ */
+#ifndef _PROFILE_UTIL_H
+#define _PROFILE_UTIL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <ostream>
+#include <vector>
+
+namespace ospp {
+namespace profile {
+
+using high_resolution_time_point =
+  std::chrono::high_resolution_clock::time_point;
+
+/**
+ * @brief Get the number of seconds between two time points.
+ * @param t2 The later time point.
+ * @param t1 The earlier time point.
+ * @return The elapsed time in seconds.
+ */
+inline double getSeconds
+  (const high_resolution_time_point &t2,
+   const high_resolution_time_point &t1)
+{
+  using namespace std::chrono;
+  return duration_cast<duration<double>>(t2 - t1).count();
+}
+
+/**
+ * @brief Time a callable.
+ * @param fun The callable to time.
+ * @return The number of seconds it took to run <em>fun</em>.
+ */
+template<typename Fun>
+inline double timeIt(Fun&& fun)
+{
+  auto t1 = std::chrono::high_resolution_clock::now();
+  fun();
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return getSeconds(t2, t1);
+}
+
+/**
+ * Summary of the times of repeated runs, in seconds.
+ */
+struct Summary
+{
+  double min;
+  double max;
+  double mean;
+};
+
+/**
+ * @brief Summarize the times of repeated runs.
+ * @param values The times, in seconds. Must not be empty.
+ * @return The min, max, and mean of the values.
+ */
+inline Summary summarize(const std::vector<double>& values)
+{
+  auto minMax = std::minmax_element(values.begin(), values.end());
+  auto mean =
+    std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+  return Summary{*minMax.first, *minMax.second, mean};
+}
+
+/**
+ * @brief Get a percentile of some values, by the nearest rank.
+ * @param values The values, which get partially reordered. Must not be empty.
+ * @param p The percentile, from 0 to 100.
+ * @return The value at that rank among the sorted values.
+ */
+inline double percentile(std::vector<double>& values, double p)
+{
+  auto rank = static_cast<std::size_t>(p / 100 * (values.size() - 1) + 0.5);
+  std::nth_element(values.begin(), values.begin() + rank, values.end());
+  return values[rank];
+}
+
+/**
+ * @brief Output operator.
+ */
+inline std::ostream& operator<<(std::ostream& os, const Summary& s)
+{
+  return os << "min: " << s.min << "  max: " << s.max << "  mean: " << s.mean;
+}
+
+/**
+ * A payload with a 64-bit key followed by padding, so that the size of the
+ * struct is <em>Bytes</em>. Only the key takes part in comparisons.
+ */
+template<std::size_t Bytes>
+struct Payload
+{
+  static_assert(Bytes >= sizeof(std::int64_t), "payload too small");
+
+  std::int64_t key;
+  char pad[Bytes - sizeof(std::int64_t)];
+
+  Payload() noexcept : key(), pad() {}
+  explicit Payload(std::int64_t k) noexcept : key(k), pad() {}
+
+  bool operator<(const Payload& other) const noexcept
+  { return key < other.key; }
+  bool operator>(const Payload& other) const noexcept
+  { return key > other.key; }
+  bool operator==(const Payload& other) const noexcept
+  { return key == other.key; }
+  bool operator!=(const Payload& other) const noexcept
+  { return key != other.key; }
+};
+
+} // namespace profile
+} // namespace ospp
+
+#endif /* _PROFILE_UTIL_H */
@@ -0,0 +1,715 @@
+/**
+ * @file addressable_queue.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _ADDRESSABLE_QUEUE_H
+#define _ADDRESSABLE_QUEUE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+#include "queue/slot_table.hh"
+
+namespace ospp {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * AddressablePriorityQueue.
+ * @details A priority queue where every pushed item gets a handle that stays
+ *  valid until the item is popped or erased. The handle can be used to read the
+ *  item, change its priority, or erase it, in logarithmic time.
+ *
+ *  The items live in a <em>SlotTable</em> indexed by handle, and the heap is
+ *  a d-ary heap of handles. Sifting only moves handles and keeps the position
+ *  of each slot in the heap up to date, and the slot table grows without
+ *  moving its items, so items are never moved once pushed. A reference to an
+ *  item stays valid until the item is popped or erased, across other pushes.
+ *
+ *  Handles of popped or erased items are reused by later pushes.
+ */
+template
+<
+  typename T,
+  typename Compare = std::less<T>,
+  typename Alloc = std::allocator<T>,
+  std::size_t Arity = 2
+>
+class AddressablePriorityQueue
+{
+  static_assert(Arity >= 2, "the arity of the heap must be at least 2");
+
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using allocator_type = Alloc;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+  using compare_type = Compare;
+  using handle_type = std::size_t;
+
+  /**
+   * The number of children of each node in the heap.
+   */
+  static constexpr size_type arity = Arity;
+
+  /**
+   * Initialize
+   */
+  explicit AddressablePriorityQueue();
+  explicit AddressablePriorityQueue(const compare_type& comp);
+  explicit AddressablePriorityQueue(const allocator_type& alloc);
+
+  /**
+   * priority queue functionality
+   */
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  const_reference top() const noexcept;
+  handle_type top_handle() const noexcept;
+  handle_type push(const value_type& value);
+  handle_type push(value_type&& value);
+  template<typename... Args>
+  handle_type emplace(Args&&... args);
+  void pop();
+  value_type pop_value();
+  void reserve(size_type size);
+  void clear() noexcept;
+
+  /**
+   * handle functionality
+   */
+  bool contains(handle_type handle) const noexcept;
+  const_reference get(handle_type handle) const noexcept;
+  void update(handle_type handle, const value_type& value);
+  void update(handle_type handle, value_type&& value);
+  void update(handle_type handle) noexcept;
+  void decrease_key(handle_type handle, const value_type& value);
+  void decrease_key(handle_type handle, value_type&& value);
+  void increase_key(handle_type handle, const value_type& value);
+  void increase_key(handle_type handle, value_type&& value);
+  void erase(handle_type handle);
+
+private:
+  /**
+   * An item with its position in the heap. The position is <em>npos</em> if
+   * the slot is free.
+   */
+  struct Slot
+  {
+    value_type value;
+    size_type pos;
+
+    template<typename... Args>
+    Slot(size_type p, Args&&... args)
+      : value(std::forward<Args>(args)...), pos(p) {}
+  };
+
+  using alloc_traits = std::allocator_traits<Alloc>;
+  using slot_alloc = typename alloc_traits::template rebind_alloc<Slot>;
+  using handle_alloc =
+    typename alloc_traits::template rebind_alloc<handle_type>;
+
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+  /**
+   * indexing functions
+   */
+  size_type parent(size_type index) const noexcept;
+  size_type firstChild(size_type index) const noexcept;
+
+  /**
+   * movement functions
+   */
+  bool before(handle_type a, handle_type b) const;
+  void place(size_type pos, handle_type handle) noexcept;
+  void bubbleUp(size_type pos);
+  void bubbleDown(size_type pos);
+  void resift(size_type pos);
+  void removeAt(size_type pos);
+
+  /**
+   * memory functions
+   */
+  template<typename Vector>
+  static void makeRoom(Vector& vec, size_type size);
+
+  /**
+   * The slot table, indexed by handle.
+   */
+  SlotTable<Slot, slot_alloc> mSlots;
+
+  /**
+   * The heap of handles.
+   */
+  std::vector<handle_type, handle_alloc> mHeap;
+
+  /**
+   * Handles of free slots.
+   */
+  std::vector<handle_type, handle_alloc> mFree;
+
+  /**
+   * The comparator.
+   */
+  compare_type mCompare;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+constexpr
+typename AddressablePriorityQueue<T, Compare, Alloc, Arity>::size_type
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::arity;
+
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+constexpr
+typename AddressablePriorityQueue<T, Compare, Alloc, Arity>::size_type
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::npos;
+
+/**
+ * @brief Default ctor.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+AddressablePriorityQueue()
+  : mSlots(),
+    mHeap(),
+    mFree(),
+    mCompare()
+{}
+
+/**
+ * @brief Constructor with one parameter.
+ * @param comp The object used to compare items.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+AddressablePriorityQueue(const compare_type& comp)
+  : mSlots(),
+    mHeap(),
+    mFree(),
+    mCompare(comp)
+{}
+
+/**
+ * @brief Constructor with one parameter.
+ * @param alloc The allocator for the queue.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+AddressablePriorityQueue(const allocator_type& alloc)
+  : mSlots(slot_alloc(alloc)),
+    mHeap(handle_alloc(alloc)),
+    mFree(handle_alloc(alloc)),
+    mCompare()
+{}
+
+/**
+ * @brief Determine if the queue is empty.
+ * @return True if the queue is empty, false otherwise.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline bool AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+empty() const noexcept
+{
+  return mHeap.empty();
+}
+
+/**
+ * @brief Get the size of the queue.
+ * @return The number of live items in the queue.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline typename AddressablePriorityQueue<T, Compare, Alloc, Arity>::size_type
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+size() const noexcept
+{
+  return mHeap.size();
+}
+
+/**
+ * @brief Get the top value.
+ * @return A reference to the top value. The queue must not be empty. The
+ *  reference stays valid until the item is popped or erased.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline
+typename AddressablePriorityQueue<T, Compare, Alloc, Arity>::const_reference
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+top() const noexcept
+{
+  assert(!mHeap.empty());
+  return mSlots[mHeap[0]].value;
+}
+
+/**
+ * @brief Get the handle of the top value.
+ * @return The handle of the top value. The queue must not be empty.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline typename AddressablePriorityQueue<T, Compare, Alloc, Arity>::handle_type
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+top_handle() const noexcept
+{
+  assert(!mHeap.empty());
+  return mHeap[0];
+}
+
+/**
+ * @brief Push an item into the queue by copying the value.
+ * @param value The value copied and pushed into the queue.
+ * @return The handle of the item.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline typename AddressablePriorityQueue<T, Compare, Alloc, Arity>::handle_type
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+push(const value_type& value)
+{
+  return emplace(value);
+}
+
+/**
+ * @brief Push an item into the queue by moving it.
+ * @param value The value moved into the queue.
+ * @return The handle of the item.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline typename AddressablePriorityQueue<T, Compare, Alloc, Arity>::handle_type
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+push(value_type&& value)
+{
+  return emplace(std::move(value));
+}
+
+/**
+ * @brief Push an item into the queue by constructing it in place.
+ * @param args The arguments used to construct the object.
+ * @return The handle of the item.
+ * @throw May throw memory allocation failure, or an exception thrown while
+ *  constructing the item or comparing items. The queue is unchanged if an
+ *  exception is thrown while constructing the item.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+  template<typename... Args>
+typename AddressablePriorityQueue<T, Compare, Alloc, Arity>::handle_type
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+emplace(Args&&... args)
+{
+  // make room first, so nothing below can fail after the slot is taken, and
+  // so the free list can take every slot without allocating
+  makeRoom(mHeap, mHeap.size() + 1);
+
+  handle_type handle;
+  if (mFree.empty())
+  {
+    makeRoom(mFree, mSlots.size() + 1);
+    handle = mSlots.size();
+    mSlots.emplace_back(npos, std::forward<Args>(args)...);
+  }
+  else
+  {
+    handle = mFree.back();
+    mSlots[handle].value = value_type(std::forward<Args>(args)...);
+    mFree.pop_back();
+  }
+
+  auto pos = mHeap.size();
+  mHeap.push_back(handle);
+  mSlots[handle].pos = pos;
+  bubbleUp(pos);
+
+  return handle;
+}
+
+/**
+ * @brief Remove the top value from the queue.
+ * @details The handle of the top value becomes invalid.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+pop()
+{
+  if (mHeap.empty())
+    return;
+
+  removeAt(0);
+}
+
+/**
+ * @brief Remove the top value from the queue and return it.
+ * @return The top value, moved out of the queue. The queue must not be empty.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline T AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+pop_value()
+{
+  assert(!mHeap.empty());
+
+  auto val = std::move(mSlots[mHeap[0]].value);
+  removeAt(0);
+  return val;
+}
+
+/**
+ * @brief Make room for at least <em>size</em> items.
+ * @param size The minimum capacity.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+reserve(size_type size)
+{
+  mSlots.reserve(size);
+  mHeap.reserve(size);
+}
+
+/**
+ * @brief Remove all the items. All handles become invalid.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+clear() noexcept
+{
+  mSlots.clear();
+  mHeap.clear();
+  mFree.clear();
+}
+
+/**
+ * @brief Determine if a handle refers to an item in the queue.
+ * @param handle The handle.
+ * @return True if the item has not been popped or erased, false otherwise.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline bool AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+contains(handle_type handle) const noexcept
+{
+  return handle < mSlots.size() && mSlots[handle].pos != npos;
+}
+
+/**
+ * @brief Get the value of an item.
+ * @param handle The handle of the item, which must be in the queue.
+ * @return A reference to the value. It stays valid until the item is popped or
+ *  erased, even if other items are pushed.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline
+typename AddressablePriorityQueue<T, Compare, Alloc, Arity>::const_reference
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+get(handle_type handle) const noexcept
+{
+  assert(contains(handle));
+  return mSlots[handle].value;
+}
+
+/**
+ * @brief Change the value of an item and move it to its right place.
+ * @param handle The handle of the item, which must be in the queue.
+ * @param value The new value.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+update(handle_type handle, const value_type& value)
+{
+  assert(contains(handle));
+  mSlots[handle].value = value;
+  resift(mSlots[handle].pos);
+}
+
+/**
+ * @brief Change the value of an item and move it to its right place.
+ * @param handle The handle of the item, which must be in the queue.
+ * @param value The new value.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+update(handle_type handle, value_type&& value)
+{
+  assert(contains(handle));
+  mSlots[handle].value = std::move(value);
+  resift(mSlots[handle].pos);
+}
+
+/**
+ * @brief Move an item to its right place after its priority changed.
+ * @details Use this when the comparator depends on state outside the item,
+ *  such as a table of distances indexed by the item.
+ * @param handle The handle of the item, which must be in the queue.
+ * @throw Never throws, provided the comparator does not throw.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+update(handle_type handle) noexcept
+{
+  assert(contains(handle));
+  resift(mSlots[handle].pos);
+}
+
+/**
+ * @brief Give an item a value that moves it toward the top.
+ * @details For <em>std::less</em> the new value must not be greater than the
+ *  old one. Only a bubble up is done.
+ * @param handle The handle of the item, which must be in the queue.
+ * @param value The new value.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+decrease_key(handle_type handle, const value_type& value)
+{
+  assert(contains(handle));
+  assert(!mCompare(mSlots[handle].value, value));
+  mSlots[handle].value = value;
+  bubbleUp(mSlots[handle].pos);
+}
+
+/**
+ * @brief Give an item a value that moves it toward the top.
+ * @details For <em>std::less</em> the new value must not be greater than the
+ *  old one. Only a bubble up is done.
+ * @param handle The handle of the item, which must be in the queue.
+ * @param value The new value.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+decrease_key(handle_type handle, value_type&& value)
+{
+  assert(contains(handle));
+  assert(!mCompare(mSlots[handle].value, value));
+  mSlots[handle].value = std::move(value);
+  bubbleUp(mSlots[handle].pos);
+}
+
+/**
+ * @brief Give an item a value that moves it away from the top.
+ * @details For <em>std::less</em> the new value must not be less than the old
+ *  one. Only a bubble down is done.
+ * @param handle The handle of the item, which must be in the queue.
+ * @param value The new value.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+increase_key(handle_type handle, const value_type& value)
+{
+  assert(contains(handle));
+  assert(!mCompare(value, mSlots[handle].value));
+  mSlots[handle].value = value;
+  bubbleDown(mSlots[handle].pos);
+}
+
+/**
+ * @brief Give an item a value that moves it away from the top.
+ * @details For <em>std::less</em> the new value must not be less than the old
+ *  one. Only a bubble down is done.
+ * @param handle The handle of the item, which must be in the queue.
+ * @param value The new value.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+increase_key(handle_type handle, value_type&& value)
+{
+  assert(contains(handle));
+  assert(!mCompare(value, mSlots[handle].value));
+  mSlots[handle].value = std::move(value);
+  bubbleDown(mSlots[handle].pos);
+}
+
+/**
+ * @brief Remove an item from the queue.
+ * @details The handle becomes invalid.
+ * @param handle The handle of the item, which must be in the queue.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+erase(handle_type handle)
+{
+  assert(contains(handle));
+  removeAt(mSlots[handle].pos);
+}
+
+/**
+ * @brief Get parent of the node at the given index.
+ * @param index The index of the child node. Must not be the root.
+ * @return The index of the parent.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline typename AddressablePriorityQueue<T, Compare, Alloc, Arity>::size_type
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+parent(size_type index) const noexcept
+{
+  assert(index > 0);
+  return (index - 1) / Arity;
+}
+
+/**
+ * @brief Get the first child of the node at the given index.
+ * @param index The index of the parent node.
+ * @return The index of the first child.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline typename AddressablePriorityQueue<T, Compare, Alloc, Arity>::size_type
+AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+firstChild(size_type index) const noexcept
+{
+  return index * Arity + 1;
+}
+
+/**
+ * @brief Determine if one item should be above another.
+ * @param a The handle of the first item.
+ * @param b The handle of the second item.
+ * @return True if <em>a</em> goes before <em>b</em>.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline bool AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+before(handle_type a, handle_type b) const
+{
+  return mCompare(mSlots[a].value, mSlots[b].value);
+}
+
+/**
+ * @brief Put a handle at a position of the heap and record the position.
+ * @param pos The position in the heap.
+ * @param handle The handle.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+place(size_type pos, handle_type handle) noexcept
+{
+  mHeap[pos] = handle;
+  mSlots[handle].pos = pos;
+}
+
+/**
+ * @brief Bubble up a node up the heap to its right place.
+ * @param pos The position of the node.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+bubbleUp(size_type pos)
+{
+  auto handle = mHeap[pos];
+
+  while (pos > 0)
+  {
+    auto p = parent(pos);
+    if (!before(handle, mHeap[p]))
+      break;
+
+    place(pos, mHeap[p]);
+    pos = p;
+  }
+
+  place(pos, handle);
+}
+
+/**
+ * @brief Bubble down a node to its right place.
+ * @param pos The position of the node.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+bubbleDown(size_type pos)
+{
+  auto handle = mHeap[pos];
+  auto count = mHeap.size();
+
+  for (auto first = firstChild(pos); first < count; first = firstChild(pos))
+  {
+    auto last = first + Arity < count ? first + Arity : count;
+
+    auto best = first;
+    for (auto i = first + 1; i < last; ++i)
+    {
+      if (before(mHeap[i], mHeap[best]))
+        best = i;
+    }
+
+    if (!before(mHeap[best], handle))
+      break;
+
+    place(pos, mHeap[best]);
+    pos = best;
+  }
+
+  place(pos, handle);
+}
+
+/**
+ * @brief Move a node up or down to its right place.
+ * @param pos The position of the node.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+resift(size_type pos)
+{
+  if (pos > 0 && before(mHeap[pos], mHeap[parent(pos)]))
+    bubbleUp(pos);
+  else
+    bubbleDown(pos);
+}
+
+/**
+ * @brief Remove the node at a position of the heap and free its slot.
+ * @details The last node takes its place and is moved up or down.
+ * @param pos The position of the node.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+removeAt(size_type pos)
+{
+  // a no-op unless the queue was copied, so the slot is never lost
+  makeRoom(mFree, mFree.size() + 1);
+
+  auto handle = mHeap[pos];
+  auto last = mHeap.back();
+  mHeap.pop_back();
+
+  mSlots[handle].pos = npos;
+  mFree.push_back(handle);
+
+  // release the resources held by the value right away
+  static_cast<void>(value_type(std::move(mSlots[handle].value)));
+
+  if (pos < mHeap.size())
+  {
+    place(pos, last);
+    resift(pos);
+  }
+}
+
+/**
+ * @brief Make room for at least <em>size</em> elements in a vector.
+ * @details The capacity is at least doubled when it grows, so that growing
+ *  one element at a time takes amortized constant time.
+ * @param vec The vector.
+ * @param size The minimum capacity.
+ * @throw May throw memory allocation failure, in which case the vector is
+ *  unchanged.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+  template<typename Vector>
+inline void AddressablePriorityQueue<T, Compare, Alloc, Arity>::
+makeRoom(Vector& vec, size_type size)
+{
+  if (size > vec.capacity())
+    vec.reserve(std::max(size, 2 * vec.capacity()));
+}
+
+} // namespace ospp
+
+#endif /* _ADDRESSABLE_QUEUE_H */
@@ -0,0 +1,237 @@
+/**
+ * @file child_select.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _CHILD_SELECT_H
+#define _CHILD_SELECT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+/**
+ * AVX2 child selection is compiled in on x86 with GCC or Clang, unless
+ * OSPP_NO_SIMD is defined. The AVX2 code is built with a target attribute, so
+ * the rest of the program does not need -mavx2, and it only runs if the CPU
+ * supports AVX2.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+  && !defined(OSPP_NO_SIMD)
+#define OSPP_X86_SIMD 1
+#include <immintrin.h>
+#define OSPP_AVX2 __attribute__((target("avx2")))
+#define OSPP_AVX2_INLINE __attribute__((target("avx2"), always_inline)) inline
+#endif
+
+namespace ospp {
+namespace detail {
+
+/**
+ * @brief Determine if the CPU supports AVX2.
+ * @return True if the AVX2 child selection may run, false otherwise.
+ */
+inline bool hasAvx2() noexcept
+{
+#ifdef OSPP_X86_SIMD
+  static const bool avx2 =
+    (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+  return avx2;
+#else
+  return false;
+#endif
+}
+
+#ifdef OSPP_X86_SIMD
+
+/**
+ * AVX2 operations on eight signed 32-bit lanes.
+ */
+struct Int32Lanes
+{
+  using scalar = std::int32_t;
+  using vec = __m256i;
+
+  OSPP_AVX2_INLINE static vec load(const scalar *p)
+  { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+  OSPP_AVX2_INLINE static vec min(vec a, vec b)
+  { return _mm256_min_epi32(a, b); }
+  OSPP_AVX2_INLINE static vec max(vec a, vec b)
+  { return _mm256_max_epi32(a, b); }
+  OSPP_AVX2_INLINE static vec swapHalves(vec a)
+  { return _mm256_permute2x128_si256(a, a, 1); }
+  OSPP_AVX2_INLINE static vec swapPairs(vec a)
+  { return _mm256_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2)); }
+  OSPP_AVX2_INLINE static vec swapLanes(vec a)
+  { return _mm256_shuffle_epi32(a, _MM_SHUFFLE(2, 3, 0, 1)); }
+  OSPP_AVX2_INLINE static int equal(vec a, vec b)
+  {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+  }
+};
+
+/**
+ * AVX2 operations on eight unsigned 32-bit lanes.
+ */
+struct UInt32Lanes : Int32Lanes
+{
+  using scalar = std::uint32_t;
+
+  OSPP_AVX2_INLINE static vec load(const scalar *p)
+  { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+  OSPP_AVX2_INLINE static vec min(vec a, vec b)
+  { return _mm256_min_epu32(a, b); }
+  OSPP_AVX2_INLINE static vec max(vec a, vec b)
+  { return _mm256_max_epu32(a, b); }
+};
+
+/**
+ * AVX2 operations on eight float lanes. NaN keys are not supported, just like
+ * with scalar comparisons.
+ */
+struct FloatLanes
+{
+  using scalar = float;
+  using vec = __m256;
+
+  OSPP_AVX2_INLINE static vec load(const scalar *p)
+  { return _mm256_loadu_ps(p); }
+  OSPP_AVX2_INLINE static vec min(vec a, vec b)
+  { return _mm256_min_ps(a, b); }
+  OSPP_AVX2_INLINE static vec max(vec a, vec b)
+  { return _mm256_max_ps(a, b); }
+  OSPP_AVX2_INLINE static vec swapHalves(vec a)
+  { return _mm256_permute2f128_ps(a, a, 1); }
+  OSPP_AVX2_INLINE static vec swapPairs(vec a)
+  { return _mm256_permute_ps(a, _MM_SHUFFLE(1, 0, 3, 2)); }
+  OSPP_AVX2_INLINE static vec swapLanes(vec a)
+  { return _mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1)); }
+  OSPP_AVX2_INLINE static int equal(vec a, vec b)
+  { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+};
+
+/**
+ * Find the best of 8 or 16 contiguous keys with AVX2.
+ * @details The keys are reduced to the best one, which is broadcast to every
+ *  lane, and then compared for equality with all the keys. The lowest set bit
+ *  of the mask is the first best key, which is the same child a scalar loop
+ *  with a strict comparison would pick.
+ */
+template<typename Lanes, bool Max, std::size_t Arity>
+struct Avx2Select
+{
+  using scalar = typename Lanes::scalar;
+  using vec = typename Lanes::vec;
+
+  OSPP_AVX2_INLINE static vec pick(vec a, vec b)
+  { return Max ? Lanes::max(a, b) : Lanes::min(a, b); }
+
+  OSPP_AVX2 static int best(const scalar *first) noexcept
+  {
+    auto lo = Lanes::load(first);
+    auto hi = Arity == 16 ? Lanes::load(first + 8) : lo;
+
+    auto v = pick(lo, hi);
+    v = pick(v, Lanes::swapHalves(v));
+    v = pick(v, Lanes::swapPairs(v));
+    v = pick(v, Lanes::swapLanes(v));
+
+    auto mask = static_cast<unsigned>(Lanes::equal(lo, v));
+    if (Arity == 16)
+      mask |= static_cast<unsigned>(Lanes::equal(hi, v)) << 8;
+
+    return __builtin_ctz(mask);
+  }
+};
+
+/**
+ * The lanes for a key type, or void if the type has no AVX2 path.
+ */
+template<typename T>
+struct LanesOf
+{
+  using type = typename std::conditional<
+    std::is_same<T, std::int32_t>::value, Int32Lanes,
+    typename std::conditional<
+      std::is_same<T, std::uint32_t>::value, UInt32Lanes,
+      typename std::conditional<
+        std::is_same<T, float>::value, FloatLanes, void>::type>::type>::type;
+};
+
+#else
+
+template<typename T>
+struct LanesOf
+{
+  using type = void;
+};
+
+#endif
+
+/**
+ * Whether a comparator picks the smallest or the largest key.
+ */
+template<typename T, typename Compare>
+struct PicksMax
+{
+  enum { known = false, value = false };
+};
+
+template<typename T>
+struct PicksMax<T, std::less<T>>
+{
+  enum { known = true, value = false };
+};
+
+template<typename T>
+struct PicksMax<T, std::greater<T>>
+{
+  enum { known = true, value = true };
+};
+
+/**
+ * ChildSelect.
+ * @details Finds the best child among all <em>Arity</em> children of a node.
+ *  This is the scalar case: <em>vectorized</em> is false and the caller uses
+ *  its own loop.
+ */
+template<typename T, typename Compare, std::size_t Arity, typename = void>
+struct ChildSelect
+{
+  static constexpr bool vectorized = false;
+
+  static bool enabled() noexcept { return false; }
+  static int best(const T *) noexcept { return 0; }
+};
+
+#ifdef OSPP_X86_SIMD
+
+/**
+ * ChildSelect for 32-bit integer and float keys compared with
+ * <em>std::less</em> or <em>std::greater</em>, in heaps with 8 or 16 children
+ * per node. Only used if the CPU supports AVX2.
+ */
+template<typename T, typename Compare, std::size_t Arity>
+struct ChildSelect<T, Compare, Arity, typename std::enable_if<
+  (Arity == 8 || Arity == 16) &&
+  PicksMax<T, Compare>::known &&
+  !std::is_void<typename LanesOf<T>::type>::value>::type>
+{
+  static constexpr bool vectorized = true;
+
+  static bool enabled() noexcept { return hasAvx2(); }
+
+  static int best(const T *first) noexcept
+  {
+    return Avx2Select<typename LanesOf<T>::type,
+                      PicksMax<T, Compare>::value, Arity>::best(first);
+  }
+};
+
+#endif
+
+} // namespace detail
+} // namespace ospp
+
+#endif /* _CHILD_SELECT_H */
@@ -0,0 +1,745 @@
+/**
+ * @file external_queue.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _EXTERNAL_QUEUE_H
+#define _EXTERNAL_QUEUE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "queue/queue.hh"
+
+namespace ospp {
+namespace detail {
+
+/**
+ * @brief Create an anonymous temporary file.
+ * @details The file is unlinked as soon as it is created, so it goes away
+ *  when its descriptor is closed, even if the process dies.
+ * @param directory The directory of the file.
+ * @return The file descriptor.
+ * @throw std::system_error if the file cannot be created.
+ */
+inline int makeSpillFile(const std::string& directory)
+{
+  std::string path = directory + "/ospp-spill-XXXXXX";
+  int fd = ::mkstemp(&path[0]);
+  if (fd < 0)
+    throw std::system_error(errno, std::generic_category(), path);
+
+  ::unlink(path.c_str());
+  return fd;
+}
+
+/**
+ * @brief Write all the bytes of a buffer to a file.
+ * @param fd The file descriptor.
+ * @param buf The buffer.
+ * @param bytes The number of bytes.
+ * @throw std::system_error if the write fails.
+ */
+inline void writeAll(int fd, const void *buf, std::size_t bytes)
+{
+  auto ptr = static_cast<const char*>(buf);
+  while (bytes > 0)
+  {
+    auto n = ::write(fd, ptr, bytes);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      throw std::system_error(errno, std::generic_category(), "spill write");
+    }
+
+    ptr += n;
+    bytes -= n;
+  }
+}
+
+/**
+ * @brief Fill a buffer from a file.
+ * @param fd The file descriptor.
+ * @param buf The buffer.
+ * @param bytes The number of bytes.
+ * @throw std::system_error if the read fails or the file ends too soon.
+ */
+inline void readAll(int fd, void *buf, std::size_t bytes)
+{
+  auto ptr = static_cast<char*>(buf);
+  while (bytes > 0)
+  {
+    auto n = ::read(fd, ptr, bytes);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      throw std::system_error(n < 0 ? errno : EIO, std::generic_category(),
+                              "spill read");
+
+    ptr += n;
+    bytes -= n;
+  }
+}
+
+/**
+ * SpillRun.
+ * @details A sorted run in a temporary file, read back one block at a time.
+ *  Only the block holding the head of the run is kept in memory.
+ */
+template<typename T, typename Alloc>
+class SpillRun
+{
+public:
+  using size_type = std::size_t;
+  using block_type = std::vector<T, Alloc>;
+
+  SpillRun(const std::string& directory, size_type blockSize,
+           const Alloc& alloc)
+    : mBlock(alloc),
+      mFd(makeSpillFile(directory)),
+      mPos(0),
+      mOnDisk(0)
+  {
+    mBlock.reserve(blockSize);
+  }
+
+  SpillRun(SpillRun&& run) noexcept
+    : mBlock(std::move(run.mBlock)),
+      mFd(run.mFd),
+      mPos(run.mPos),
+      mOnDisk(run.mOnDisk)
+  {
+    run.mFd = -1;
+  }
+
+  SpillRun& operator=(SpillRun&& run) noexcept
+  {
+    std::swap(mBlock, run.mBlock);
+    std::swap(mFd, run.mFd);
+    std::swap(mPos, run.mPos);
+    std::swap(mOnDisk, run.mOnDisk);
+    return *this;
+  }
+
+  ~SpillRun()
+  {
+    if (mFd >= 0)
+      ::close(mFd);
+  }
+
+  /**
+   * @return The file descriptor.
+   */
+  int fd() const noexcept
+  {
+    return mFd;
+  }
+
+  /**
+   * @brief Start reading the run once it has been written.
+   * @param count The number of items written.
+   * @return The number of bytes read.
+   */
+  size_type rewind(size_type count)
+  {
+    if (::lseek(mFd, 0, SEEK_SET) < 0)
+      throw std::system_error(errno, std::generic_category(), "spill seek");
+
+    mOnDisk = count;
+    return load();
+  }
+
+  /**
+   * @return The number of items not read yet.
+   */
+  size_type size() const noexcept
+  {
+    return mBlock.size() - mPos + mOnDisk;
+  }
+
+  /**
+   * @return The head of the run. Must not be empty.
+   */
+  const T& head() const noexcept
+  {
+    return mBlock[mPos];
+  }
+
+  /**
+   * @brief Move past the head, reading the next block if needed.
+   * @return The number of bytes read.
+   */
+  size_type advance()
+  {
+    return ++mPos < mBlock.size() ? 0 : load();
+  }
+
+  /**
+   * @brief Read the next block once the current one is used up.
+   * @return The number of bytes read.
+   */
+  size_type load()
+  {
+    auto count = std::min(mBlock.capacity(), mOnDisk);
+    mBlock.resize(count);
+    mPos = 0;
+    mOnDisk -= count;
+    readAll(mFd, mBlock.data(), count * sizeof(T));
+    return count * sizeof(T);
+  }
+
+private:
+  block_type mBlock;
+  int mFd;
+  size_type mPos;
+  size_type mOnDisk;
+};
+
+/**
+ * SpillWriter.
+ * @details Output iterator that writes a sorted run to a file in whole
+ *  blocks.
+ */
+template<typename T, typename Alloc>
+class SpillWriter
+{
+public:
+  using iterator_category = std::output_iterator_tag;
+  using value_type = void;
+  using difference_type = void;
+  using pointer = void;
+  using reference = void;
+
+  SpillWriter(std::vector<T, Alloc>& block, int fd) noexcept
+    : mBlock(&block),
+      mFd(fd)
+  {}
+
+  SpillWriter& operator*() noexcept { return *this; }
+  SpillWriter& operator++() noexcept { return *this; }
+  SpillWriter& operator++(int) noexcept { return *this; }
+
+  SpillWriter& operator=(const T& value)
+  {
+    mBlock->push_back(value);
+    if (mBlock->size() == mBlock->capacity())
+      flush();
+    return *this;
+  }
+
+  /**
+   * @brief Write the items in the block.
+   */
+  void flush()
+  {
+    writeAll(mFd, mBlock->data(), mBlock->size() * sizeof(T));
+    mBlock->clear();
+  }
+
+private:
+  std::vector<T, Alloc> *mBlock;
+  int mFd;
+};
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * ExternalPriorityQueue.
+ * @details A priority queue for more items than fit in memory. Items are
+ *  pushed into a <em>PriorityQueue</em> that serves as the insertion buffer.
+ *  When the buffer fills up it is heap sorted in place and written to an
+ *  unlinked temporary file in the spill directory as a sorted run. A pop takes
+ *  the best of the buffer top and the heads of the runs, which are kept in a
+ *  small merge heap, so the runs are merged lazily as items are popped.
+ *
+ *  All file I/O is sequential and done in blocks of <em>blockBytes</em>. Half
+ *  of the memory budget goes to the insertion buffer and the other half to
+ *  blocks: one to write runs, and one for the head of each run. When there
+ *  are as many runs as read blocks, the smaller half of the runs is merged
+ *  into one before the next spill, which keeps the number of runs, and the
+ *  memory, bounded.
+ *
+ *  Items are written to disk as raw bytes, so <em>T</em> must be trivially
+ *  copyable. Popped items come out in the same order as from a
+ *  <em>PriorityQueue</em> with the same comparator.
+ */
+template
+<
+  typename T,
+  typename Compare = std::less<T>,
+  typename Alloc = std::allocator<T>
+>
+class ExternalPriorityQueue
+{
+  static_assert(std::is_trivially_copyable<T>::value,
+                "items are spilled to disk as raw bytes");
+
+  struct Head
+  {
+    T value;
+    std::size_t run;
+  };
+
+  struct HeadCompare
+  {
+    Compare comp;
+
+    bool operator()(const Head& a, const Head& b) const
+    {
+      return comp(a.value, b.value);
+    }
+  };
+
+  using run_type = detail::SpillRun<T, Alloc>;
+
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using allocator_type = Alloc;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+  using compare_type = Compare;
+  using queue_type = PriorityQueue<T, Compare, Alloc>;
+
+  /**
+   * Initialize
+   */
+  explicit ExternalPriorityQueue
+    (size_type memoryBytes,
+     const std::string& directory = "/tmp",
+     size_type blockBytes = 1 << 20,
+     const compare_type& comp = compare_type());
+
+  ExternalPriorityQueue(const ExternalPriorityQueue& cont) = delete;
+  ExternalPriorityQueue(ExternalPriorityQueue&& cont) = default;
+  ExternalPriorityQueue& operator=(const ExternalPriorityQueue& cont) = delete;
+  ExternalPriorityQueue& operator=(ExternalPriorityQueue&& cont) = default;
+
+  /**
+   * queue functionality
+   */
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  const_reference top() const noexcept;
+  void push(const value_type& value);
+  template<typename... Args>
+  void emplace(Args&&... args);
+  void pop();
+  value_type pop_value();
+
+  /**
+   * spill functionality
+   */
+  size_type runs() const noexcept;
+  size_type spills() const noexcept;
+  size_type bytes_written() const noexcept;
+  size_type bytes_read() const noexcept;
+  const std::string& directory() const noexcept;
+
+private:
+  bool topInBuffer() const noexcept;
+  void spill();
+  void compact();
+  void rebuildHeads();
+
+  /**
+   * The insertion buffer.
+   */
+  queue_type mBuffer;
+
+  /**
+   * The heads of the runs, best on top.
+   */
+  PriorityQueue<Head, HeadCompare> mHeads;
+
+  /**
+   * The runs on disk.
+   */
+  std::vector<run_type> mRuns;
+
+  /**
+   * The block used to write runs.
+   */
+  std::vector<T, Alloc> mWriteBlock;
+
+  /**
+   * The directory of the temporary files.
+   */
+  std::string mDirectory;
+
+  /**
+   * The number of items the buffer holds before it is spilled.
+   */
+  size_type mBufferLimit;
+
+  /**
+   * The number of items in a block.
+   */
+  size_type mBlockSize;
+
+  /**
+   * The maximum number of runs.
+   */
+  size_type mRunLimit;
+
+  /**
+   * The number of items in the runs.
+   */
+  size_type mOnDisk;
+
+  /**
+   * I/O counters.
+   */
+  size_type mSpills;
+  size_type mBytesWritten;
+  size_type mBytesRead;
+
+  /**
+   * The comparator.
+   */
+  compare_type mCompare;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Constructor.
+ * @details The insertion buffer is allocated up front.
+ * @param memoryBytes The memory budget for the items, in bytes. At least one
+ *  item and three blocks are always used.
+ * @param directory The directory of the temporary files.
+ * @param blockBytes The size of a block of file I/O, in bytes.
+ * @param comp The object used to compare items.
+ * @throw May throw memory allocation failure.
+ */
+template<typename T, typename Compare, typename Alloc>
+ExternalPriorityQueue<T, Compare, Alloc>::
+ExternalPriorityQueue(size_type memoryBytes, const std::string& directory,
+                      size_type blockBytes, const compare_type& comp)
+  : mBuffer(comp),
+    mHeads(HeadCompare{comp}),
+    mRuns(),
+    mWriteBlock(),
+    mDirectory(directory),
+    mBufferLimit(std::max<size_type>(1, memoryBytes / 2 / sizeof(T))),
+    mBlockSize(std::max<size_type>(1, blockBytes / sizeof(T))),
+    mRunLimit(std::max<size_type>(3, memoryBytes / 2 / blockBytes) - 1),
+    mOnDisk(0),
+    mSpills(0),
+    mBytesWritten(0),
+    mBytesRead(0),
+    mCompare(comp)
+{
+  mBuffer.reserve(mBufferLimit);
+  mWriteBlock.reserve(mBlockSize);
+}
+
+/**
+ * @brief Determine if the queue is empty.
+ * @return True if empty, false otherwise.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline bool ExternalPriorityQueue<T, Compare, Alloc>::
+empty() const noexcept
+{
+  return mBuffer.empty() && mOnDisk == 0;
+}
+
+/**
+ * @return The number of items in the queue, in memory and on disk.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename ExternalPriorityQueue<T, Compare, Alloc>::size_type
+ExternalPriorityQueue<T, Compare, Alloc>::
+size() const noexcept
+{
+  return mBuffer.size() + mOnDisk;
+}
+
+/**
+ * @brief Get the top item.
+ * @return A reference to the item at the top. Must not be empty.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename ExternalPriorityQueue<T, Compare, Alloc>::const_reference
+ExternalPriorityQueue<T, Compare, Alloc>::
+top() const noexcept
+{
+  return topInBuffer() ? mBuffer.top() : mHeads.top().value;
+}
+
+/**
+ * @brief Push a copy of an item.
+ * @details Spills the insertion buffer first if it is full.
+ * @param value The value.
+ * @throw May throw memory allocation failure, or std::system_error if the
+ *  buffer cannot be spilled.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline void ExternalPriorityQueue<T, Compare, Alloc>::
+push(const value_type& value)
+{
+  if (mBuffer.size() == mBufferLimit)
+    spill();
+
+  mBuffer.push(value);
+}
+
+/**
+ * @brief Construct an item in place.
+ * @param args The arguments of the constructor of the item.
+ * @throw May throw memory allocation failure, std::system_error if the
+ *  buffer cannot be spilled, or an exception thrown while constructing the
+ *  item.
+ */
+template<typename T, typename Compare, typename Alloc>
+  template<typename... Args>
+inline void ExternalPriorityQueue<T, Compare, Alloc>::
+emplace(Args&&... args)
+{
+  if (mBuffer.size() == mBufferLimit)
+    spill();
+
+  mBuffer.emplace(std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Remove the top item.
+ * @details If the item comes from a run, the next item of that run takes its
+ *  place in the merge heap, and a new block is read if needed. Must not be
+ *  empty.
+ * @throw std::system_error if a block cannot be read.
+ */
+template<typename T, typename Compare, typename Alloc>
+void ExternalPriorityQueue<T, Compare, Alloc>::
+pop()
+{
+  if (topInBuffer()) {
+    mBuffer.pop();
+    return;
+  }
+
+  auto index = mHeads.top().run;
+  auto& run = mRuns[index];
+  --mOnDisk;
+  if (run.size() > 1) {
+    mBytesRead += run.advance();
+    mHeads.replace_top(Head{run.head(), index});
+  }
+  else {
+    run.advance();
+    mHeads.pop();
+  }
+}
+
+/**
+ * @brief Remove the top item and return it.
+ * @return The top item. Must not be empty.
+ * @throw std::system_error if a block cannot be read.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename ExternalPriorityQueue<T, Compare, Alloc>::value_type
+ExternalPriorityQueue<T, Compare, Alloc>::
+pop_value()
+{
+  value_type value = top();
+  pop();
+  return value;
+}
+
+/**
+ * @return The number of runs on disk, including empty ones not merged yet.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename ExternalPriorityQueue<T, Compare, Alloc>::size_type
+ExternalPriorityQueue<T, Compare, Alloc>::
+runs() const noexcept
+{
+  return mRuns.size();
+}
+
+/**
+ * @return The number of times the insertion buffer was spilled.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename ExternalPriorityQueue<T, Compare, Alloc>::size_type
+ExternalPriorityQueue<T, Compare, Alloc>::
+spills() const noexcept
+{
+  return mSpills;
+}
+
+/**
+ * @return The number of bytes written to the runs, including merges.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename ExternalPriorityQueue<T, Compare, Alloc>::size_type
+ExternalPriorityQueue<T, Compare, Alloc>::
+bytes_written() const noexcept
+{
+  return mBytesWritten;
+}
+
+/**
+ * @return The number of bytes read from the runs, including merges.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename ExternalPriorityQueue<T, Compare, Alloc>::size_type
+ExternalPriorityQueue<T, Compare, Alloc>::
+bytes_read() const noexcept
+{
+  return mBytesRead;
+}
+
+/**
+ * @return The directory of the temporary files.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline const std::string& ExternalPriorityQueue<T, Compare, Alloc>::
+directory() const noexcept
+{
+  return mDirectory;
+}
+
+/**
+ * @brief Determine if the top item is in the insertion buffer.
+ * @return True if the buffer top is not worse than the best run head.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline bool ExternalPriorityQueue<T, Compare, Alloc>::
+topInBuffer() const noexcept
+{
+  if (mHeads.empty())
+    return true;
+
+  return !mBuffer.empty() && !mCompare(mHeads.top().value, mBuffer.top());
+}
+
+/**
+ * @brief Write the insertion buffer to a new run.
+ * @details Runs that were used up are dropped, and the smaller runs are
+ *  merged first if there are too many.
+ * @throw May throw memory allocation failure, or std::system_error if a file
+ *  cannot be created, written or read. Items being written or merged when a
+ *  write or read fails are lost. The runs may have been reordered, so the
+ *  merge heap is rebuilt before the exception is passed on, and the other
+ *  items still pop in order.
+ */
+template<typename T, typename Compare, typename Alloc>
+void ExternalPriorityQueue<T, Compare, Alloc>::
+spill()
+{
+  try {
+    mRuns.erase(std::remove_if(mRuns.begin(), mRuns.end(),
+                               [](const run_type& run) {
+                                 return run.size() == 0;
+                               }),
+                mRuns.end());
+    if (mRuns.size() >= mRunLimit)
+      compact();
+
+    run_type run(mDirectory, mBlockSize, mWriteBlock.get_allocator());
+    auto count = mBuffer.size();
+    detail::SpillWriter<T, Alloc> out(mWriteBlock, run.fd());
+    mBuffer.drain_sorted(out).flush();
+    mBytesRead += run.rewind(count);
+    mRuns.push_back(std::move(run));
+    mBytesWritten += count * sizeof(T);
+    ++mSpills;
+  }
+  catch (...) {
+    rebuildHeads();
+    throw;
+  }
+
+  rebuildHeads();
+}
+
+/**
+ * @brief Merge the smaller half of the runs, but at least two, into one run.
+ * @details The heads of the merge heap are rebuilt afterwards by the caller.
+ * @throw May throw memory allocation failure, or std::system_error if a file
+ *  cannot be created, written or read.
+ */
+template<typename T, typename Compare, typename Alloc>
+void ExternalPriorityQueue<T, Compare, Alloc>::
+compact()
+{
+  std::sort(mRuns.begin(), mRuns.end(),
+            [](const run_type& a, const run_type& b) {
+              return a.size() > b.size();
+            });
+
+  auto first = std::min(mRuns.size() / 2, mRuns.size() - 2);
+  PriorityQueue<Head, HeadCompare> heads(HeadCompare{mCompare});
+  size_type count = 0;
+  for (auto i = first; i < mRuns.size(); ++i)
+  {
+    heads.push(Head{mRuns[i].head(), i});
+    count += mRuns[i].size();
+  }
+
+  run_type merged(mDirectory, mBlockSize, mWriteBlock.get_allocator());
+  detail::SpillWriter<T, Alloc> out(mWriteBlock, merged.fd());
+  while (!heads.empty())
+  {
+    auto index = heads.top().run;
+    auto& run = mRuns[index];
+    out = run.head();
+    if (run.size() > 1) {
+      mBytesRead += run.advance();
+      heads.replace_top(Head{run.head(), index});
+    }
+    else {
+      run.advance();
+      heads.pop();
+    }
+  }
+
+  out.flush();
+  mBytesRead += merged.rewind(count);
+  mRuns.erase(mRuns.begin() + first, mRuns.end());
+  mRuns.push_back(std::move(merged));
+  mBytesWritten += count * sizeof(T);
+}
+
+/**
+ * @brief Rebuild the merge heap from the heads of the runs, and count the
+ *  items on disk again.
+ */
+template<typename T, typename Compare, typename Alloc>
+void ExternalPriorityQueue<T, Compare, Alloc>::
+rebuildHeads()
+{
+  mHeads.clear();
+  mOnDisk = 0;
+  for (size_type i = 0; i < mRuns.size(); ++i)
+  {
+    mOnDisk += mRuns[i].size();
+    if (mRuns[i].size() > 0)
+      mHeads.push(Head{mRuns[i].head(), i});
+  }
+}
+
+} // namespace ospp
+
+#endif /* _EXTERNAL_QUEUE_H */
@@ -0,0 +1,313 @@
+/**
+ * @file inline_allocator.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _INLINE_ALLOCATOR_H
+#define _INLINE_ALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+#include "queue/queue.hh"
+
+namespace ospp {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * InlineAllocator.
+ * @details Puts a <em>PriorityQueue</em> in small-buffer mode. The allocator
+ *  holds a buffer for <em>N</em> items inside itself, so a queue that never
+ *  holds more than <em>N</em> items never allocates memory. A larger buffer is
+ *  allocated with <em>Upstream</em> when the queue outgrows the inline one.
+ *
+ *  The inline buffer stays with the allocator object: copying, moving or
+ *  assigning an allocator only copies the upstream allocator. A
+ *  <em>PriorityQueue</em> knows this, and moves the items of an inline buffer
+ *  instead of handing the buffer over. Other containers do not, so this
+ *  allocator is only meant for <em>PriorityQueue</em>. All the upstream
+ *  allocators must compare equal.
+ */
+template
+<
+  typename T,
+  std::size_t N,
+  typename Upstream = std::allocator<T>
+>
+class InlineAllocator
+{
+  static_assert(N > 0, "the inline buffer must not be empty");
+  static_assert(std::is_nothrow_move_constructible<T>::value,
+                "moving a queue moves the items of the inline buffer");
+
+  using upstream_traits = std::allocator_traits<Upstream>;
+
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using upstream_type = Upstream;
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::false_type;
+  using propagate_on_container_swap = std::false_type;
+
+  template<typename U>
+  struct rebind
+  {
+    using other = InlineAllocator
+      <U, N, typename upstream_traits::template rebind_alloc<U>>;
+  };
+
+  /**
+   * The number of items that fit in the inline buffer.
+   */
+  static constexpr size_type inline_capacity = N;
+
+  /**
+   * Initialize
+   */
+  InlineAllocator() noexcept;
+  explicit InlineAllocator(const upstream_type& upstream) noexcept;
+  InlineAllocator(const InlineAllocator& alloc) noexcept;
+  template<typename U, typename UpstreamU>
+  InlineAllocator(const InlineAllocator<U, N, UpstreamU>& alloc) noexcept;
+
+  /**
+   * Assignment
+   */
+  InlineAllocator& operator=(const InlineAllocator& alloc) noexcept;
+
+  /**
+   * allocator functionality
+   */
+  pointer allocate(size_type n);
+  void deallocate(pointer ptr, size_type n) noexcept;
+  bool owns(const_pointer ptr) const noexcept;
+  size_type capacity(size_type n) const noexcept;
+  const upstream_type& upstream() const noexcept;
+
+private:
+  /**
+   * The inline buffer.
+   */
+  typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type mBuffer;
+
+  /**
+   * The allocator for buffers that do not fit inline.
+   */
+  upstream_type mUpstream;
+
+  /**
+   * True while the inline buffer is allocated.
+   */
+  bool mUsed;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, std::size_t N, typename Upstream>
+constexpr typename InlineAllocator<T, N, Upstream>::size_type
+InlineAllocator<T, N, Upstream>::inline_capacity;
+
+/**
+ * @brief Default ctor.
+ */
+template<typename T, std::size_t N, typename Upstream>
+InlineAllocator<T, N, Upstream>::
+InlineAllocator() noexcept
+  : mUpstream(),
+    mUsed(false)
+{}
+
+/**
+ * @brief Constructor with one parameter.
+ * @param upstream The allocator for buffers that do not fit inline.
+ */
+template<typename T, std::size_t N, typename Upstream>
+InlineAllocator<T, N, Upstream>::
+InlineAllocator(const upstream_type& upstream) noexcept
+  : mUpstream(upstream),
+    mUsed(false)
+{}
+
+/**
+ * @brief Copy constructor.
+ * @details Only the upstream allocator is copied; the inline buffer of the
+ *  new allocator is free.
+ * @param alloc The allocator being copied.
+ */
+template<typename T, std::size_t N, typename Upstream>
+InlineAllocator<T, N, Upstream>::
+InlineAllocator(const InlineAllocator& alloc) noexcept
+  : mUpstream(alloc.mUpstream),
+    mUsed(false)
+{}
+
+/**
+ * @brief Converting constructor, used when rebinding.
+ * @param alloc The allocator being copied.
+ */
+template<typename T, std::size_t N, typename Upstream>
+  template<typename U, typename UpstreamU>
+InlineAllocator<T, N, Upstream>::
+InlineAllocator(const InlineAllocator<U, N, UpstreamU>& alloc) noexcept
+  : mUpstream(alloc.upstream()),
+    mUsed(false)
+{}
+
+/**
+ * @brief Copy assignment.
+ * @details Only the upstream allocator is copied; the inline buffer keeps its
+ *  state.
+ * @param alloc The allocator being copied.
+ * @return A reference to this allocator.
+ */
+template<typename T, std::size_t N, typename Upstream>
+inline InlineAllocator<T, N, Upstream>&
+InlineAllocator<T, N, Upstream>::
+operator=(const InlineAllocator& alloc) noexcept
+{
+  mUpstream = alloc.mUpstream;
+  return *this;
+}
+
+/**
+ * @brief Allocate a buffer.
+ * @details The inline buffer is used if it is free and the items fit in it.
+ * @param n The number of items.
+ * @return A pointer to the buffer.
+ * @throw May throw memory allocation failure, but not for the inline buffer.
+ */
+template<typename T, std::size_t N, typename Upstream>
+inline typename InlineAllocator<T, N, Upstream>::pointer
+InlineAllocator<T, N, Upstream>::
+allocate(size_type n)
+{
+  if (!mUsed && n <= N) {
+    mUsed = true;
+    return reinterpret_cast<pointer>(&mBuffer);
+  }
+
+  return upstream_traits::allocate(mUpstream, n);
+}
+
+/**
+ * @brief Deallocate a buffer.
+ * @param ptr The buffer.
+ * @param n The number of items it was allocated for.
+ */
+template<typename T, std::size_t N, typename Upstream>
+inline void InlineAllocator<T, N, Upstream>::
+deallocate(pointer ptr, size_type n) noexcept
+{
+  if (owns(ptr)) {
+    mUsed = false;
+    return;
+  }
+
+  upstream_traits::deallocate(mUpstream, ptr, n);
+}
+
+/**
+ * @brief Determine if a buffer is the inline buffer.
+ * @param ptr The buffer.
+ * @return True if <em>ptr</em> is the inline buffer, false otherwise.
+ */
+template<typename T, std::size_t N, typename Upstream>
+inline bool InlineAllocator<T, N, Upstream>::
+owns(const_pointer ptr) const noexcept
+{
+  return ptr == reinterpret_cast<const_pointer>(&mBuffer);
+}
+
+/**
+ * @brief Get the capacity worth allocating for at least <em>n</em> items.
+ * @param n The number of items.
+ * @return <em>N</em> if the items fit in the inline buffer and it is free,
+ *  <em>n</em> otherwise.
+ */
+template<typename T, std::size_t N, typename Upstream>
+inline typename InlineAllocator<T, N, Upstream>::size_type
+InlineAllocator<T, N, Upstream>::
+capacity(size_type n) const noexcept
+{
+  return !mUsed && n <= N ? N : n;
+}
+
+/**
+ * @return The allocator for buffers that do not fit inline.
+ */
+template<typename T, std::size_t N, typename Upstream>
+inline const typename InlineAllocator<T, N, Upstream>::upstream_type&
+InlineAllocator<T, N, Upstream>::
+upstream() const noexcept
+{
+  return mUpstream;
+}
+
+/**
+ * @brief Equality operator.
+ * @details An inline buffer can only be deallocated by its own allocator, so
+ *  an allocator only compares equal to itself.
+ * @return True if both are the same allocator, false otherwise.
+ */
+template<typename T, typename U, std::size_t N, typename UpstreamT,
+         typename UpstreamU>
+inline bool operator==
+  (const InlineAllocator<T, N, UpstreamT>& a,
+   const InlineAllocator<U, N, UpstreamU>& b) noexcept
+{
+  return static_cast<const void*>(&a) == static_cast<const void*>(&b);
+}
+
+/**
+ * @brief Non-equality operator.
+ * @return True if the allocators are different objects, false otherwise.
+ */
+template<typename T, typename U, std::size_t N, typename UpstreamT,
+         typename UpstreamU>
+inline bool operator!=
+  (const InlineAllocator<T, N, UpstreamT>& a,
+   const InlineAllocator<U, N, UpstreamU>& b) noexcept
+{
+  return !(a == b);
+}
+
+namespace detail {
+
+/**
+ * StorageTraits for an <em>InlineAllocator</em>.
+ */
+template<typename T, std::size_t N, typename Upstream>
+struct StorageTraits<InlineAllocator<T, N, Upstream>>
+  : DefaultStorage<InlineAllocator<T, N, Upstream>>
+{
+  using alloc_type = InlineAllocator<T, N, Upstream>;
+
+  static bool owns(const alloc_type& alloc, const T *ptr) noexcept
+  {
+    return alloc.owns(ptr);
+  }
+
+  static std::size_t capacity(const alloc_type& alloc, std::size_t size)
+    noexcept
+  {
+    return alloc.capacity(size);
+  }
+};
+
+} // namespace detail
+} // namespace ospp
+
+#endif /* _INLINE_ALLOCATOR_H */
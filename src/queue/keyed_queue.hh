@@ -0,0 +1,426 @@
+/**
+ * @file keyed_queue.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _KEYED_QUEUE_H
+#define _KEYED_QUEUE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+#include "queue/queue.hh"
+#include "queue/slot_table.hh"
+
+namespace ospp {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * KeyedPriorityQueue.
+ * @details A priority queue of values ordered by a separate key, where the keys
+ *  and the values are stored apart. The heap holds only each key and the index
+ *  of the slot where its value lives, so sifting moves and compares small
+ *  entries and never touches a value. The values live in a
+ *  <em>SlotTable</em>, which grows without moving them, so a value is moved
+ *  once when pushed and once when popped, and never in between.
+ *
+ *  Pays off when the values are large compared to the keys. Slots of popped
+ *  values are reused by later pushes. A popped value is released right away,
+ *  and its slot keeps a moved-from value until it is reused.
+ */
+template
+<
+  typename Key,
+  typename Value,
+  typename Compare = std::less<Key>,
+  typename Alloc = std::allocator<Value>,
+  std::size_t Arity = 2
+>
+class KeyedPriorityQueue
+{
+public:
+  /**
+   * Aliases
+   */
+  using key_type = Key;
+  using value_type = Value;
+  using allocator_type = Alloc;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+  using compare_type = Compare;
+
+  /**
+   * Initialize
+   */
+  explicit KeyedPriorityQueue();
+  explicit KeyedPriorityQueue(const compare_type& comp);
+
+  /**
+   * priority queue functionality
+   */
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  const key_type& top_key() const noexcept;
+  const_reference top() const noexcept;
+  void push(const key_type& key, const value_type& value);
+  void push(const key_type& key, value_type&& value);
+  template<typename... Args>
+  void emplace(const key_type& key, Args&&... args);
+  void pop();
+  value_type pop_value();
+  void reserve(size_type size);
+  void clear() noexcept;
+
+private:
+  /**
+   * A key and the slot of its value.
+   */
+  struct Entry
+  {
+    key_type key;
+    size_type slot;
+  };
+
+  /**
+   * Compares entries by key.
+   */
+  struct EntryCompare
+  {
+    compare_type comp;
+
+    bool operator()(const Entry& a, const Entry& b) const
+    {
+      return comp(a.key, b.key);
+    }
+  };
+
+  using alloc_traits = std::allocator_traits<Alloc>;
+  using entry_alloc = typename alloc_traits::template rebind_alloc<Entry>;
+  using slot_alloc = typename alloc_traits::template rebind_alloc<size_type>;
+  using heap_type = PriorityQueue<Entry, EntryCompare, entry_alloc, Arity>;
+
+  /**
+   * helper functions
+   */
+  template<typename... Args>
+  void store(size_type slot, Args&&... args);
+  void store(size_type slot, const value_type& value);
+  void store(size_type slot, value_type&& value);
+  size_type freeTop();
+  void reserveFree();
+
+  /**
+   * The heap of keys.
+   */
+  heap_type mHeap;
+
+  /**
+   * The values, indexed by slot.
+   */
+  SlotTable<value_type, allocator_type> mValues;
+
+  /**
+   * The free slots.
+   */
+  std::vector<size_type, slot_alloc> mFree;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Default ctor.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+KeyedPriorityQueue()
+  : mHeap(EntryCompare{compare_type()}),
+    mValues(),
+    mFree()
+{}
+
+/**
+ * @brief Constructor with one parameter.
+ * @param comp The object used to compare keys.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+KeyedPriorityQueue(const compare_type& comp)
+  : mHeap(EntryCompare{comp}),
+    mValues(),
+    mFree()
+{}
+
+/**
+ * @brief Determine if the queue is empty.
+ * @return True if the queue is empty, false otherwise.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline bool KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+empty() const noexcept
+{
+  return mHeap.empty();
+}
+
+/**
+ * @brief Get the size of the queue.
+ * @return The number of values in the queue.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline typename KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+size_type
+KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+size() const noexcept
+{
+  return mHeap.size();
+}
+
+/**
+ * @brief Get the key of the top value.
+ * @return A reference to the top key. The queue must not be empty.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline const typename
+KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::key_type&
+KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+top_key() const noexcept
+{
+  assert(!mHeap.empty());
+  return mHeap.top().key;
+}
+
+/**
+ * @brief Get the top value.
+ * @return A reference to the value with the top key. The queue must not be
+ *  empty.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline typename KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+const_reference
+KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+top() const noexcept
+{
+  assert(!mHeap.empty());
+  return mValues[mHeap.top().slot];
+}
+
+/**
+ * @brief Push a value into the queue by copying it.
+ * @param key The key of the value.
+ * @param value The value copied into the queue.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline void KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+push(const key_type& key, const value_type& value)
+{
+  emplace(key, value);
+}
+
+/**
+ * @brief Push a value into the queue by moving it.
+ * @param key The key of the value.
+ * @param value The value moved into the queue.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline void KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+push(const key_type& key, value_type&& value)
+{
+  emplace(key, std::move(value));
+}
+
+/**
+ * @brief Push a value into the queue by constructing it.
+ * @details The value goes into a free slot if there is one, or at the end of
+ *  the slot table otherwise. Only the key and the slot are sifted.
+ * @param key The key of the value.
+ * @param args The arguments used to construct the value.
+ * @throw May throw memory allocation failure, or an exception thrown while
+ *  constructing or moving the value. The queue is unchanged if an exception
+ *  is thrown.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+  template<typename... Args>
+void KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+emplace(const key_type& key, Args&&... args)
+{
+  if (!mFree.empty()) {
+    auto slot = mFree.back();
+    store(slot, std::forward<Args>(args)...);
+    mHeap.push(Entry{key, slot});
+    mFree.pop_back();
+    return;
+  }
+
+  auto slot = mValues.size();
+  mValues.emplace_back(std::forward<Args>(args)...);
+
+  try {
+    // make room for every slot to be freed, so that pop never allocates
+    reserveFree();
+    mHeap.push(Entry{key, slot});
+  }
+  catch (...) {
+    mValues.pop_back();
+    throw;
+  }
+}
+
+/**
+ * @brief Remove the top value from the queue.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline void KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+pop()
+{
+  if (mHeap.empty())
+    return;
+
+  auto slot = freeTop();
+
+  // release the resources held by the value right away
+  static_cast<void>(value_type(std::move(mValues[slot])));
+}
+
+/**
+ * @brief Remove the top value from the queue and return it.
+ * @return The top value, moved out of the queue. The queue must not be empty.
+ * @throw May throw if moving the value throws.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline typename KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+value_type
+KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+pop_value()
+{
+  assert(!mHeap.empty());
+
+  auto val = std::move(mValues[mHeap.top().slot]);
+  freeTop();
+  return val;
+}
+
+/**
+ * @brief Make room for at least <em>size</em> values.
+ * @param size The minimum capacity.
+ * @throw May throw memory allocation failure.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline void KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+reserve(size_type size)
+{
+  mHeap.reserve(size);
+  mValues.reserve(size);
+  reserveFree();
+}
+
+/**
+ * @brief Remove all the values.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline void KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+clear() noexcept
+{
+  mHeap.clear();
+  mValues.clear();
+  mFree.clear();
+}
+
+/**
+ * @brief Construct a value into a free slot.
+ * @param slot The slot.
+ * @param args The arguments used to construct the value.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+  template<typename... Args>
+inline void KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+store(size_type slot, Args&&... args)
+{
+  mValues[slot] = value_type(std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Copy a value into a free slot.
+ * @param slot The slot.
+ * @param value The value.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline void KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+store(size_type slot, const value_type& value)
+{
+  mValues[slot] = value;
+}
+
+/**
+ * @brief Move a value into a free slot.
+ * @param slot The slot.
+ * @param value The value.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline void KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+store(size_type slot, value_type&& value)
+{
+  mValues[slot] = std::move(value);
+}
+
+/**
+ * @brief Remove the top key from the heap and free the slot of its value.
+ * @details The value is left in its slot. The queue must not be empty.
+ * @return The slot.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline typename KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+size_type
+KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+freeTop()
+{
+  auto slot = mHeap.top().slot;
+  mFree.push_back(slot);
+  mHeap.pop();
+  return slot;
+}
+
+/**
+ * @brief Make room in the free list for every slot of the table.
+ * @details The free list at least doubles when it grows, since the slot table
+ *  grows a block at a time.
+ * @throw May throw memory allocation failure.
+ */
+template<typename Key, typename Value, typename Compare, typename Alloc,
+         std::size_t Arity>
+inline void KeyedPriorityQueue<Key, Value, Compare, Alloc, Arity>::
+reserveFree()
+{
+  if (mFree.capacity() < mValues.capacity())
+    mFree.reserve(std::max(mValues.capacity(), 2 * mFree.capacity()));
+}
+
+} // namespace ospp
+
+#endif /* _KEYED_QUEUE_H */
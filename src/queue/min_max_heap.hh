@@ -0,0 +1,580 @@
+/**
+ * @file min_max_heap.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _MIN_MAX_HEAP_H
+#define _MIN_MAX_HEAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+#include "traits/iter_traits.hh"
+
+namespace ospp {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * MinMaxHeap.
+ * @details A double ended priority queue stored as an implicit binary heap
+ *  whose levels alternate: a node on an even level, like the root, is the
+ *  minimum of its subtree, and a node on an odd level is the maximum. So the
+ *  minimum is the root and the maximum is one of its children, and both ends
+ *  are popped in O(log n) with one array, instead of two queues that have to
+ *  drop each other's items.
+ *
+ *  As in <em>PriorityQueue</em>, <em>Compare</em> returns true if its first
+ *  argument comes before its second: <em>min</em> is the item that a
+ *  <em>PriorityQueue</em> with the same comparator would pop first, and
+ *  <em>max</em> is the one it would pop last.
+ */
+template
+<
+  typename T,
+  typename Compare = std::less<T>,
+  typename Alloc = std::allocator<T>
+>
+class MinMaxHeap
+{
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using allocator_type = Alloc;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+  using compare_type = Compare;
+
+  /**
+   * Initialize
+   */
+  explicit MinMaxHeap();
+  explicit MinMaxHeap(const compare_type& comp);
+  explicit MinMaxHeap(const allocator_type& alloc);
+  template
+  <
+    typename InputIterator,
+    typename = typename std::enable_if<is_input_iter<InputIterator>::value>::type
+  >
+  MinMaxHeap(InputIterator first, InputIterator last,
+             const compare_type& comp = compare_type());
+
+  /**
+   * double ended priority queue functionality
+   */
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  const_reference min() const noexcept;
+  const_reference max() const noexcept;
+  void push(const value_type& value);
+  void push(value_type&& value);
+  template<typename... Args>
+  void emplace(Args&&... args);
+  void pop_min();
+  void pop_max();
+  value_type pop_min_value();
+  value_type pop_max_value();
+  size_type capacity() const noexcept;
+  void reserve(size_type size);
+  void clear() noexcept;
+  void swap(MinMaxHeap& cont) noexcept;
+
+private:
+  /**
+   * indexing functions
+   */
+  static bool isMinLevel(size_type index) noexcept;
+  size_type maxIndex() const noexcept;
+  size_type extremeBelow(size_type index, bool min) const noexcept;
+
+  /**
+   * movement functions
+   */
+  bool before(const T& a, const T& b, bool min) const;
+  void bubbleUp(size_type index);
+  size_type holeUp(size_type hole, const T& val, bool min);
+  void trickleDown(size_type index);
+  void removeAt(size_type index);
+  void heapify();
+
+  /**
+   * The items, in heap order.
+   */
+  std::vector<value_type, allocator_type> mItems;
+
+  /**
+   * The comparator.
+   */
+  compare_type mCompare;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Default ctor.
+ */
+template<typename T, typename Compare, typename Alloc>
+MinMaxHeap<T, Compare, Alloc>::
+MinMaxHeap()
+  : mItems(),
+    mCompare()
+{}
+
+/**
+ * @brief Constructor with one parameter.
+ * @param comp The object used to compare items.
+ */
+template<typename T, typename Compare, typename Alloc>
+MinMaxHeap<T, Compare, Alloc>::
+MinMaxHeap(const compare_type& comp)
+  : mItems(),
+    mCompare(comp)
+{}
+
+/**
+ * @brief Constructor with one parameter.
+ * @param alloc The allocator for the items.
+ */
+template<typename T, typename Compare, typename Alloc>
+MinMaxHeap<T, Compare, Alloc>::
+MinMaxHeap(const allocator_type& alloc)
+  : mItems(alloc),
+    mCompare()
+{}
+
+/**
+ * @brief Construct the heap from a range of items.
+ * @details The items are copied first and then arranged bottom-up, which
+ *  takes linear time.
+ * @param first Iterator to the first item.
+ * @param last Iterator to one past the last item.
+ * @param comp The object used to compare items.
+ * @throw May throw memory allocation failure, or an exception thrown by the
+ *  copy constructor of <em>T</em>.
+ */
+template<typename T, typename Compare, typename Alloc>
+  template<typename InputIterator, typename>
+MinMaxHeap<T, Compare, Alloc>::
+MinMaxHeap(InputIterator first, InputIterator last, const compare_type& comp)
+  : mItems(first, last),
+    mCompare(comp)
+{
+  heapify();
+}
+
+/**
+ * @brief Determine if the heap is empty.
+ * @return True if the heap is empty, false otherwise.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline bool MinMaxHeap<T, Compare, Alloc>::
+empty() const noexcept
+{
+  return mItems.empty();
+}
+
+/**
+ * @brief Get the size of the heap.
+ * @return The number of items in the heap.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename MinMaxHeap<T, Compare, Alloc>::size_type
+MinMaxHeap<T, Compare, Alloc>::
+size() const noexcept
+{
+  return mItems.size();
+}
+
+/**
+ * @brief Get the item that comes first.
+ * @return A reference to the root. The heap must not be empty.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename MinMaxHeap<T, Compare, Alloc>::const_reference
+MinMaxHeap<T, Compare, Alloc>::
+min() const noexcept
+{
+  assert(!mItems.empty());
+  return mItems[0];
+}
+
+/**
+ * @brief Get the item that comes last.
+ * @return A reference to the root, or to the last of its children. The heap
+ *  must not be empty.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename MinMaxHeap<T, Compare, Alloc>::const_reference
+MinMaxHeap<T, Compare, Alloc>::
+max() const noexcept
+{
+  assert(!mItems.empty());
+  return mItems[maxIndex()];
+}
+
+/**
+ * @brief Push an item into the heap by copying the value.
+ * @param value The value copied and pushed into the heap.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline void MinMaxHeap<T, Compare, Alloc>::
+push(const value_type& value)
+{
+  emplace(value);
+}
+
+/**
+ * @brief Push an item into the heap by moving it.
+ * @param value The value moved into the heap.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline void MinMaxHeap<T, Compare, Alloc>::
+push(value_type&& value)
+{
+  emplace(std::move(value));
+}
+
+/**
+ * @brief Push an item into the heap by constructing it in place.
+ * @param args The arguments used to construct the object.
+ * @throw May throw memory allocation failure, or an exception thrown while
+ *  constructing the item. The heap is unchanged if an exception is thrown.
+ */
+template<typename T, typename Compare, typename Alloc>
+  template<typename... Args>
+inline void MinMaxHeap<T, Compare, Alloc>::
+emplace(Args&&... args)
+{
+  mItems.emplace_back(std::forward<Args>(args)...);
+  bubbleUp(mItems.size() - 1);
+}
+
+/**
+ * @brief Remove the item that comes first.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline void MinMaxHeap<T, Compare, Alloc>::
+pop_min()
+{
+  if (!mItems.empty())
+    removeAt(0);
+}
+
+/**
+ * @brief Remove the item that comes last.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline void MinMaxHeap<T, Compare, Alloc>::
+pop_max()
+{
+  if (!mItems.empty())
+    removeAt(maxIndex());
+}
+
+/**
+ * @brief Remove the item that comes first and return it.
+ * @return The item, moved out of the heap. The heap must not be empty.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline T MinMaxHeap<T, Compare, Alloc>::
+pop_min_value()
+{
+  assert(!mItems.empty());
+
+  auto val = std::move(mItems[0]);
+  removeAt(0);
+  return val;
+}
+
+/**
+ * @brief Remove the item that comes last and return it.
+ * @return The item, moved out of the heap. The heap must not be empty.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline T MinMaxHeap<T, Compare, Alloc>::
+pop_max_value()
+{
+  assert(!mItems.empty());
+
+  auto index = maxIndex();
+  auto val = std::move(mItems[index]);
+  removeAt(index);
+  return val;
+}
+
+/**
+ * @return The number of items the heap can hold before it reallocates.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename MinMaxHeap<T, Compare, Alloc>::size_type
+MinMaxHeap<T, Compare, Alloc>::
+capacity() const noexcept
+{
+  return mItems.capacity();
+}
+
+/**
+ * @brief Make room for at least <em>size</em> items.
+ * @param size The minimum capacity.
+ * @throw May throw memory allocation failure.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline void MinMaxHeap<T, Compare, Alloc>::
+reserve(size_type size)
+{
+  mItems.reserve(size);
+}
+
+/**
+ * @brief Remove all the items, but keep the capacity.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline void MinMaxHeap<T, Compare, Alloc>::
+clear() noexcept
+{
+  mItems.clear();
+}
+
+/**
+ * @brief Swap the contents of two heaps.
+ * @param cont The other heap.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline void MinMaxHeap<T, Compare, Alloc>::
+swap(MinMaxHeap& cont) noexcept
+{
+  using std::swap;
+  mItems.swap(cont.mItems);
+  swap(mCompare, cont.mCompare);
+}
+
+/**
+ * @brief Determine if a node is on a min level.
+ * @details The levels alternate starting with the root, so a node is on a min
+ *  level if the number of bits of <em>index + 1</em> is odd.
+ * @param index The index of the node.
+ * @return True on a min level, false on a max level.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline bool MinMaxHeap<T, Compare, Alloc>::
+isMinLevel(size_type index) noexcept
+{
+  auto bits = static_cast<unsigned long long>(index) + 1;
+  return (__builtin_clzll(bits) & 1) != 0;
+}
+
+/**
+ * @brief Get the index of the item that comes last.
+ * @return The root if it has no children, or its last child. The heap must
+ *  not be empty.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename MinMaxHeap<T, Compare, Alloc>::size_type
+MinMaxHeap<T, Compare, Alloc>::
+maxIndex() const noexcept
+{
+  switch (mItems.size())
+  {
+  case 1:
+    return 0;
+  case 2:
+    return 1;
+  default:
+    return mCompare(mItems[1], mItems[2]) ? 2 : 1;
+  }
+}
+
+/**
+ * @brief Find the child or grandchild of a node that goes first in the order
+ *  of the level of the node.
+ * @param index The index of the node.
+ * @param min True on a min level.
+ * @return The index of the extreme descendant, or <em>index</em> if the node
+ *  is a leaf.
+ */
+template<typename T, typename Compare, typename Alloc>
+typename MinMaxHeap<T, Compare, Alloc>::size_type
+MinMaxHeap<T, Compare, Alloc>::
+extremeBelow(size_type index, bool min) const noexcept
+{
+  auto count = mItems.size();
+  auto child = 2 * index + 1;
+  if (child >= count)
+    return index;
+
+  auto best = child;
+  if (child + 1 < count && before(mItems[child + 1], mItems[best], min))
+    best = child + 1;
+
+  // the grandchildren are contiguous, after the children of the node
+  auto first = 2 * child + 1;
+  auto last = std::min(first + 4, count);
+  for (auto i = first; i < last; ++i)
+    if (before(mItems[i], mItems[best], min))
+      best = i;
+
+  return best;
+}
+
+/**
+ * @brief Compare two items in the order of a level.
+ * @param a The first item.
+ * @param b The second item.
+ * @param min True to compare in the order of a min level.
+ * @return True if <em>a</em> should be above <em>b</em> on that level.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline bool MinMaxHeap<T, Compare, Alloc>::
+before(const T& a, const T& b, bool min) const
+{
+  return min ? mCompare(a, b) : mCompare(b, a);
+}
+
+/**
+ * @brief Bubble up a new leaf to its right place.
+ * @details The leaf first moves above its parent if they are out of order,
+ *  which decides if it climbs the min levels or the max levels. Then it
+ *  climbs by grandparents, which are on the same kind of level.
+ * @param index The index of the leaf.
+ */
+template<typename T, typename Compare, typename Alloc>
+void MinMaxHeap<T, Compare, Alloc>::
+bubbleUp(size_type index)
+{
+  if (index == 0)
+    return;
+
+  auto val = std::move(mItems[index]);
+  auto min = isMinLevel(index);
+  auto parent = (index - 1) / 2;
+
+  // on a min level, the parent is a max, so a value past it climbs the max
+  // levels, and the other way around
+  if (before(mItems[parent], val, min)) {
+    mItems[index] = std::move(mItems[parent]);
+    index = holeUp(parent, val, !min);
+  }
+  else {
+    index = holeUp(index, val, min);
+  }
+
+  mItems[index] = std::move(val);
+}
+
+/**
+ * @brief Move a hole up by grandparents to where a value belongs.
+ * @param hole The index of the hole.
+ * @param val The value that will fill the hole.
+ * @param min True if the hole is on a min level.
+ * @return The index of the hole after it moved up.
+ */
+template<typename T, typename Compare, typename Alloc>
+typename MinMaxHeap<T, Compare, Alloc>::size_type
+MinMaxHeap<T, Compare, Alloc>::
+holeUp(size_type hole, const T& val, bool min)
+{
+  while (hole > 2)
+  {
+    auto grandparent = ((hole - 1) / 2 - 1) / 2;
+    if (!before(val, mItems[grandparent], min))
+      break;
+
+    mItems[hole] = std::move(mItems[grandparent]);
+    hole = grandparent;
+  }
+
+  return hole;
+}
+
+/**
+ * @brief Trickle down a node to its right place.
+ * @details The value moves down by grandchildren, which are on the same kind
+ *  of level, trading places with the parent of the grandchild when they are
+ *  out of order. It stops at a child, or when it is in order with all its
+ *  descendants.
+ * @param index The index of the node.
+ */
+template<typename T, typename Compare, typename Alloc>
+void MinMaxHeap<T, Compare, Alloc>::
+trickleDown(size_type index)
+{
+  using std::swap;
+
+  auto min = isMinLevel(index);
+  auto val = std::move(mItems[index]);
+
+  for (;;)
+  {
+    auto next = extremeBelow(index, min);
+    if (next == index || !before(mItems[next], val, min))
+      break;
+
+    mItems[index] = std::move(mItems[next]);
+    auto child = next <= 2 * index + 2;
+    index = next;
+
+    // a child is on the other kind of level, and is only picked when it has
+    // no children, or ties with them
+    if (child)
+      break;
+
+    // a grandchild may have to trade with its parent
+    auto parent = (next - 1) / 2;
+    if (before(mItems[parent], val, min))
+      swap(mItems[parent], val);
+  }
+
+  mItems[index] = std::move(val);
+}
+
+/**
+ * @brief Remove an item and fill its place with the last item.
+ * @param index The index of the item. It is the root or one of its children.
+ */
+template<typename T, typename Compare, typename Alloc>
+void MinMaxHeap<T, Compare, Alloc>::
+removeAt(size_type index)
+{
+  auto last = mItems.size() - 1;
+  if (index != last) {
+    mItems[index] = std::move(mItems[last]);
+    mItems.pop_back();
+    trickleDown(index);
+  }
+  else {
+    mItems.pop_back();
+  }
+}
+
+/**
+ * @brief Arrange all the items into a min-max heap, bottom-up.
+ * @details Every internal node is trickled down, starting from the last one,
+ *  as in Floyd's method. Takes linear time.
+ */
+template<typename T, typename Compare, typename Alloc>
+void MinMaxHeap<T, Compare, Alloc>::
+heapify()
+{
+  if (mItems.size() < 2)
+    return;
+
+  for (auto i = (mItems.size() - 2) / 2 + 1; i-- > 0;)
+    trickleDown(i);
+}
+
+} // namespace ospp
+
+#endif /* _MIN_MAX_HEAP_H */
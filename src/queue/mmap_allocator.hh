@@ -0,0 +1,331 @@
+/**
+ * @file mmap_allocator.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _MMAP_ALLOCATOR_H
+#define _MMAP_ALLOCATOR_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+
+#include <sys/mman.h>
+#include <sys/types.h>
+
+#include "queue/queue.hh"
+
+namespace ospp {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * MmapAllocator.
+ * @details Allocates each buffer as its own anonymous memory mapping, for
+ *  queues with billions of items. Buffers of at least <em>HUGE_PAGE</em>
+ *  bytes are rounded up to whole huge pages and advised to use transparent
+ *  huge pages, which cuts the TLB misses of sifting through a large heap.
+ *
+ *  A <em>PriorityQueue</em> of trivially copyable items grows its buffer with
+ *  <em>resize</em>, which on Linux calls <em>mremap</em>: the kernel moves
+ *  the page tables instead of copying the items, and the old and new buffers
+ *  never both hold the items. Other items are moved as usual.
+ *
+ *  <em>mapFile</em> maps items saved in a file copy-on-write, which is how a
+ *  queue loads a snapshot without reading it.
+ *
+ *  The allocator is stateless, and all instances compare equal.
+ */
+template<typename T>
+class MmapAllocator
+{
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  /**
+   * Page sizes.
+   */
+  enum : std::size_t
+  {
+    PAGE = 4096,
+    HUGE_PAGE = 2 * 1024 * 1024
+  };
+
+  /**
+   * Initialize
+   */
+  MmapAllocator() noexcept = default;
+  template<typename U>
+  MmapAllocator(const MmapAllocator<U>&) noexcept {}
+
+  /**
+   * allocator functionality
+   */
+  pointer allocate(size_type n);
+  void deallocate(pointer ptr, size_type n) noexcept;
+  pointer resize(pointer ptr, size_type n, size_type size);
+  pointer mapFile(int fd, off_t offset, size_type count, size_type& n);
+  size_type capacity(size_type n) const noexcept;
+  size_type max_size() const noexcept;
+
+private:
+  static size_type mappedBytes(size_type n) noexcept;
+  static void advise(void *ptr, size_type bytes) noexcept;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Allocate a buffer by mapping anonymous memory.
+ * @param n The number of items.
+ * @return A pointer to the buffer, which is page aligned and zero filled.
+ * @throw Throws std::bad_alloc if the memory cannot be mapped.
+ */
+template<typename T>
+typename MmapAllocator<T>::pointer
+MmapAllocator<T>::
+allocate(size_type n)
+{
+  if (n > max_size())
+    throw std::bad_alloc();
+
+  auto bytes = mappedBytes(n);
+  auto ptr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED)
+    throw std::bad_alloc();
+
+  advise(ptr, bytes);
+  return static_cast<pointer>(ptr);
+}
+
+/**
+ * @brief Unmap a buffer.
+ * @param ptr The buffer.
+ * @param n The number of items it was allocated for.
+ */
+template<typename T>
+inline void MmapAllocator<T>::
+deallocate(pointer ptr, size_type n) noexcept
+{
+  ::munmap(ptr, mappedBytes(n));
+}
+
+/**
+ * @brief Grow or shrink a buffer, keeping its contents as raw bytes.
+ * @details On Linux a growing mapping is resized with <em>mremap</em>, which
+ *  may move it without copying. Otherwise a new buffer is mapped and the
+ *  bytes are copied: elsewhere, when the buffer is made of more than one
+ *  mapping, like one from <em>mapFile</em>, and when it shrinks, since
+ *  shrinking in place could leave only the file mapping of such a buffer,
+ *  which <em>mremap</em> would later grow past the end of the file.
+ * @param ptr The buffer, or null to allocate a new one.
+ * @param n The number of items it was allocated for.
+ * @param size The number of items of the resized buffer.
+ * @return The resized buffer.
+ * @throw Throws std::bad_alloc if the memory cannot be mapped. The old buffer
+ *  is intact if an exception is thrown.
+ */
+template<typename T>
+typename MmapAllocator<T>::pointer
+MmapAllocator<T>::
+resize(pointer ptr, size_type n, size_type size)
+{
+  if (!ptr)
+    return allocate(size);
+
+  if (size > max_size())
+    throw std::bad_alloc();
+
+  auto oldBytes = mappedBytes(n);
+  auto bytes = mappedBytes(size);
+  if (bytes == oldBytes)
+    return ptr;
+
+#ifdef __linux__
+  if (bytes > oldBytes) {
+    auto remapped = ::mremap(ptr, oldBytes, bytes, MREMAP_MAYMOVE);
+    if (remapped != MAP_FAILED) {
+      advise(remapped, bytes);
+      return static_cast<pointer>(remapped);
+    }
+    if (errno != EFAULT)
+      throw std::bad_alloc();
+  }
+#endif
+
+  auto tmp = allocate(size);
+  std::memcpy(static_cast<void*>(tmp), static_cast<const void*>(ptr),
+              oldBytes < bytes ? oldBytes : bytes);
+  deallocate(ptr, n);
+  return tmp;
+}
+
+/**
+ * @brief Map items saved in a file as a buffer, copy-on-write.
+ * @details A buffer is allocated with room for at least one more item than
+ *  the file pages hold, and the file is mapped privately over its start, so
+ *  writes go to private copies of the pages. The rest of the buffer stays
+ *  anonymous, so the buffer is made of two mappings and <em>resize</em>
+ *  copies it instead of growing the file mapping past the end of the file.
+ * @param fd The file descriptor.
+ * @param offset Where the items start in the file. Must be page aligned.
+ * @param count The number of items.
+ * @param n Set to the number of items to deallocate the buffer with.
+ * @return The buffer, or null if the file cannot be mapped.
+ * @throw Throws std::bad_alloc if the memory cannot be mapped.
+ */
+template<typename T>
+typename MmapAllocator<T>::pointer
+MmapAllocator<T>::
+mapFile(int fd, off_t offset, size_type count, size_type& n)
+{
+  if (count > max_size())
+    throw std::bad_alloc();
+
+  auto fileBytes = (count * sizeof(T) + PAGE - 1) / PAGE * PAGE;
+  n = capacity(fileBytes / sizeof(T) + 1);
+  auto ptr = allocate(n);
+  if (count == 0)
+    return ptr;
+
+  auto mapped = ::mmap(ptr, fileBytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_FIXED, fd, offset);
+  if (mapped == MAP_FAILED) {
+    deallocate(ptr, n);
+    return nullptr;
+  }
+
+  return ptr;
+}
+
+/**
+ * @brief Get the capacity worth allocating for at least <em>n</em> items.
+ * @param n The number of items.
+ * @return The number of items that fit in the mapping for <em>n</em> items.
+ */
+template<typename T>
+inline typename MmapAllocator<T>::size_type
+MmapAllocator<T>::
+capacity(size_type n) const noexcept
+{
+  return n > max_size() ? n : mappedBytes(n) / sizeof(T);
+}
+
+/**
+ * @return The maximum number of items of a buffer.
+ */
+template<typename T>
+inline typename MmapAllocator<T>::size_type
+MmapAllocator<T>::
+max_size() const noexcept
+{
+  return (std::numeric_limits<size_type>::max() - HUGE_PAGE) / sizeof(T);
+}
+
+/**
+ * @brief Get the size of the mapping for a buffer.
+ * @param n The number of items.
+ * @return The bytes of <em>n</em> items rounded up to whole pages, or to whole
+ *  huge pages if at least one huge page. Never zero.
+ */
+template<typename T>
+inline typename MmapAllocator<T>::size_type
+MmapAllocator<T>::
+mappedBytes(size_type n) noexcept
+{
+  auto bytes = n * sizeof(T);
+  size_type page = bytes < HUGE_PAGE ? PAGE : HUGE_PAGE;
+  return bytes == 0 ? PAGE : (bytes + page - 1) / page * page;
+}
+
+/**
+ * @brief Ask for transparent huge pages, if the mapping is large enough.
+ * @param ptr The mapping.
+ * @param bytes The size of the mapping.
+ */
+template<typename T>
+inline void MmapAllocator<T>::
+advise(void *ptr, size_type bytes) noexcept
+{
+#ifdef MADV_HUGEPAGE
+  if (bytes >= HUGE_PAGE)
+    ::madvise(ptr, bytes, MADV_HUGEPAGE);
+#else
+  (void) ptr;
+  (void) bytes;
+#endif
+}
+
+/**
+ * @brief Equality operator.
+ * @return True, since any instance can deallocate any buffer.
+ */
+template<typename T, typename U>
+inline bool operator==(const MmapAllocator<T>&, const MmapAllocator<U>&)
+  noexcept
+{
+  return true;
+}
+
+/**
+ * @brief Non-equality operator.
+ * @return False.
+ */
+template<typename T, typename U>
+inline bool operator!=(const MmapAllocator<T>&, const MmapAllocator<U>&)
+  noexcept
+{
+  return false;
+}
+
+namespace detail {
+
+/**
+ * StorageTraits for an <em>MmapAllocator</em>.
+ */
+template<typename T>
+struct StorageTraits<MmapAllocator<T>> : DefaultStorage<MmapAllocator<T>>
+{
+  enum { remaps = true };
+
+  static std::size_t capacity(const MmapAllocator<T>& alloc, std::size_t size)
+    noexcept
+  {
+    return alloc.capacity(size);
+  }
+
+  static T *resize
+    (MmapAllocator<T>& alloc, T *ptr, std::size_t n, std::size_t size)
+  {
+    return alloc.resize(ptr, n, size);
+  }
+
+  static T *mapFile
+    (MmapAllocator<T>& alloc, std::FILE *file, std::size_t offset,
+     std::size_t count, std::size_t& size)
+  {
+    return alloc.mapFile(::fileno(file), static_cast<off_t>(offset), count,
+                         size);
+  }
+};
+
+} // namespace detail
+} // namespace ospp
+
+#endif /* _MMAP_ALLOCATOR_H */
@@ -0,0 +1,372 @@
+/**
+ * @file multi_queue.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _MULTI_QUEUE_H
+#define _MULTI_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include <cassert>
+
+#include "queue/queue.hh"
+
+namespace ospp {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * MultiQueue.
+ * @details A relaxed concurrent priority queue made of several
+ *  <em>PriorityQueue</em> shards, each with its own lock. A push goes to a
+ *  random shard. A pop samples two random shards and takes the better of
+ *  their tops. A pop is not guaranteed to return the best item in the whole
+ *  queue, but the expected rank of the popped item is O(number of shards).
+ *
+ *  Use about <em>c</em> shards per thread, with <em>c</em> around 2, so that
+ *  threads rarely contend for the same lock. A locked shard is skipped rather
+ *  than waited for.
+ */
+template
+<
+  typename T,
+  typename Compare = std::less<T>,
+  typename Alloc = std::allocator<T>
+>
+class MultiQueue
+{
+  /**
+   * Size of a cache line, used to keep shards on separate lines.
+   */
+  enum { CACHE_LINE = 64 };
+
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using allocator_type = Alloc;
+  using size_type = std::size_t;
+  using compare_type = Compare;
+  using queue_type = PriorityQueue<T, Compare, Alloc>;
+
+  /**
+   * Initialize
+   */
+  explicit MultiQueue
+    (size_type threads,
+     size_type factor = 2,
+     const compare_type& comp = compare_type());
+
+  MultiQueue(const MultiQueue&) = delete;
+  MultiQueue& operator=(const MultiQueue&) = delete;
+
+  /**
+   * priority queue functionality
+   */
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type shards() const noexcept;
+  void push(const value_type& value);
+  void push(value_type&& value);
+  template<typename... Args>
+  void emplace(Args&&... args);
+  bool try_pop(value_type& value);
+
+private:
+  /**
+   * A priority queue with its lock. The size is kept outside the lock, so
+   * that empty shards can be skipped without locking them.
+   */
+  struct Shard
+  {
+    std::mutex lock;
+    queue_type queue;
+    std::atomic<size_type> count;
+    char pad[CACHE_LINE];
+
+    explicit Shard(const compare_type& comp)
+      : lock(), queue(comp), count(0), pad() {}
+  };
+
+  /**
+   * helper functions
+   */
+  static std::minstd_rand& engine();
+  size_type randomShard() noexcept;
+  bool popFrom(Shard& shard, value_type& value);
+  bool popBest(Shard& a, Shard& b, value_type& value);
+
+  /**
+   * The shards.
+   */
+  std::unique_ptr<std::unique_ptr<Shard>[]> mShards;
+
+  /**
+   * The number of shards.
+   */
+  size_type mCount;
+
+  /**
+   * The comparator.
+   */
+  compare_type mCompare;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Constructor.
+ * @param threads The number of threads that will use the queue.
+ * @param factor The number of shards per thread.
+ * @param comp The object used to compare items.
+ * @throw May throw memory allocation failure.
+ */
+template<typename T, typename Compare, typename Alloc>
+MultiQueue<T, Compare, Alloc>::
+MultiQueue(size_type threads, size_type factor, const compare_type& comp)
+  : mShards(),
+    mCount(threads * factor < 2 ? 2 : threads * factor),
+    mCompare(comp)
+{
+  mShards.reset(new std::unique_ptr<Shard>[mCount]);
+  for (size_type i = 0; i < mCount; ++i)
+    mShards[i].reset(new Shard(comp));
+}
+
+/**
+ * @brief Determine if the queue is empty.
+ * @details The answer may be stale by the time it is returned if other threads
+ *  use the queue.
+ * @return True if all the shards are empty, false otherwise.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline bool MultiQueue<T, Compare, Alloc>::
+empty() const noexcept
+{
+  return size() == 0;
+}
+
+/**
+ * @brief Get the size of the queue.
+ * @details The answer may be stale by the time it is returned if other threads
+ *  use the queue.
+ * @return The number of items in all the shards.
+ */
+template<typename T, typename Compare, typename Alloc>
+typename MultiQueue<T, Compare, Alloc>::size_type
+MultiQueue<T, Compare, Alloc>::
+size() const noexcept
+{
+  size_type n = 0;
+  for (size_type i = 0; i < mCount; ++i)
+    n += mShards[i]->count.load(std::memory_order_relaxed);
+
+  return n;
+}
+
+/**
+ * @brief Get the number of shards.
+ * @return The number of shards.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename MultiQueue<T, Compare, Alloc>::size_type
+MultiQueue<T, Compare, Alloc>::
+shards() const noexcept
+{
+  return mCount;
+}
+
+/**
+ * @brief Push an item into the queue by copying the value.
+ * @param value The value copied and pushed into the queue.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline void MultiQueue<T, Compare, Alloc>::
+push(const value_type& value)
+{
+  emplace(value);
+}
+
+/**
+ * @brief Push an item into the queue by moving it.
+ * @param value The value moved into the queue.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline void MultiQueue<T, Compare, Alloc>::
+push(value_type&& value)
+{
+  emplace(std::move(value));
+}
+
+/**
+ * @brief Push an item into a random shard by constructing it in place.
+ * @details Shards that are locked by other threads are skipped.
+ * @param args The arguments used to construct the object.
+ * @throw May throw memory allocation failure, or an exception thrown while
+ *  constructing the item.
+ */
+template<typename T, typename Compare, typename Alloc>
+  template<typename... Args>
+void MultiQueue<T, Compare, Alloc>::
+emplace(Args&&... args)
+{
+  for (;;)
+  {
+    auto& shard = *mShards[randomShard()];
+    std::unique_lock<std::mutex> guard(shard.lock, std::try_to_lock);
+    if (!guard.owns_lock())
+      continue;
+
+    shard.queue.emplace(std::forward<Args>(args)...);
+    shard.count.store(shard.queue.size(), std::memory_order_relaxed);
+    return;
+  }
+}
+
+/**
+ * @brief Pop the better of the tops of two random shards.
+ * @details If both sampled shards look empty, every shard is tried in turn
+ *  before giving up, so false is only returned when the queue looked empty.
+ * @param value Set to the popped item, if any.
+ * @return True if an item was popped, false if the queue was empty.
+ * @throw May throw if moving <em>T</em> throws.
+ */
+template<typename T, typename Compare, typename Alloc>
+bool MultiQueue<T, Compare, Alloc>::
+try_pop(value_type& value)
+{
+  for (int attempt = 0; attempt < 4; ++attempt)
+  {
+    auto i = randomShard();
+    auto j = randomShard();
+    if (i == j)
+      j = (j + 1) % mCount;
+
+    auto& a = *mShards[i];
+    auto& b = *mShards[j];
+    auto emptyA = a.count.load(std::memory_order_relaxed) == 0;
+    auto emptyB = b.count.load(std::memory_order_relaxed) == 0;
+
+    if (emptyA && emptyB)
+      break;
+
+    if (emptyA ? popFrom(b, value)
+        : emptyB ? popFrom(a, value)
+        : popBest(a, b, value))
+      return true;
+  }
+
+  // the sampled shards were empty or busy, so look at all of them
+  auto start = randomShard();
+  for (size_type k = 0; k < mCount; ++k)
+  {
+    auto& shard = *mShards[(start + k) % mCount];
+    if (shard.count.load(std::memory_order_relaxed) == 0)
+      continue;
+
+    std::lock_guard<std::mutex> guard(shard.lock);
+    if (shard.queue.empty())
+      continue;
+
+    value = shard.queue.pop_value();
+    shard.count.store(shard.queue.size(), std::memory_order_relaxed);
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Get the random engine of the calling thread.
+ * @return The random engine.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline std::minstd_rand& MultiQueue<T, Compare, Alloc>::
+engine()
+{
+  static thread_local std::minstd_rand rand(static_cast<unsigned>(
+    std::hash<std::thread::id>()(std::this_thread::get_id())));
+  return rand;
+}
+
+/**
+ * @brief Pick a random shard.
+ * @return The index of the shard.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename MultiQueue<T, Compare, Alloc>::size_type
+MultiQueue<T, Compare, Alloc>::
+randomShard() noexcept
+{
+  return static_cast<size_type>(engine()()) % mCount;
+}
+
+/**
+ * @brief Pop the top of one shard, unless it is locked or empty.
+ * @param shard The shard.
+ * @param value Set to the popped item, if any.
+ * @return True if an item was popped.
+ */
+template<typename T, typename Compare, typename Alloc>
+bool MultiQueue<T, Compare, Alloc>::
+popFrom(Shard& shard, value_type& value)
+{
+  std::unique_lock<std::mutex> guard(shard.lock, std::try_to_lock);
+  if (!guard.owns_lock() || shard.queue.empty())
+    return false;
+
+  value = shard.queue.pop_value();
+  shard.count.store(shard.queue.size(), std::memory_order_relaxed);
+  return true;
+}
+
+/**
+ * @brief Pop the better of the tops of two shards, unless either is locked.
+ * @param a The first shard.
+ * @param b The second shard.
+ * @param value Set to the popped item, if any.
+ * @return True if an item was popped.
+ */
+template<typename T, typename Compare, typename Alloc>
+bool MultiQueue<T, Compare, Alloc>::
+popBest(Shard& a, Shard& b, value_type& value)
+{
+  std::unique_lock<std::mutex> guardA(a.lock, std::try_to_lock);
+  if (!guardA.owns_lock())
+    return false;
+
+  std::unique_lock<std::mutex> guardB(b.lock, std::try_to_lock);
+  if (!guardB.owns_lock())
+    return false;
+
+  Shard *best;
+  if (a.queue.empty())
+    best = &b;
+  else if (b.queue.empty())
+    best = &a;
+  else
+    best = mCompare(b.queue.top(), a.queue.top()) ? &b : &a;
+
+  if (best->queue.empty())
+    return false;
+
+  value = best->queue.pop_value();
+  best->count.store(best->queue.size(), std::memory_order_relaxed);
+  return true;
+}
+
+} // namespace ospp
+
+#endif /* _MULTI_QUEUE_H */
@@ -0,0 +1,543 @@
+/**
+ * @file pairing_heap.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _PAIRING_HEAP_H
+#define _PAIRING_HEAP_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+namespace ospp {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * PairingHeap.
+ * @details A priority queue stored as a heap ordered tree, where each node
+ *  keeps its first child and its next sibling. Push and merge link two trees
+ *  in O(1), by making the root that should be below a child of the other.
+ *  Pop removes the root and links its children in two passes: first in pairs
+ *  from left to right, then the pairs from right to left, which costs
+ *  O(log n) amortized.
+ *
+ *  Prefer <em>PriorityQueue</em> unless queues are merged often: every item is
+ *  a separate allocation, and following child pointers is slower than walking
+ *  an implicit heap.
+ */
+template
+<
+  typename T,
+  typename Compare = std::less<T>,
+  typename Alloc = std::allocator<T>
+>
+class PairingHeap
+{
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using allocator_type = Alloc;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+  using compare_type = Compare;
+
+  /**
+   * Initialize
+   */
+  explicit PairingHeap();
+  explicit PairingHeap(const compare_type& comp);
+  explicit PairingHeap(const allocator_type& alloc);
+
+  /**
+   * Copy Construct
+   */
+  PairingHeap(const PairingHeap& cont);
+  PairingHeap(PairingHeap&& cont) noexcept;
+
+  /**
+   * Assignment
+   */
+  PairingHeap& operator=(const PairingHeap& cont);
+  PairingHeap& operator=(PairingHeap&& cont) noexcept;
+
+  /**
+   * Destructor
+   */
+  ~PairingHeap() noexcept;
+
+  /**
+   * priority queue functionality
+   */
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  const_reference top() const noexcept;
+  void push(const value_type& value);
+  void push(value_type&& value);
+  template<typename... Args>
+  void emplace(Args&&... args);
+  void pop();
+  value_type pop_value();
+  void merge(PairingHeap&& other) noexcept;
+  void clear() noexcept;
+  void swap(PairingHeap& cont) noexcept;
+
+private:
+  /**
+   * A node of the tree. The children of a node are a list linked through
+   * <em>sibling</em>.
+   */
+  struct Node
+  {
+    value_type value;
+    Node *child;
+    Node *sibling;
+
+    template<typename... Args>
+    Node(Args&&... args)
+      : value(std::forward<Args>(args)...), child(), sibling() {}
+  };
+
+  using alloc_traits = std::allocator_traits<Alloc>;
+  using node_alloc = typename alloc_traits::template rebind_alloc<Node>;
+  using node_traits = std::allocator_traits<node_alloc>;
+
+  /**
+   * helper functions
+   */
+  Node* link(Node *a, Node *b) noexcept;
+  Node* combine(Node *first) noexcept;
+  void copyFrom(const PairingHeap& cont);
+
+  /**
+   * The root of the tree, or null if empty.
+   */
+  Node *mRoot;
+
+  /**
+   * The allocator for the nodes.
+   */
+  node_alloc mAlloc;
+
+  /**
+   * The comparator.
+   */
+  compare_type mCompare;
+
+  /**
+   * The number of items held by the heap.
+   */
+  size_type mCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Default ctor.
+ */
+template<typename T, typename Compare, typename Alloc>
+PairingHeap<T, Compare, Alloc>::
+PairingHeap()
+  : mRoot(),
+    mAlloc(),
+    mCompare(),
+    mCount()
+{}
+
+/**
+ * @brief Constructor with one parameter.
+ * @param comp The object used to compare items.
+ */
+template<typename T, typename Compare, typename Alloc>
+PairingHeap<T, Compare, Alloc>::
+PairingHeap(const compare_type& comp)
+  : mRoot(),
+    mAlloc(),
+    mCompare(comp),
+    mCount()
+{}
+
+/**
+ * @brief Constructor with one parameter.
+ * @param alloc The allocator for the nodes.
+ */
+template<typename T, typename Compare, typename Alloc>
+PairingHeap<T, Compare, Alloc>::
+PairingHeap(const allocator_type& alloc)
+  : mRoot(),
+    mAlloc(alloc),
+    mCompare(),
+    mCount()
+{}
+
+/**
+ * @brief Copy constructor.
+ * @param cont The heap being copied.
+ * @throw May throw memory allocation failure, or an exception thrown by the
+ *  copy constructor of <em>T</em>.
+ */
+template<typename T, typename Compare, typename Alloc>
+PairingHeap<T, Compare, Alloc>::
+PairingHeap(const PairingHeap& cont)
+  : mRoot(),
+    mAlloc(node_traits::select_on_container_copy_construction(cont.mAlloc)),
+    mCompare(cont.mCompare),
+    mCount()
+{
+  copyFrom(cont);
+}
+
+/**
+ * @brief Move constructor.
+ * @param cont The heap being moved, which is left empty.
+ */
+template<typename T, typename Compare, typename Alloc>
+PairingHeap<T, Compare, Alloc>::
+PairingHeap(PairingHeap&& cont) noexcept
+  : mRoot(cont.mRoot),
+    mAlloc(std::move(cont.mAlloc)),
+    mCompare(std::move(cont.mCompare)),
+    mCount(cont.mCount)
+{
+  cont.mRoot = nullptr;
+  cont.mCount = 0;
+}
+
+/**
+ * @brief Copy assignment.
+ * @param cont The heap being copied.
+ * @return A reference to this heap.
+ * @throw Same as the copy constructor. The heap is unchanged if an exception
+ *  is thrown.
+ */
+template<typename T, typename Compare, typename Alloc>
+PairingHeap<T, Compare, Alloc>&
+PairingHeap<T, Compare, Alloc>::
+operator=(const PairingHeap& cont)
+{
+  if (this != &cont) {
+    PairingHeap tmp(cont);
+    swap(tmp);
+  }
+
+  return *this;
+}
+
+/**
+ * @brief Move assignment.
+ * @param cont The heap being moved.
+ * @return A reference to this heap.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline PairingHeap<T, Compare, Alloc>&
+PairingHeap<T, Compare, Alloc>::
+operator=(PairingHeap&& cont) noexcept
+{
+  swap(cont);
+  return *this;
+}
+
+/**
+ * @brief Destructor.
+ */
+template<typename T, typename Compare, typename Alloc>
+PairingHeap<T, Compare, Alloc>::
+~PairingHeap() noexcept
+{
+  clear();
+}
+
+/**
+ * @brief Determine if the heap is empty.
+ * @return True if the heap is empty, false otherwise.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline bool PairingHeap<T, Compare, Alloc>::
+empty() const noexcept
+{
+  return mCount == 0;
+}
+
+/**
+ * @brief Get the size of the heap.
+ * @return The number of items in the heap.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename PairingHeap<T, Compare, Alloc>::size_type
+PairingHeap<T, Compare, Alloc>::
+size() const noexcept
+{
+  return mCount;
+}
+
+/**
+ * @brief Get the top value.
+ * @return A reference to the top value. The heap must not be empty.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename PairingHeap<T, Compare, Alloc>::const_reference
+PairingHeap<T, Compare, Alloc>::
+top() const noexcept
+{
+  assert(mRoot);
+  return mRoot->value;
+}
+
+/**
+ * @brief Push an item into the heap by copying the value.
+ * @param value The value copied and pushed into the heap.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline void PairingHeap<T, Compare, Alloc>::
+push(const value_type& value)
+{
+  emplace(value);
+}
+
+/**
+ * @brief Push an item into the heap by moving it.
+ * @param value The value moved into the heap.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline void PairingHeap<T, Compare, Alloc>::
+push(value_type&& value)
+{
+  emplace(std::move(value));
+}
+
+/**
+ * @brief Push an item into the heap by constructing it in place.
+ * @param args The arguments used to construct the object.
+ * @throw May throw memory allocation failure, or an exception thrown while
+ *  constructing the item. The heap is unchanged if an exception is thrown.
+ */
+template<typename T, typename Compare, typename Alloc>
+  template<typename... Args>
+void PairingHeap<T, Compare, Alloc>::
+emplace(Args&&... args)
+{
+  auto node = node_traits::allocate(mAlloc, 1);
+
+  try {
+    node_traits::construct(mAlloc, node, std::forward<Args>(args)...);
+  }
+  catch (...) {
+    node_traits::deallocate(mAlloc, node, 1);
+    throw;
+  }
+
+  mRoot = mRoot ? link(mRoot, node) : node;
+  ++mCount;
+}
+
+/**
+ * @brief Remove the top value from the heap.
+ */
+template<typename T, typename Compare, typename Alloc>
+void PairingHeap<T, Compare, Alloc>::
+pop()
+{
+  if (mCount == 0)
+    return;
+
+  auto root = mRoot;
+  mRoot = combine(root->child);
+  --mCount;
+
+  node_traits::destroy(mAlloc, root);
+  node_traits::deallocate(mAlloc, root, 1);
+}
+
+/**
+ * @brief Remove the top value from the heap and return it.
+ * @return The top value, moved out of the heap. The heap must not be empty.
+ * @throw May throw if moving <em>T</em> throws.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline T PairingHeap<T, Compare, Alloc>::
+pop_value()
+{
+  assert(mCount > 0);
+
+  auto val = std::move(mRoot->value);
+  pop();
+  return val;
+}
+
+/**
+ * @brief Move all the items of another heap into this one.
+ * @details The two roots are linked, so merging takes constant time and no
+ *  item is moved. The allocators of both heaps must compare equal.
+ * @param other The heap merged into this one, which is left empty.
+ */
+template<typename T, typename Compare, typename Alloc>
+void PairingHeap<T, Compare, Alloc>::
+merge(PairingHeap&& other) noexcept
+{
+  if (this == &other || !other.mRoot)
+    return;
+
+  assert(mAlloc == other.mAlloc);
+
+  mRoot = mRoot ? link(mRoot, other.mRoot) : other.mRoot;
+  mCount += other.mCount;
+  other.mRoot = nullptr;
+  other.mCount = 0;
+}
+
+/**
+ * @brief Remove all the items.
+ * @details The tree is taken apart with rotations, so no stack is needed no
+ *  matter how deep it is.
+ */
+template<typename T, typename Compare, typename Alloc>
+void PairingHeap<T, Compare, Alloc>::
+clear() noexcept
+{
+  auto node = mRoot;
+
+  while (node)
+  {
+    // lift the first child above the node until the node has no children
+    if (node->child) {
+      auto child = node->child;
+      node->child = child->sibling;
+      child->sibling = node;
+      node = child;
+      continue;
+    }
+
+    auto next = node->sibling;
+    node_traits::destroy(mAlloc, node);
+    node_traits::deallocate(mAlloc, node, 1);
+    node = next;
+  }
+
+  mRoot = nullptr;
+  mCount = 0;
+}
+
+/**
+ * @brief Swap the contents of two heaps.
+ * @param cont The other heap.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline void PairingHeap<T, Compare, Alloc>::
+swap(PairingHeap& cont) noexcept
+{
+  using std::swap;
+  swap(mRoot, cont.mRoot);
+  swap(mAlloc, cont.mAlloc);
+  swap(mCompare, cont.mCompare);
+  swap(mCount, cont.mCount);
+}
+
+/**
+ * @brief Link two trees, making the root that should be below the first
+ *  child of the other.
+ * @param a The root of a tree without siblings.
+ * @param b The root of a tree without siblings.
+ * @return The root of the linked tree.
+ */
+template<typename T, typename Compare, typename Alloc>
+inline typename PairingHeap<T, Compare, Alloc>::Node*
+PairingHeap<T, Compare, Alloc>::
+link(Node *a, Node *b) noexcept
+{
+  if (mCompare(b->value, a->value))
+    std::swap(a, b);
+
+  b->sibling = a->child;
+  a->child = b;
+  return a;
+}
+
+/**
+ * @brief Link a list of sibling trees into one tree, in two passes.
+ * @details The first pass links the trees in pairs from left to right and
+ *  stacks the results. The second pass pops the stack, so the pairs are
+ *  linked from right to left.
+ * @param first The first tree of the list, or null.
+ * @return The root of the linked tree, or null if the list was empty.
+ */
+template<typename T, typename Compare, typename Alloc>
+typename PairingHeap<T, Compare, Alloc>::Node*
+PairingHeap<T, Compare, Alloc>::
+combine(Node *first) noexcept
+{
+  Node *stack = nullptr;
+
+  while (first)
+  {
+    auto a = first;
+    auto b = a->sibling;
+    if (!b) {
+      a->sibling = stack;
+      stack = a;
+      break;
+    }
+
+    first = b->sibling;
+    a->sibling = b->sibling = nullptr;
+    auto pair = link(a, b);
+    pair->sibling = stack;
+    stack = pair;
+  }
+
+  Node *root = nullptr;
+  while (stack)
+  {
+    auto next = stack->sibling;
+    stack->sibling = nullptr;
+    root = root ? link(stack, root) : stack;
+    stack = next;
+  }
+
+  return root;
+}
+
+/**
+ * @brief Push a copy of every item of another heap.
+ * @param cont The heap being copied.
+ * @throw May throw memory allocation failure, or an exception thrown by the
+ *  copy constructor of <em>T</em>. The items copied so far are released.
+ */
+template<typename T, typename Compare, typename Alloc>
+void PairingHeap<T, Compare, Alloc>::
+copyFrom(const PairingHeap& cont)
+{
+  std::vector<const Node*> pending;
+  if (cont.mRoot)
+    pending.push_back(cont.mRoot);
+
+  try {
+    while (!pending.empty())
+    {
+      auto node = pending.back();
+      pending.pop_back();
+      push(node->value);
+
+      for (auto child = node->child; child; child = child->sibling)
+        pending.push_back(child);
+    }
+  }
+  catch (...) {
+    clear();
+    throw;
+  }
+}
+
+} // namespace ospp
+
+#endif /* _PAIRING_HEAP_H */
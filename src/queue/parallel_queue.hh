@@ -0,0 +1,412 @@
+/**
+ * @file parallel_queue.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _PARALLEL_QUEUE_H
+#define _PARALLEL_QUEUE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "queue/queue.hh"
+#include "queue/worker_pool.hh"
+
+namespace ospp {
+
+/**
+ * parallel functionality
+ */
+template<typename Queue, typename InputIterator>
+Queue parallel_build
+  (InputIterator first, InputIterator last, std::size_t threads);
+template<typename Queue, typename OutputIterator>
+OutputIterator parallel_drain_sorted
+  (Queue& pq, OutputIterator out, std::size_t threads);
+
+namespace detail {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * ParallelQueue.
+ * @details Builds and drains a <em>PriorityQueue</em> on the threads of a
+ *  <em>WorkerPool</em>. Kept apart from the queue, so that only the code that
+ *  uses threads pays for including them.
+ */
+template<typename Queue>
+class ParallelQueue
+{
+public:
+  /**
+   * Aliases
+   */
+  using value_type = typename Queue::value_type;
+  using size_type = typename Queue::size_type;
+  using pointer = typename Queue::pointer;
+  using const_pointer = typename Queue::const_pointer;
+
+  /**
+   * parallel functionality
+   */
+  template<typename InputIterator>
+  static Queue build
+    (InputIterator first, InputIterator last, size_type threads);
+  template<typename OutputIterator>
+  static OutputIterator drainSorted
+    (Queue& pq, OutputIterator out, size_type threads);
+
+private:
+  using alloc_traits = typename Queue::alloc_traits;
+
+  /**
+   * The heap is built on several threads only if the nodes of a level are
+   * contiguous, and items are sorted on several threads only if moving them
+   * cannot throw. Neither happens with counters, which are not thread safe.
+   */
+  enum
+  {
+    PARALLEL_HEAPIFY =
+      std::is_same<typename Queue::layout_type, FlatLayout>::value &&
+      std::is_same<typename Queue::stats_type, NoStats>::value,
+    PARALLEL_SORT =
+      std::is_same<typename Queue::stats_type, NoStats>::value &&
+      std::is_nothrow_move_constructible<value_type>::value &&
+      std::is_nothrow_move_assignable<value_type>::value
+  };
+
+  /**
+   * Below this many items, the work is done on the calling thread.
+   */
+  enum { PARALLEL_MIN_SIZE = 1 << 14 };
+
+  /**
+   * helper functions
+   */
+  static void heapify(Queue& pq, WorkerPool& pool) noexcept;
+  template<typename OutputIterator>
+  static OutputIterator drain(Queue& pq, OutputIterator out, WorkerPool& pool);
+  static size_type mergeSplit
+    (const Queue& pq, size_type k, const_pointer a, size_type m,
+     const_pointer b, size_type n) noexcept;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Build a queue from a range on several threads.
+ * @details The items are appended on the calling thread, and then the heap is
+ *  built bottom-up one level at a time, from the last parents to the root.
+ *  The nodes of a level have disjoint subtrees, so each level is split among
+ *  the threads, and a level starts once the one below it is done. The heap is
+ *  built on the calling thread if it is small, if it has a B-heap layout, or
+ *  if the queue counts its work.
+ * @param first The iterator to the beginning of the range.
+ * @param last One past the last iterator.
+ * @param threads The number of threads, counting the calling thread.
+ * @return The queue.
+ * @throw May throw memory allocation failure, an exception thrown while
+ *  constructing an item, or std::system_error if a thread cannot be started.
+ */
+template<typename Queue>
+  template<typename InputIterator>
+Queue ParallelQueue<Queue>::
+build(InputIterator first, InputIterator last, size_type threads)
+{
+  using category =
+    typename std::iterator_traits<InputIterator>::iterator_category;
+
+  Queue pq;
+  pq.appendRange(first, last, category());
+
+  if (PARALLEL_HEAPIFY && threads > 1 && pq.mCount >= PARALLEL_MIN_SIZE) {
+    WorkerPool pool(threads);
+    heapify(pq, pool);
+  }
+  else {
+    pq.heapify();
+  }
+
+  return pq;
+}
+
+/**
+ * @brief Move all the items out in the order they would be popped, sorting
+ *  them on several threads.
+ * @details Each thread sorts an equal share of the items, and then the sorted
+ *  runs are merged in pairs, with each merge split among the threads, until
+ *  one run is left. Uses a second buffer as large as the queue. The items are
+ *  drained on the calling thread if the queue is small, if moving an item may
+ *  throw, or if the queue counts its work. The queue is left empty, but keeps
+ *  its capacity.
+ * @param pq The queue.
+ * @param out The output iterator.
+ * @param threads The number of threads, counting the calling thread.
+ * @return The output iterator past the last item written.
+ * @throw May throw memory allocation failure or std::system_error before any
+ *  item is moved, in which case the queue is unchanged. If writing to the
+ *  output throws, the items not yet written are destroyed.
+ */
+template<typename Queue>
+  template<typename OutputIterator>
+OutputIterator ParallelQueue<Queue>::
+drainSorted(Queue& pq, OutputIterator out, size_type threads)
+{
+  if (!PARALLEL_SORT || threads < 2 || pq.mCount < PARALLEL_MIN_SIZE)
+    return pq.drain_sorted(out);
+
+  WorkerPool pool(threads);
+  return drain(pq, out, pool);
+}
+
+/**
+ * @brief Arrange all the items into a flat heap bottom-up, one level at a
+ *  time, on the threads of a pool.
+ * @details The nodes of a level are contiguous and their subtrees are
+ *  disjoint, so each level is cut into slices that are bubbled down at the
+ *  same time. The levels near the root have few nodes, and run on fewer
+ *  threads.
+ * @param pq The queue.
+ * @param pool The threads.
+ * @throw Never throws.
+ */
+template<typename Queue>
+void ParallelQueue<Queue>::
+heapify(Queue& pq, WorkerPool& pool) noexcept
+{
+  static_assert(std::is_same<typename Queue::layout_type, FlatLayout>::value,
+                "levels are only contiguous in a flat heap");
+
+  if (pq.mCount < 2)
+    return;
+
+  // the first node of each level, down to the level of the last parent
+  size_type starts[std::numeric_limits<size_type>::digits + 1];
+  size_type levels = 0;
+  auto last = pq.lastParent();
+  for (size_type first = 0, width = 1; first <= last; width *= Queue::arity)
+  {
+    starts[levels++] = first;
+    first += width;
+  }
+
+  while (levels-- > 0)
+  {
+    auto begin = starts[levels];
+    auto nodes = std::min(last + 1 - begin, begin * (Queue::arity - 1) + 1);
+    auto slices = std::min(nodes, 4 * pool.threads());
+
+    pool.run(slices, [&](size_type slice) {
+      auto from = begin + nodes * slice / slices;
+      for (auto i = begin + nodes * (slice + 1) / slices; i-- > from;)
+        pq.bubbleDown(i);
+    });
+  }
+}
+
+/**
+ * @brief Move all the items out in the order they would be popped, sorting
+ *  them on the threads of a pool.
+ * @details The items are moved into a second buffer in runs, one per thread,
+ *  and each run is sorted there. Pairs of runs are then merged back and forth
+ *  between the buffers until one run is left. Each merge is cut into pieces
+ *  of the same size, so that the last merges still use all the threads. The
+ *  pieces are found before any item is merged, since finding them reads items
+ *  that the other pieces move.
+ * @param pq The queue.
+ * @param out The output iterator.
+ * @param pool The threads.
+ * @return The output iterator past the last item written.
+ * @throw May throw memory allocation failure before any item is moved, in
+ *  which case the queue is unchanged. If writing to the output throws, the
+ *  items not yet written are destroyed.
+ */
+template<typename Queue>
+  template<typename OutputIterator>
+OutputIterator ParallelQueue<Queue>::
+drain(Queue& pq, OutputIterator out, WorkerPool& pool)
+{
+  auto count = pq.mCount;
+  auto runs = pool.threads();
+
+  // the bounds of the runs, and where each piece of a merge starts in the
+  // first run of the pair
+  std::vector<size_type> edges(runs + 1);
+  for (size_type r = 0; r <= runs; ++r)
+    edges[r] = count / runs * r + std::min(r, count % runs);
+  std::vector<size_type> splits(2 * runs);
+
+  auto buffer = alloc_traits::allocate(pq.mAlloc, count);
+  auto before = [&pq](const value_type& a, const value_type& b) {
+    return pq.compare(a, b);
+  };
+
+  pool.run(runs, [&](size_type r) {
+    for (auto i = edges[r]; i < edges[r + 1]; ++i)
+      alloc_traits::construct(pq.mAlloc, buffer + i, std::move(pq.mPtr[i]));
+    std::sort(buffer + edges[r], buffer + edges[r + 1], before);
+  });
+
+  auto src = buffer;
+  auto dst = pq.mPtr;
+  while (runs > 1)
+  {
+    auto pairs = runs / 2;
+    auto pieces = std::max<size_type>(1, pool.threads() / pairs);
+
+    // piece k of pair p takes the items between offset(p, k) and
+    // offset(p, k + 1) of the merge
+    auto offset = [&](size_type p, size_type k) {
+      return (edges[2 * p + 2] - edges[2 * p]) * k / pieces;
+    };
+
+    pool.run(pairs * (pieces + 1), [&](size_type task) {
+      auto p = task / (pieces + 1);
+      auto first = edges[2 * p];
+      auto middle = edges[2 * p + 1];
+      splits[task] = mergeSplit(pq, offset(p, task % (pieces + 1)),
+                                src + first, middle - first,
+                                src + middle, edges[2 * p + 2] - middle);
+    });
+
+    pool.run(pairs * pieces + runs % 2, [&](size_type task) {
+      // an odd run out is moved over as it is
+      if (task == pairs * pieces) {
+        auto first = edges[runs - 1];
+        std::move(src + first, src + edges[runs], dst + first);
+        return;
+      }
+
+      auto p = task / pieces;
+      auto k = task % pieces;
+      auto first = edges[2 * p];
+      auto middle = edges[2 * p + 1];
+      auto from = offset(p, k);
+      auto to = offset(p, k + 1);
+      auto i = splits[p * (pieces + 1) + k];
+      auto j = splits[p * (pieces + 1) + k + 1];
+
+      std::merge(std::make_move_iterator(src + first + i),
+                 std::make_move_iterator(src + first + j),
+                 std::make_move_iterator(src + middle + from - i),
+                 std::make_move_iterator(src + middle + to - j),
+                 dst + first + from, before);
+    });
+
+    for (size_type r = 1; r < (runs + 1) / 2; ++r)
+      edges[r] = edges[2 * r];
+    edges[(runs + 1) / 2] = edges[runs];
+    runs = (runs + 1) / 2;
+    std::swap(src, dst);
+  }
+
+  try {
+    for (size_type i = 0; i < count; ++i)
+    {
+      *out = std::move(src[i]);
+      ++out;
+    }
+  }
+  catch (...) {
+    for (size_type i = 0; i < count; ++i)
+      alloc_traits::destroy(pq.mAlloc, buffer + i);
+    alloc_traits::deallocate(pq.mAlloc, buffer, count);
+    pq.destroyAll();
+    throw;
+  }
+
+  for (size_type i = 0; i < count; ++i)
+    alloc_traits::destroy(pq.mAlloc, buffer + i);
+  alloc_traits::deallocate(pq.mAlloc, buffer, count);
+  pq.destroyAll();
+  return out;
+}
+
+/**
+ * @brief Find how many items of the first of two sorted runs come before the
+ *  <em>k</em>th item of their merge.
+ * @details Items of the first run go first on ties, like in std::merge. Takes
+ *  a binary search.
+ * @param pq The queue, which compares the items.
+ * @param k The number of items of the merge.
+ * @param a The first run.
+ * @param m The size of the first run.
+ * @param b The second run.
+ * @param n The size of the second run.
+ * @return The number of items taken from the first run; the other
+ *  <em>k - i</em> are taken from the second one.
+ * @throw Never throws.
+ */
+template<typename Queue>
+typename ParallelQueue<Queue>::size_type
+ParallelQueue<Queue>::
+mergeSplit
+  (const Queue& pq, size_type k, const_pointer a, size_type m,
+   const_pointer b, size_type n) noexcept
+{
+  auto low = k > n ? k - n : 0;
+  auto high = std::min(k, m);
+
+  // too many items of the first run are taken if its last one taken should
+  // come after the first item of the second run that is left
+  while (low < high)
+  {
+    auto i = low + (high - low + 1) / 2;
+    if (pq.compare(b[k - i], a[i - 1]))
+      high = i - 1;
+    else
+      low = i;
+  }
+
+  return low;
+}
+
+} // namespace detail
+
+/**
+ * @brief Build a queue from a range, arranging the heap on several threads.
+ * @details Gives the same heap as the range constructor of <em>Queue</em>.
+ * @param first The iterator to the beginning of the range.
+ * @param last One past the last iterator.
+ * @param threads The number of threads, counting the calling thread.
+ * @return The queue.
+ * @throw May throw memory allocation failure, an exception thrown while
+ *  constructing an item, or std::system_error if a thread cannot be started.
+ */
+template<typename Queue, typename InputIterator>
+inline Queue parallel_build
+  (InputIterator first, InputIterator last, std::size_t threads)
+{
+  return detail::ParallelQueue<Queue>::build(first, last, threads);
+}
+
+/**
+ * @brief Move all the items of a queue out in the order they would be
+ *  popped, sorting them on several threads.
+ * @param pq The queue, which is left empty but keeps its capacity.
+ * @param out The output iterator.
+ * @param threads The number of threads, counting the calling thread.
+ * @return The output iterator past the last item written.
+ * @throw May throw memory allocation failure or std::system_error before any
+ *  item is moved, in which case the queue is unchanged. If writing to the
+ *  output throws, the items not yet written are destroyed.
+ */
+template<typename Queue, typename OutputIterator>
+inline OutputIterator parallel_drain_sorted
+  (Queue& pq, OutputIterator out, std::size_t threads)
+{
+  return detail::ParallelQueue<Queue>::drainSorted(pq, out, threads);
+}
+
+} // namespace ospp
+
+#endif // _PARALLEL_QUEUE_H
@@ -6,14 +6,30 @@
 #ifndef _QUEUE_H
 #define _QUEUE_H
 
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
 #include <memory>
 #include <functional>
+#include <limits>
 #include <string>
+#include <sstream>
+#include <system_error>
 #include <iterator>
+#include <ostream>
 #include <type_traits>
 #include <utility>
+#include <vector>
 #include <cassert>
 
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "queue/child_select.hh"
 #include "traits/iter_traits.hh"
 
 namespace ospp {
@@ -22,6 +38,579 @@ namespace ospp {
  * forward declaration
  */
 template<typename T> class PriorityQueueIter;
+namespace detail {
+template<typename Queue> class ParallelQueue;
+} // namespace detail
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+class TopK;
+
+////////////////////////////////////////////////////////////////////////////////
+// Growth Policies
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Growth policy that doubles the capacity of the queue.
+ */
+struct DoublingGrowth
+{
+  /**
+   * @brief Compute the capacity after a reallocation.
+   * @param capacity The current capacity.
+   * @param required The minimum capacity needed.
+   * @return The new capacity, which is never less than <em>required</em>.
+   */
+  static std::size_t grow(std::size_t capacity, std::size_t required) noexcept
+  {
+    auto size = capacity << 1;
+    return size < required ? required : size;
+  }
+};
+
+/**
+ * Growth policy that grows the capacity of the queue by a factor of 1.5.
+ */
+struct HalfAgainGrowth
+{
+  /**
+   * @brief Compute the capacity after a reallocation.
+   * @param capacity The current capacity.
+   * @param required The minimum capacity needed.
+   * @return The new capacity, which is never less than <em>required</em>.
+   */
+  static std::size_t grow(std::size_t capacity, std::size_t required) noexcept
+  {
+    auto size = capacity + (capacity >> 1);
+    return size < required ? required : size;
+  }
+};
+
+/**
+ * Growth policy that grows the capacity of the queue by a fixed number of
+ * elements.
+ */
+template<std::size_t Chunk>
+struct ChunkGrowth
+{
+  static_assert(Chunk > 0, "the growth chunk must not be empty");
+
+  /**
+   * @brief Compute the capacity after a reallocation.
+   * @param capacity The current capacity.
+   * @param required The minimum capacity needed.
+   * @return The new capacity, which is never less than <em>required</em>.
+   */
+  static std::size_t grow(std::size_t capacity, std::size_t required) noexcept
+  {
+    auto size = capacity + Chunk;
+    return size < required ? required : size;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Pop Policies
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Pop policy that bubbles the last item down from the root, comparing it with
+ * the best child at each level.
+ */
+struct TopDownPop {};
+
+/**
+ * Pop policy that moves the hole left by the top item all the way down to a
+ * leaf along the path of best children, then bubbles the last item up from
+ * there (Wegener's bottom-up heapsort). The last item usually belongs near
+ * the bottom, so this saves about one comparison per level, which pays off
+ * when comparisons are expensive.
+ */
+struct BottomUpPop {};
+
+////////////////////////////////////////////////////////////////////////////////
+// Layout Policies
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Layout policy that stores the heap level by level: the children of the node
+ * at <em>i</em> are at <em>i * d + 1</em> through <em>i * d + d</em>. Each
+ * level of a large heap is on a different page, so a sift that goes down or up
+ * <em>h</em> levels touches about <em>h</em> pages.
+ */
+struct FlatLayout {};
+
+/**
+ * Layout policy for binary heaps that cuts the heap into page-sized blocks,
+ * each holding a subtree, like Kamp's B-heap. A sift stays inside one block
+ * for the height of the subtree, so it touches about <em>h / k</em> pages,
+ * where <em>k</em> is the height of a block, instead of <em>h</em>.
+ *
+ *  A block has a power of two slots, as many as fit in <em>PageBytes</em>. Its
+ *  first slot is the block root, which has a single child: the root of a
+ *  complete subtree that fills the rest of the block. Each leaf of the subtree
+ *  has two children, which are the roots of two other blocks. Align the buffer
+ *  to <em>PageBytes</em> for the blocks to line up with pages.
+ *
+ *  Blocks are filled one at a time, so unless a whole level of blocks is full,
+ *  most items sit deeper than in a flat heap, and a sift does more comparisons.
+ *  Only pays off when TLB and page misses cost more than those comparisons.
+ */
+template<std::size_t PageBytes = 4096>
+struct BHeapLayout {};
+
+////////////////////////////////////////////////////////////////////////////////
+// Stats Policies
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Stats policy that counts nothing. Every hook is an empty inline function, so
+ * the calls compile away.
+ */
+struct NoStats
+{
+  void compared(std::size_t = 1) noexcept {}
+  void moved(std::size_t = 1) noexcept {}
+  void reallocated(std::size_t) noexcept {}
+  void siftedUp(std::size_t) noexcept {}
+  void siftedDown(std::size_t) noexcept {}
+};
+
+/**
+ * The counters of <em>CountingStats</em>.
+ * @details <em>siftUp[d]</em> and <em>siftDown[d]</em> count the sifts that
+ *  moved an item <em>d</em> levels, with the last bucket holding every deeper
+ *  sift.
+ */
+struct StatsSnapshot
+{
+  enum { DEPTHS = 32 };
+
+  std::uint64_t comparisons;      //!< calls to the comparator
+  std::uint64_t moves;            //!< items moved to another slot
+  std::uint64_t reallocations;    //!< buffers replaced to grow or shrink
+  std::uint64_t bytesReallocated; //!< bytes of items carried to new buffers
+  std::uint64_t siftUp[DEPTHS];   //!< histogram of levels moved up
+  std::uint64_t siftDown[DEPTHS]; //!< histogram of levels moved down
+};
+
+/**
+ * Stats policy that counts the work done by a queue: comparator calls, items
+ * moved by sifts and reallocations, the bytes carried over to new buffers, and
+ * how many levels each sift went up or down. A copied or moved queue starts
+ * with fresh counters.
+ */
+class CountingStats
+{
+public:
+  CountingStats() noexcept
+    : mCounts()
+  {}
+
+  void compared(std::size_t n = 1) noexcept { mCounts.comparisons += n; }
+  void moved(std::size_t n = 1) noexcept { mCounts.moves += n; }
+
+  void reallocated(std::size_t bytes) noexcept
+  {
+    ++mCounts.reallocations;
+    mCounts.bytesReallocated += bytes;
+  }
+
+  void siftedUp(std::size_t levels) noexcept
+  { ++mCounts.siftUp[bucket(levels)]; }
+  void siftedDown(std::size_t levels) noexcept
+  { ++mCounts.siftDown[bucket(levels)]; }
+
+  /**
+   * @return A copy of the counters.
+   */
+  StatsSnapshot snapshot() const noexcept { return mCounts; }
+
+  /**
+   * @brief Set all the counters to zero.
+   */
+  void reset() noexcept { mCounts = StatsSnapshot(); }
+
+private:
+  static std::size_t bucket(std::size_t levels) noexcept
+  {
+    return levels < StatsSnapshot::DEPTHS ? levels : StatsSnapshot::DEPTHS - 1;
+  }
+
+  StatsSnapshot mCounts;
+};
+
+/**
+ * @brief Output operator for the counters, as a JSON object.
+ * @details The histograms are cut after their last non-zero bucket.
+ * @param os The output stream.
+ * @param stats The counters.
+ * @return A reference to the output stream.
+ */
+inline std::ostream& operator<<(std::ostream& os, const StatsSnapshot& stats)
+{
+  auto histogram = [&os](const std::uint64_t (&counts)[StatsSnapshot::DEPTHS]) {
+    std::size_t used = StatsSnapshot::DEPTHS;
+    while (used > 0 && counts[used - 1] == 0)
+      --used;
+
+    os << "[";
+    for (std::size_t i = 0; i < used; ++i)
+      os << (i ? ", " : "") << counts[i];
+    os << "]";
+  };
+
+  os << "{\"comparisons\": " << stats.comparisons
+     << ", \"moves\": " << stats.moves
+     << ", \"reallocations\": " << stats.reallocations
+     << ", \"bytes_reallocated\": " << stats.bytesReallocated
+     << ", \"sift_up\": ";
+  histogram(stats.siftUp);
+  os << ", \"sift_down\": ";
+  histogram(stats.siftDown);
+  return os << "}";
+}
+
+namespace detail {
+
+/**
+ * @return The largest power of two that is not greater than <em>n</em>, and
+ *  at least 2.
+ */
+constexpr std::size_t floorPowerOfTwo(std::size_t n, std::size_t p = 2)
+  noexcept
+{
+  return p * 2 > n ? p : floorPowerOfTwo(n, p * 2);
+}
+
+/**
+ * @return The base 2 logarithm of a power of two.
+ */
+constexpr std::size_t log2(std::size_t n) noexcept
+{
+  return n > 1 ? 1 + log2(n / 2) : 0;
+}
+
+/**
+ * The shape of the blocks of a B-heap.
+ */
+template<std::size_t PageBytes, std::size_t ItemBytes>
+struct BHeapGeometry
+{
+  enum : std::size_t
+  {
+    slots = floorPowerOfTwo(PageBytes / ItemBytes), //!< slots per block
+    shift = log2(slots),                            //!< log2 of slots
+    leaves = slots / 2                              //!< first leaf slot
+  };
+};
+
+/**
+ * DefaultStorage.
+ * @details What a queue may do with the buffers of an allocator besides
+ *  allocating and deallocating them, for allocators that do nothing special.
+ *  Allocators that do specialize <em>StorageTraits</em>, and inherit from
+ *  this whatever they do not change.
+ */
+template<typename Alloc>
+struct DefaultStorage
+{
+  using pointer = typename std::allocator_traits<Alloc>::pointer;
+  using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
+
+  /**
+   * True if <em>resize</em> can grow or shrink a buffer.
+   */
+  enum { remaps = false };
+
+  /**
+   * @return True if <em>ptr</em> is a buffer inside <em>alloc</em>, which
+   *  cannot be handed over to another queue. Moves and swaps move the items
+   *  of such a buffer instead.
+   */
+  static bool owns(const Alloc&, const_pointer) noexcept
+  {
+    return false;
+  }
+
+  /**
+   * @return The capacity to allocate for at least <em>size</em> items.
+   */
+  static std::size_t capacity(const Alloc&, std::size_t size) noexcept
+  {
+    return size;
+  }
+
+  /**
+   * @brief Resize a buffer, relocating the items as raw bytes. Only called if
+   *  <em>remaps</em> is true and the items are trivially copyable.
+   * @return The resized buffer.
+   */
+  static pointer resize(Alloc&, pointer ptr, std::size_t, std::size_t)
+  {
+    return ptr;
+  }
+
+  /**
+   * @brief Map items stored in a file as a buffer, copy-on-write.
+   * @details Allocators that cannot map files return null, and the items are
+   *  read into a buffer instead.
+   * @param offset Where the items start in the file, page aligned.
+   * @param count The number of items.
+   * @param size Set to the capacity of the buffer.
+   * @return The buffer, or null.
+   */
+  static pointer mapFile
+    (Alloc&, std::FILE*, std::size_t, std::size_t, std::size_t&)
+  {
+    return nullptr;
+  }
+};
+
+/**
+ * StorageTraits.
+ * @details Specialized by <em>InlineAllocator</em> and
+ *  <em>MmapAllocator</em>.
+ */
+template<typename Alloc>
+struct StorageTraits : DefaultStorage<Alloc> {};
+
+/**
+ * True if <em>std::hash</em> is enabled for <em>T</em>.
+ */
+template<typename T, typename = void>
+struct IsHashable : std::false_type {};
+
+template<typename T>
+struct IsHashable
+  <T, decltype(void(std::hash<T>()(std::declval<const T&>())))>
+  : std::true_type {};
+
+/**
+ * @brief Scramble the bits of a hash (the splitmix64 finalizer), so that a
+ *  sum of hashes does not collide for multisets with the same sum of items.
+ */
+inline std::uint64_t mixHash(std::uint64_t h) noexcept
+{
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+  return h ^ (h >> 31);
+}
+
+/**
+ * @brief Combine the sum of the mixed item hashes with the number of items.
+ */
+inline std::size_t finishHash(std::uint64_t sum, std::size_t count) noexcept
+{
+  return static_cast<std::size_t>(mixHash(sum + mixHash(count)));
+}
+
+/**
+ * ItemHash.
+ * @details The sum of the mixed hashes of the items of a queue, which is the
+ *  same for any order of the same items. It is kept up to date as items come
+ *  and go, so the hash of the queue is O(1). Does nothing if <em>T</em> has
+ *  no <em>std::hash</em>.
+ */
+template<typename T, bool = IsHashable<T>::value>
+class ItemHash
+{
+public:
+  void add(const T& item) noexcept
+  {
+    mSum += mixHash(std::hash<T>()(item));
+  }
+
+  void remove(const T& item) noexcept
+  {
+    mSum -= mixHash(std::hash<T>()(item));
+  }
+
+  void reset() noexcept { mSum = 0; }
+  void restore(std::uint64_t sum) noexcept { mSum = sum; }
+  std::uint64_t sum() const noexcept { return mSum; }
+
+private:
+  std::uint64_t mSum = 0;
+};
+
+template<typename T>
+class ItemHash<T, false>
+{
+public:
+  void add(const T&) noexcept {}
+  void remove(const T&) noexcept {}
+  void reset() noexcept {}
+  void restore(std::uint64_t) noexcept {}
+  std::uint64_t sum() const noexcept { return 0; }
+};
+
+/**
+ * The page size of the layout of a heap, or zero for a flat heap. Saved with
+ * a snapshot, since the items are only a heap in the layout they were saved
+ * with.
+ */
+template<typename Layout>
+struct LayoutPage : std::integral_constant<std::size_t, 0> {};
+
+template<std::size_t PageBytes>
+struct LayoutPage<BHeapLayout<PageBytes>>
+  : std::integral_constant<std::size_t, PageBytes> {};
+
+/**
+ * The header of a snapshot file written by <em>PriorityQueue::save</em>. The
+ * items follow at <em>OFFSET</em>, so that they can be mapped.
+ */
+struct SnapshotHeader
+{
+  enum : std::uint32_t { VERSION = 1 };
+  enum : std::size_t { OFFSET = 4096 };
+
+  char magic[8];              //!< "ospp-pq" and a null
+  std::uint32_t version;      //!< VERSION
+  std::uint32_t itemBytes;    //!< sizeof(T)
+  std::uint64_t arity;        //!< children per node
+  std::uint64_t layoutPage;   //!< LayoutPage of the layout
+  std::uint64_t count;        //!< number of items
+  std::uint64_t hash;         //!< the sum kept by ItemHash
+};
+
+/**
+ * @brief Make the header of a snapshot.
+ */
+inline SnapshotHeader makeSnapshotHeader
+  (std::size_t itemBytes, std::size_t arity, std::size_t layoutPage,
+   std::size_t count, std::uint64_t hash) noexcept
+{
+  SnapshotHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, "ospp-pq", 8);
+  header.version = SnapshotHeader::VERSION;
+  header.itemBytes = static_cast<std::uint32_t>(itemBytes);
+  header.arity = arity;
+  header.layoutPage = layoutPage;
+  header.count = count;
+  header.hash = hash;
+  return header;
+}
+
+/**
+ * TextFormat.
+ * @details Writes an item as text the way an output stream with the default
+ *  flags does. Items without a specialization are written with their output
+ *  operator, and their length is not known in advance.
+ */
+template<typename T, typename = void>
+struct TextFormat
+{
+  static std::size_t length(const T&) noexcept { return 0; }
+
+  static void append(std::string& str, const T& item)
+  {
+    std::ostringstream os;
+    os << item;
+    str += os.str();
+  }
+};
+
+/**
+ * Characters are written as they are, and bool as 0 or 1.
+ */
+template<typename T>
+struct TextFormat
+  <T, typename std::enable_if<std::is_same<T, char>::value ||
+                              std::is_same<T, signed char>::value ||
+                              std::is_same<T, unsigned char>::value>::type>
+{
+  static std::size_t length(T) noexcept { return 1; }
+  static void append(std::string& str, T item) { str += char(item); }
+};
+
+template<>
+struct TextFormat<bool>
+{
+  static std::size_t length(bool) noexcept { return 1; }
+  static void append(std::string& str, bool item) { str += item ? '1' : '0'; }
+};
+
+/**
+ * Integers are written in decimal.
+ */
+template<typename T>
+struct TextFormat
+  <T, typename std::enable_if<std::is_integral<T>::value &&
+                              !std::is_same<T, bool>::value &&
+                              sizeof(T) != 1>::type>
+{
+  static std::size_t length(T item) noexcept
+  {
+    std::size_t n = item < 0 ? 2 : 1;
+    for (auto u = magnitude(item); u >= 10; u /= 10)
+      ++n;
+    return n;
+  }
+
+  static void append(std::string& str, T item)
+  {
+    char buf[std::numeric_limits<T>::digits10 + 2];
+    auto end = buf + sizeof(buf);
+    auto begin = end;
+    auto u = magnitude(item);
+
+    do {
+      *--begin = static_cast<char>('0' + u % 10);
+      u /= 10;
+    } while (u);
+
+    if (item < 0)
+      *--begin = '-';
+    str.append(begin, end);
+  }
+
+private:
+  static unsigned long long magnitude(T item) noexcept
+  {
+    // negate after widening, so that the minimum value does not overflow
+    return item < 0 ? 0ULL - static_cast<unsigned long long>(item)
+                    : static_cast<unsigned long long>(item);
+  }
+};
+
+/**
+ * Floating point numbers are written like <em>%g</em>, with 6 digits.
+ */
+template<typename T>
+struct TextFormat
+  <T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+  enum { MAX_LENGTH = 16 };
+
+  static std::size_t length(T) noexcept { return MAX_LENGTH; }
+
+  static void append(std::string& str, T item)
+  {
+    char buf[MAX_LENGTH + 1];
+    auto n = std::snprintf(buf, sizeof(buf), "%Lg",
+                           static_cast<long double>(item));
+    str.append(buf, n);
+  }
+};
+
+/**
+ * Strings are written as they are.
+ */
+template<>
+struct TextFormat<std::string>
+{
+  static std::size_t length(const std::string& item) noexcept
+  {
+    return item.size();
+  }
+
+  static void append(std::string& str, const std::string& item)
+  {
+    str += item;
+  }
+};
+
+} // namespace detail
 
 ////////////////////////////////////////////////////////////////////////////////
 // Class Declaration
@@ -29,20 +618,52 @@ template<typename T> class PriorityQueueIter;
 
 /**
  * PriorityQueue.
+ * @details The queue is stored as an implicit d-ary heap. <em>Arity</em> is
+ *  the number of children of each node; a binary heap is the default, but a
+ *  4-ary or 8-ary heap is shallower and keeps the children of a node on the
+ *  same cache line for small types, which makes pop cheaper for large queues.
+ *  <em>Growth</em> decides the new capacity when the queue runs out of space.
+ *  <em>Pop</em> selects how the heap is repaired after the top is removed.
+ *  <em>Layout</em> decides where each node of the heap is stored.
+ *  <em>Stats</em> counts the work done by the queue; the default counts
+ *  nothing and costs nothing.
+ *
+ *  With 8 or 16 children per node, 32-bit integer and float keys compared
+ *  with <em>std::less</em> or <em>std::greater</em> pick the best child with
+ *  AVX2 instead of a chain of branches, when the CPU supports it.
  */
 template
 <
   typename T,
   typename Compare = std::less<T>,
-  typename Alloc = std::allocator<T>
+  typename Alloc = std::allocator<T>,
+  std::size_t Arity = 2,
+  typename Growth = DoublingGrowth,
+  typename Pop = TopDownPop,
+  typename Layout = FlatLayout,
+  typename Stats = NoStats
 >
 class PriorityQueue
 {
+  static_assert(Arity >= 2, "the arity of the heap must be at least 2");
+  static_assert(Arity == 2 || std::is_same<Layout, FlatLayout>::value,
+                "only binary heaps may have a B-heap layout");
+
+  /**
+   * Default size for priority queue.
+   */
+  enum { DEFAULT_SIZE = 8 };
+
+  using alloc_traits = std::allocator_traits<Alloc>;
+  using storage_traits = detail::StorageTraits<Alloc>;
+
   /**
-   * Default size for priority queue and size multiplier when items don't fit
-   * in priority queue
+   * True if the allocator resizes the buffer, moving the items as raw bytes.
    */
-  enum { DEFAULT_SIZE = 8, SIZE_MULT = 1 };
+  enum
+  {
+    REMAPS = storage_traits::remaps && std::is_trivially_copyable<T>::value
+  };
 
 public:
   /**
@@ -50,18 +671,27 @@ public:
    */
   using value_type = T;
   using allocator_type = Alloc;
-  using reference = typename Alloc::reference;
-  using const_reference = typename Alloc::const_reference;
-  using pointer = typename Alloc::pointer;
-  using const_pointer = typename Alloc::const_pointer;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = typename alloc_traits::pointer;
+  using const_pointer = typename alloc_traits::const_pointer;
   using iterator = PriorityQueueIter<value_type>;
   // TODO: determine how to write const iterator version
   //using const_iterator = const PriorityQueueIter<value_type>;
   //using difference_type = typename std::iterator_traits<iterator>::difference_type;
   using size_type = size_t;
   using compare_type = Compare;
+  using growth_type = Growth;
+  using pop_type = Pop;
+  using layout_type = Layout;
+  using stats_type = Stats;
   // TODO: create alias for reverse iterator
 
+  /**
+   * The number of children of each node in the heap.
+   */
+  static constexpr size_type arity = Arity;
+
   /**
    * Initialize
    */
@@ -86,14 +716,14 @@ public:
    * Copy Construct
    */
   PriorityQueue(const PriorityQueue& cont);
-  PriorityQueue(PriorityQueue&& cont);
+  PriorityQueue(PriorityQueue&& cont) noexcept;
 
 
   /**
    * Assignment
    */
   PriorityQueue& operator=(const PriorityQueue& cont);
-  PriorityQueue& operator=(PriorityQueue&& cont);
+  PriorityQueue& operator=(PriorityQueue&& cont) noexcept;
 
   /**
    * Destructor
@@ -105,13 +735,45 @@ public:
    */
   bool empty() const noexcept;
   size_type size() const noexcept;
-  value_type top() const noexcept;
+  const_reference top() const noexcept;
   void push(const value_type& value);
   void push(value_type&& value);
   template<typename... Args>
   void emplace(Args&&... args);
+  template
+  <
+    typename InputIterator,
+    typename = typename std::enable_if<is_input_iter<InputIterator>::value>::type
+  >
+  void push_range(InputIterator first, InputIterator last);
+  void merge(PriorityQueue&& other);
   void pop() noexcept(std::is_nothrow_destructible<T>::value);
+  value_type pop_value();
+  void replace_top(const value_type& value);
+  void replace_top(value_type&& value);
+  value_type pushpop(const value_type& value);
+  value_type pushpop(value_type&& value);
   size_t capacity() const noexcept;
+  template<typename OutputIterator>
+  OutputIterator drain_sorted(OutputIterator out);
+  template<typename OutputIterator>
+  OutputIterator pop_n(size_type k, OutputIterator out);
+  void reserve(size_type size);
+  void shrink_to_fit();
+  void clear() noexcept;
+  void swap(PriorityQueue& cont) noexcept;
+
+  /**
+   * instrumentation
+   */
+  const stats_type& stats() const noexcept;
+  stats_type& stats() noexcept;
+
+  /**
+   * persistence
+   */
+  void save(const std::string& path) const;
+  void load(const std::string& path);
 
   /**
    * object functionality
@@ -124,17 +786,72 @@ public:
   /**
    * indexing functions
    */
-  int parent(int index) const noexcept;
-  int leftChild(int index) const noexcept;
-  int rightChild(int index) const noexcept;
+  size_type parent(size_type index) const noexcept;
+  size_type firstChild(size_type index, size_type& stride) const noexcept;
+  size_type lastParent() const noexcept;
+  size_type parent(size_type index, FlatLayout) const noexcept;
+  template<std::size_t PageBytes>
+  size_type parent(size_type index, BHeapLayout<PageBytes>) const noexcept;
+  size_type firstChild
+    (size_type index, size_type& stride, FlatLayout) const noexcept;
+  template<std::size_t PageBytes>
+  size_type firstChild
+    (size_type index, size_type& stride, BHeapLayout<PageBytes>)
+    const noexcept;
+  size_type lastParent(FlatLayout) const noexcept;
+  template<std::size_t PageBytes>
+  size_type lastParent(BHeapLayout<PageBytes>) const noexcept;
 
   /**
    * movement functions
    */
-  void bubbleDown(int index = 0) noexcept;
-  void bubbleUp(int index) noexcept;
-  int familyMin(const T& val, int index) const noexcept;
-
+  void bubbleDown(size_type index = 0) noexcept;
+  void bubbleUp(size_type index) noexcept;
+  size_type holeDown(size_type hole, const T& val) noexcept;
+  size_type holeUp(size_type hole, const T& val) noexcept;
+  size_type popHole(const T& val, TopDownPop) noexcept;
+  size_type popHole(const T& val, BottomUpPop) noexcept;
+  void removeTop() noexcept(std::is_nothrow_destructible<T>::value);
+  void heapify() noexcept;
+  void restoreHeap(size_type first) noexcept;
+  template<typename OutputIterator>
+  OutputIterator popN(size_type k, OutputIterator out, std::true_type);
+  template<typename OutputIterator>
+  OutputIterator popN(size_type k, OutputIterator out, std::false_type);
+  void fillHoles(const std::vector<size_type>& holes,
+                 std::vector<size_type>& tail) noexcept;
+  template<typename... Args>
+  void append(Args&&... args);
+  template<typename InputIterator>
+  void appendRange
+    (InputIterator first, InputIterator last, std::input_iterator_tag);
+  template<typename ForwardIterator>
+  void appendRange
+    (ForwardIterator first, ForwardIterator last, std::forward_iterator_tag);
+  size_type bestChild(size_type first, size_type stride) const noexcept;
+  size_type familyMin(const T& val, size_type index) const noexcept;
+  bool compare(const T& a, const T& b) const noexcept;
+
+  /**
+   * memory functions
+   */
+  size_type storageFor(size_type size) const noexcept;
+  void reallocate(size_type size);
+  void relocate(pointer ptr);
+  void adopt(pointer ptr, size_type size) noexcept;
+  void destroyAll() noexcept;
+  void takeBuffer(PriorityQueue& cont) noexcept;
+  void swapItems(PriorityQueue& cont) noexcept;
+  size_type sortInPlace() noexcept;
+  pointer readItems(std::FILE *file, size_type count, size_type& size);
+
+  /**
+   * hashing functions
+   */
+  size_type hashCode(const std::hash<T>& hsh, std::true_type) const noexcept;
+  template<typename Hash>
+  size_type hashCode(const Hash& hsh, std::false_type) const noexcept;
+
 
   /**
    * Pointer to the array of values in the priority queue.
@@ -146,6 +863,15 @@ public:
    */
   allocator_type mAlloc;
 
+  /**
+   * The counters of the work done by the queue. Mutable, since the comparisons
+   * of const member functions are counted too. An empty member still takes a
+   * byte, so <em>NoStats</em> is declared between the allocator and the
+   * comparator, which are usually empty too: the three bytes fall in the
+   * padding before <em>mSize</em>, and the size of the queue is unchanged.
+   */
+  mutable stats_type mStats;
+
   /**
    * The comparator.
    */
@@ -154,425 +880,2006 @@ public:
   /**
    * The maximum number of elements that may be held.
    */
-  int mSize;
+  size_type mSize;
 
   /**
    * The number of items held by the priority queue.
    */
-  int mCount;
+  size_type mCount;
+
+  /**
+   * The hash of the items, kept up to date for <em>hashCode</em>.
+   */
+  detail::ItemHash<T> mHash;
+
+  /**
+   * friends
+   */
+  template<typename U, typename CompareU, typename AllocU, std::size_t AU,
+           typename GrowthU, typename PopU, typename LayoutU,
+           typename StatsU>
+  friend std::ostream&
+  operator<<
+    (std::ostream&,
+     const PriorityQueue<U, CompareU, AllocU, AU, GrowthU, PopU, LayoutU,
+                         StatsU>&);
+
+  template<typename U, typename CompareU, typename AllocU, std::size_t AU,
+           typename GrowthU, typename PopU, typename LayoutU,
+           typename StatsU>
+  friend bool operator==
+    (const PriorityQueue<U, CompareU, AllocU, AU, GrowthU, PopU, LayoutU,
+                         StatsU>&,
+     const PriorityQueue<U, CompareU, AllocU, AU, GrowthU, PopU, LayoutU,
+                         StatsU>&)
+    noexcept;
+
+  template<typename U> friend class PriorityQueueIter;
+
+  template<typename U, typename CompareU, typename AllocU, std::size_t AU>
+  friend class TopK;
+
+  template<typename Queue> friend class detail::ParallelQueue;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+constexpr
+typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::arity;
+
+/**
+ * @brief Default ctor.
+ * @details The priority queue is initialized with an array of size 8, but none of
+ * the elements in the dynamic array are constructed.
+ * @throw May throw memory allocatoin failure.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+PriorityQueue()
+  : mPtr(nullptr),
+    mAlloc(),
+    mStats(),
+    mCompare(),
+    mSize(storageFor(DEFAULT_SIZE)),
+    mCount(),
+    mHash()
+{
+  mPtr = alloc_traits::allocate(mAlloc, mSize);
+}
+
+/**
+ * @brief Constructor with one parameter.
+ * @param size The starting capacity of the heap.
+ * @throw May throw memory allocatoin failure.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+PriorityQueue(const size_t size)
+  : mPtr(nullptr),
+    mAlloc(),
+    mStats(),
+    mCompare(),
+    mSize(storageFor(size)),
+    mCount(),
+    mHash()
+{
+  mPtr = alloc_traits::allocate(mAlloc, mSize);
+}
+
+/**
+ * @brief Constructor with one parameter.
+ * @param alloc The allocator for the heap.
+ * @throw May throw memory allocatoin failure.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+PriorityQueue(const allocator_type& alloc)
+  : mPtr(nullptr),
+    mAlloc(alloc),
+    mStats(),
+    mCompare(),
+    mSize(storageFor(DEFAULT_SIZE)),
+    mCount(),
+    mHash()
+{
+  mPtr = alloc_traits::allocate(mAlloc, mSize);
+}
+
+/**
+ * @brief Constructor with one parameter.
+ * @param comp The object used to compare items.
+ * @throw May throw memory allocatoin failure.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+PriorityQueue(const compare_type& comp)
+  : mPtr(nullptr),
+    mAlloc(),
+    mStats(),
+    mCompare(comp),
+    mSize(storageFor(DEFAULT_SIZE)),
+    mCount(),
+    mHash()
+{
+  mPtr = alloc_traits::allocate(mAlloc, mSize);
+}
+
+#if 0
+// ctor
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+PriorityQueue
+  (const size_t size,
+   const compare_type& comp,
+   const allocator_type& alloc)
+  : mPtr(nullptr),
+    mAlloc(alloc),
+    mStats(),
+    mCompare(comp),
+    mSize(size),
+    mCount(),
+    mHash()
+{
+  mPtr = alloc_traits::allocate(mAlloc, mSize);
+}
+#endif
+
+/**
+ * @brief Iterator range constructor.
+ * @details The items are appended and then arranged into a heap bottom-up,
+ *  which takes linear time. If the iterators are forward iterators, the buffer
+ *  is allocated once with room for exactly the items in the range.
+ * @param first The iterator to the beginning of the range.
+ * @param last One past the last iterator.
+ * @throw May throw memory allocatoin failure.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<typename InputIterator, typename>
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+PriorityQueue(InputIterator first, InputIterator last)
+  : mPtr(nullptr),
+    mAlloc(),
+    mStats(),
+    mCompare(),
+    mSize(),
+    mCount(),
+    mHash()
+{
+  if (!is_forward_iter<InputIterator>::value)
+    reserve(DEFAULT_SIZE);
+
+  try {
+    push_range(first, last);
+  }
+  catch (...) {
+    destroyAll();
+    if (mPtr)
+      alloc_traits::deallocate(mAlloc, mPtr, mSize);
+    throw;
+  }
+}
+
+/**
+ * @brief Copy constructor.
+ * @param cont The priority queue being copied.
+ * @throw May throw memory allocation failure, or an exception thrown by the
+ *  copy constructor of <em>T</em>. The elements constructed before the
+ *  exception are destroyed.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+PriorityQueue(const PriorityQueue& cont)
+  : mPtr(nullptr),
+    mAlloc(alloc_traits::select_on_container_copy_construction(cont.mAlloc)),
+    mStats(),
+    mCompare(cont.mCompare),
+    mSize(cont.mSize),
+    mCount(),
+    mHash()
+{
+  mPtr = alloc_traits::allocate(mAlloc, mSize);
+
+  try {
+    for (; mCount < cont.mCount; ++mCount)
+      alloc_traits::construct(mAlloc, mPtr+mCount, cont.mPtr[mCount]);
+  }
+  catch (...) {
+    destroyAll();
+    alloc_traits::deallocate(mAlloc, mPtr, mSize);
+    throw;
+  }
+
+  mHash = cont.mHash;
+}
+
+/**
+ * @brief Move constructor.
+ * @details The buffer is taken from <em>cont</em>, which is left empty and
+ *  without capacity. No element is moved, unless the buffer is inline.
+ * @param cont The priority queue being moved.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+PriorityQueue(PriorityQueue&& cont) noexcept
+  : mPtr(nullptr),
+    mAlloc(std::move(cont.mAlloc)),
+    mStats(),
+    mCompare(std::move(cont.mCompare)),
+    mSize(),
+    mCount(),
+    mHash()
+{
+  takeBuffer(cont);
+}
+
+/**
+ * @brief Copy assignment.
+ * @param cont The priority queue being copied.
+ * @return A reference to this queue.
+ * @throw Same as the copy constructor. The queue is unchanged if an exception
+ *  is thrown.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>&
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+operator=(const PriorityQueue& cont)
+{
+  if (this != &cont)
+  {
+    PriorityQueue tmp(cont);
+    swap(tmp);
+  }
+
+  return *this;
+}
+
+/**
+ * @brief Move assignment.
+ * @param cont The priority queue being moved.
+ * @return A reference to this queue.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>&
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+operator=(PriorityQueue&& cont) noexcept
+{
+  swap(cont);
+  return *this;
+}
+
+/**
+ * @brief Destructor.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+~PriorityQueue() noexcept
+{
+  destroyAll();
+
+  if (mPtr)
+    alloc_traits::deallocate(mAlloc, mPtr, mSize);
+}
+
+/**
+ * @brief Determine if the queue is empty.
+ * @return True if the queue is empty, false otherwise.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline bool
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+empty() const noexcept
+{
+  return mCount == 0;
+}
+
+/**
+ * @brief Get the size of the queue.
+ * @return The size of the queue.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline size_t
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+size() const noexcept
+{
+  return mCount;
+}
+
+/**
+ * @brief Get the top value.
+ * @return A reference to the top value in the queue. The queue must not be
+ *  empty.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+const_reference
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+top() const noexcept
+{
+  return mPtr[0];
+}
+
+/**
+ * @brief Push an item into the queue by copying the value.
+ * @param value The value copied and pushed into the queue.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+push(const value_type& value)
+{
+  emplace(value);
+}
+
+/**
+ * @brief Push an item into the queue by moving it.
+ * @param value The value moved into the queue.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+push(value_type&& value)
+{
+  emplace(std::move(value));
+}
+
+/**
+ * @brief Push an item into the queue by constructing it in place.
+ * @param args The arguments used to construct the object.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<typename... Args>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+emplace(Args&&... args)
+{
+  append(std::forward<Args>(args)...);
+  bubbleUp(mCount-1);
+}
+
+/**
+ * @brief Push a range of items into the queue.
+ * @details The items are appended to the heap. If the batch is large compared
+ *  to the heap, the heap is rebuilt bottom-up in linear time; otherwise each
+ *  new item is bubbled up. Forward ranges grow the buffer at most once.
+ * @param first The iterator to the beginning of the range.
+ * @param last One past the last iterator.
+ * @throw May throw memory allocation failure, or an exception thrown while
+ *  constructing an item. The items pushed before the exception remain in the
+ *  queue, which is still a valid heap.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<typename InputIterator, typename>
+void PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+push_range(InputIterator first, InputIterator last)
+{
+  using category =
+    typename std::iterator_traits<InputIterator>::iterator_category;
+
+  auto count = mCount;
+
+  try {
+    appendRange(first, last, category());
+  }
+  catch (...) {
+    restoreHeap(count);
+    throw;
+  }
+
+  restoreHeap(count);
+}
+
+/**
+ * @brief Move all the items of another queue into this one.
+ * @details The smaller queue is appended to the larger one, whose buffer is
+ *  kept: the items are moved to the end of the heap, and then the heap is
+ *  rebuilt or the new items are bubbled up, whichever is cheaper. Merging
+ *  costs O(n + m) at worst, and O(m log(n + m)) when the smaller queue has
+ *  <em>m</em> items and <em>m</em> is small. The allocators of both queues
+ *  must compare equal.
+ * @param other The queue merged into this one, which is left empty.
+ * @throw May throw memory allocation failure, or an exception thrown while
+ *  moving an item. The items moved before the exception remain in this
+ *  queue, which is still a valid heap, and the other queue is emptied.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+void PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+merge(PriorityQueue&& other)
+{
+  if (this == &other || other.mCount == 0)
+    return;
+
+  if (mCount < other.mCount)
+    swap(other);
+
+  auto count = mCount;
+  auto required = mCount + other.mCount;
+
+  if (required > mSize)
+    reallocate(Growth::grow(mSize, required));
+
+  try {
+    for (size_type i = 0; i < other.mCount; ++i)
+    {
+      alloc_traits::construct(mAlloc, mPtr+mCount, std::move(other.mPtr[i]));
+      mHash.add(mPtr[mCount++]);
+    }
+  }
+  catch (...) {
+    restoreHeap(count);
+    other.destroyAll();
+    throw;
+  }
+
+  other.destroyAll();
+  restoreHeap(count);
+}
+
+/**
+ * @brief Construct an item at the end of the heap, growing the buffer if it
+ *  is full, but without bubbling it up.
+ * @param args The arguments used to construct the object.
+ * @throw May throw memory allocation failure, or an exception thrown while
+ *  constructing or relocating an item. The queue is unchanged if an exception
+ *  is thrown.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<typename... Args>
+void PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+append(Args&&... args)
+{
+  if (mCount < mSize) {
+    alloc_traits::construct(mAlloc, mPtr+mCount, std::forward<Args>(args)...);
+    mHash.add(mPtr[mCount++]);
+    return;
+  }
+
+  if (REMAPS) {
+    // args may refer to an item in the queue, which may move
+    T val(std::forward<Args>(args)...);
+    reallocate(Growth::grow(mSize, mSize + 1));
+    alloc_traits::construct(mAlloc, mPtr+mCount, std::move(val));
+    mHash.add(mPtr[mCount++]);
+    return;
+  }
+
+  auto size = storageFor(Growth::grow(mSize, mSize + 1));
+  auto tmp = alloc_traits::allocate(mAlloc, size);
+  mStats.reallocated(mCount * sizeof(T));
+
+  // construct the new item first, because args may refer to an item in the
+  // queue, which is moved below
+  try {
+    alloc_traits::construct(mAlloc, tmp+mCount, std::forward<Args>(args)...);
+  }
+  catch (...) {
+    alloc_traits::deallocate(mAlloc, tmp, size);
+    throw;
+  }
+
+  try {
+    relocate(tmp);
+  }
+  catch (...) {
+    alloc_traits::destroy(mAlloc, tmp+mCount);
+    alloc_traits::deallocate(mAlloc, tmp, size);
+    throw;
+  }
+
+  adopt(tmp, size);
+  mHash.add(mPtr[mCount++]);
+}
+
+/**
+ * @brief Append the items of an input range one at a time.
+ * @param first The iterator to the beginning of the range.
+ * @param last One past the last iterator.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<typename InputIterator>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+appendRange
+  (InputIterator first, InputIterator last, std::input_iterator_tag)
+{
+  for (; first != last; ++first)
+    append(*first);
+}
+
+/**
+ * @brief Append the items of a forward range, growing the buffer at most once.
+ * @param first The iterator to the beginning of the range.
+ * @param last One past the last iterator.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<typename ForwardIterator>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+appendRange
+  (ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
+{
+  auto required =
+    mCount + static_cast<size_type>(std::distance(first, last));
+
+  if (required > mSize)
+    reallocate(Growth::grow(mSize, required));
+
+  for (; first != last; ++first)
+  {
+    alloc_traits::construct(mAlloc, mPtr+mCount, *first);
+    mHash.add(mPtr[mCount++]);
+  }
+}
+
+/**
+ * @brief Remove the top value from the heap.
+ * @throw Does not throw if the destructor for <em>T</em> does not throw.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+pop() noexcept(std::is_nothrow_destructible<T>::value)
+{
+  if (mCount == 0)
+    return;
+
+  mHash.remove(mPtr[0]);
+  removeTop();
+}
+
+/**
+ * @brief Remove the top value from the heap, whose hash was already removed.
+ * @details The top value may have been moved out. The heap must not be empty.
+ * @throw Does not throw if the destructor for <em>T</em> does not throw.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+removeTop() noexcept(std::is_nothrow_destructible<T>::value)
+{
+  auto last = mCount - 1;
+
+  // No need to shuffle items if the last value is being popped
+  if (!last) {
+    alloc_traits::destroy(mAlloc, mPtr+last);
+    --mCount;
+    return;
+  }
+
+  // move the last value out and drop it into the hole left by the top
+  auto val = std::move(mPtr[last]);
+  alloc_traits::destroy(mAlloc, mPtr+last);
+  --mCount;
+  auto hole = popHole(val, Pop());
+  mPtr[hole] = std::move(val);
+}
+
+/**
+ * @brief Remove the top value from the heap and return it.
+ * @return The top value, moved out of the queue. The queue must not be empty.
+ * @throw May throw if moving <em>T</em> throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline T PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+pop_value()
+{
+  assert(mCount > 0);
+
+  // the hash is taken before the item is moved out
+  mHash.remove(mPtr[0]);
+  auto val = std::move(mPtr[0]);
+  removeTop();
+  return val;
+}
+
+/**
+ * @brief Replace the top value with another one.
+ * @details Same as a pop followed by a push, but with a single bubble down.
+ * @param value The value copied into the queue. The queue must not be empty.
+ * @throw May throw if copying <em>T</em> throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+replace_top(const value_type& value)
+{
+  assert(mCount > 0);
+
+  mHash.remove(mPtr[0]);
+  mHash.add(value);
+  auto hole = holeDown(0, value);
+  mPtr[hole] = value;
+}
+
+/**
+ * @brief Replace the top value with another one.
+ * @details Same as a pop followed by a push, but with a single bubble down.
+ * @param value The value moved into the queue. The queue must not be empty.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+replace_top(value_type&& value)
+{
+  assert(mCount > 0);
+
+  mHash.remove(mPtr[0]);
+  mHash.add(value);
+  auto hole = holeDown(0, value);
+  mPtr[hole] = std::move(value);
+}
+
+/**
+ * @brief Push a value and then pop the top value.
+ * @details If the value would go on top, it is returned right away and the
+ *  queue is untouched. Otherwise, the top value is moved out and the value
+ *  takes its place with a single bubble down.
+ * @param value The value copied into the queue.
+ * @return The value that was popped.
+ * @throw May throw if copying <em>T</em> throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline T PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+pushpop(const value_type& value)
+{
+  if (mCount == 0 || !compare(mPtr[0], value))
+    return value;
+
+  mHash.remove(mPtr[0]);
+  mHash.add(value);
+  auto val = std::move(mPtr[0]);
+  auto hole = holeDown(0, value);
+  mPtr[hole] = value;
+  return val;
+}
+
+/**
+ * @brief Push a value and then pop the top value.
+ * @details If the value would go on top, it is returned right away and the
+ *  queue is untouched. Otherwise, the top value is moved out and the value
+ *  takes its place with a single bubble down.
+ * @param value The value moved into the queue.
+ * @return The value that was popped.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline T PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+pushpop(value_type&& value)
+{
+  if (mCount == 0 || !compare(mPtr[0], value))
+    return std::move(value);
+
+  mHash.remove(mPtr[0]);
+  mHash.add(value);
+  auto val = std::move(mPtr[0]);
+  auto hole = holeDown(0, value);
+  mPtr[hole] = std::move(value);
+  return val;
+}
+
+/**
+ * @return The current capacity of the priority queue.
+ * @details The capacity refers to the total number of items that can be added to
+ * the queue before it needs to be reallocated to a different chunk of memory.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline size_t
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+capacity() const noexcept
+{
+  return mSize;
+}
+
+/**
+ * @brief Move all the items out in the order they would be popped.
+ * @details The items are heap sorted in place, so no memory is allocated, and
+ *  then moved to the output. The queue is left empty, but keeps its capacity.
+ * @param out The output iterator.
+ * @return The output iterator past the last item written.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<typename OutputIterator>
+OutputIterator
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+drain_sorted(OutputIterator out)
+{
+  for (auto i = sortInPlace(); i-- > 0;)
+  {
+    *out = std::move(mPtr[i]);
+    ++out;
+  }
+
+  destroyAll();
+  return out;
+}
+
+/**
+ * @brief Move the <em>k</em> best items out in the order they would be popped.
+ * @details For items that are costly to compare, the heap is fixed once after
+ *  all the items are moved out, which takes fewer comparisons than popping
+ *  them one at a time. Scalar items are popped one at a time, since the
+ *  bookkeeping then costs more than the comparisons it saves.
+ * @param k The number of items to pop. If not less than the size, the queue is
+ *  drained.
+ * @param out The output iterator.
+ * @return The output iterator past the last item written.
+ * @throw May throw memory allocation failure, in which case the queue is
+ *  unchanged.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<typename OutputIterator>
+inline OutputIterator
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+pop_n(size_type k, OutputIterator out)
+{
+  if (k >= mCount)
+    return drain_sorted(out);
+
+  return popN(k, out, std::is_scalar<T>());
+}
+
+/**
+ * @brief Move the <em>k</em> best items out with one pop per item.
+ * @param k The number of items to pop. It is less than the size.
+ * @param out The output iterator.
+ * @return The output iterator past the last item written.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<typename OutputIterator>
+inline OutputIterator
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+popN(size_type k, OutputIterator out, std::true_type)
+{
+  for (; k > 0; --k)
+  {
+    mHash.remove(mPtr[0]);
+    *out = std::move(mPtr[0]);
+    ++out;
+    removeTop();
+  }
+
+  return out;
+}
+
+/**
+ * @brief Move the <em>k</em> best items out, then fix the heap once.
+ * @details An item is never better than its parent, so the next best item is
+ *  always a child of an item already found. The <em>k</em> best items are
+ *  found by walking down from the root with a small heap of candidate nodes,
+ *  without reordering the queue. The nodes that were
+ *  moved out form a subtree at the top, which <em>fillHoles</em> then fills.
+ * @param k The number of items to pop. It is less than the size.
+ * @param out The output iterator.
+ * @return The output iterator past the last item written.
+ * @throw May throw memory allocation failure, in which case the queue is
+ *  unchanged.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<typename OutputIterator>
+OutputIterator
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+popN(size_type k, OutputIterator out, std::false_type)
+{
+  if (k == 0)
+    return out;
+
+  std::vector<size_type> holes;
+  std::vector<size_type> candidates;
+  holes.reserve(k);
+  candidates.reserve(k * (Arity - 1) + 1);
+
+  // a max heap of node indices, with the best item in front
+  auto worse = [this](size_type a, size_type b) {
+    return compare(mPtr[b], mPtr[a]);
+  };
+
+  candidates.push_back(0);
+  while (holes.size() < k)
+  {
+    std::pop_heap(candidates.begin(), candidates.end(), worse);
+    auto index = candidates.back();
+    candidates.pop_back();
+
+    size_type stride;
+    auto child = firstChild(index, stride);
+    for (std::size_t i = 0; i < Arity && child < mCount; ++i, child += stride)
+    {
+      candidates.push_back(child);
+      std::push_heap(candidates.begin(), candidates.end(), worse);
+    }
+
+    mHash.remove(mPtr[index]);
+    *out = std::move(mPtr[index]);
+    ++out;
+    holes.push_back(index);
+  }
+
+  fillHoles(holes, candidates);
+  return out;
+}
+
+/**
+ * @brief Make room for at least <em>size</em> items.
+ * @details If <em>size</em> is greater than the capacity, the items are moved
+ *  into a new buffer with exactly <em>size</em> slots. Otherwise, this does
+ *  nothing.
+ * @param size The minimum capacity.
+ * @throw May throw memory allocation failure, or an exception thrown by the
+ *  copy constructor of a <em>T</em> whose move constructor is not noexcept.
+ *  The queue is unchanged if an exception is thrown.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+reserve(size_type size)
+{
+  if (size > mSize)
+    reallocate(size);
+}
+
+/**
+ * @brief Reduce the capacity to the number of items in the queue.
+ * @details An inline buffer is kept as it is. A spilled buffer moves back
+ *  inline if the items fit.
+ * @throw Same as <em>reserve</em>. The queue is unchanged if an exception is
+ *  thrown.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+shrink_to_fit()
+{
+  if (mCount < mSize && !storage_traits::owns(mAlloc, mPtr))
+    reallocate(mCount);
+}
+
+/**
+ * @brief Remove all the items, but keep the capacity.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+clear() noexcept
+{
+  destroyAll();
+}
+
+/**
+ * @brief Swap the contents of two queues.
+ * @details The buffers are swapped, unless one of them is inline, in which
+ *  case the items are moved.
+ * @param cont The other priority queue.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+swap(PriorityQueue& cont) noexcept
+{
+  if (storage_traits::owns(mAlloc, mPtr) ||
+      storage_traits::owns(cont.mAlloc, cont.mPtr)) {
+    swapItems(cont);
+    return;
+  }
+
+  using std::swap;
+  swap(mPtr, cont.mPtr);
+  swap(mAlloc, cont.mAlloc);
+  swap(mCompare, cont.mCompare);
+  swap(mSize, cont.mSize);
+  swap(mCount, cont.mCount);
+  swap(mHash, cont.mHash);
+}
+
+/**
+ * @return The counters of the work done by the queue. With <em>NoStats</em>,
+ *  there is nothing to read.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline const Stats&
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+stats() const noexcept
+{
+  return mStats;
+}
+
+/**
+ * @return The counters of the work done by the queue, for example to reset
+ *  them.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline Stats&
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+stats() noexcept
+{
+  return mStats;
+}
+
+/**
+ * @brief Save the heap to a file, as raw bytes after a small header.
+ * @details The header records the version of the format and the shape of the
+ *  queue, so that <em>load</em> can reject a file saved by another type of
+ *  queue. The file is written to a new file with a unique name next to
+ *  <em>path</em> and renamed over it, so that a reader never sees a partial
+ *  snapshot, concurrent saves to the same path never write to the same file,
+ *  and queues that mapped the old file keep their pages. The snapshot is
+ *  created with mode 0644. Only for trivially copyable items, and only
+ *  readable on the same platform.
+ * @param path The file to write.
+ * @throw std::system_error if the file cannot be written. The file at
+ *  <em>path</em> is unchanged if an exception is thrown.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+void PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+save(const std::string& path) const
+{
+  static_assert(std::is_trivially_copyable<T>::value,
+                "only trivially copyable items can be saved as raw bytes");
+
+  auto header = detail::makeSnapshotHeader
+    (sizeof(T), Arity, detail::LayoutPage<Layout>::value, mCount, mHash.sum());
+  char page[detail::SnapshotHeader::OFFSET] = {};
+  std::memcpy(page, &header, sizeof(header));
+
+  auto tmp = path + ".XXXXXX";
+  int fd = ::mkstemp(&tmp[0]);
+  if (fd < 0)
+    throw std::system_error(errno, std::generic_category(), tmp);
+
+  std::FILE *file = ::fchmod(fd, 0644) == 0 ? ::fdopen(fd, "wb") : nullptr;
+  if (!file) {
+    int err = errno;
+    ::close(fd);
+    std::remove(tmp.c_str());
+    throw std::system_error(err, std::generic_category(), tmp);
+  }
+
+  errno = 0;
+  int err = 0;
+  if (std::fwrite(page, sizeof(page), 1, file) != 1 ||
+      (mCount > 0 && std::fwrite(static_cast<const void*>(mPtr), sizeof(T),
+                                 mCount, file) != mCount))
+    err = errno ? errno : EIO;
+  if (std::fclose(file) != 0 && !err)
+    err = errno ? errno : EIO;
+  if (!err && std::rename(tmp.c_str(), path.c_str()) != 0)
+    err = errno;
+
+  if (err) {
+    std::remove(tmp.c_str());
+    throw std::system_error(err, std::generic_category(), path);
+  }
+}
+
+/**
+ * @brief Replace the items with the heap saved in a file.
+ * @details The items are adopted as they were saved, without sifting. If the
+ *  allocator can map files, like <em>MmapAllocator</em>, the file is mapped
+ *  copy-on-write: loading costs a page fault per page touched, and changes
+ *  never reach the file. The first time the queue grows or shrinks, the
+ *  items are copied out of the mapping. Otherwise the items are read into a
+ *  new buffer. The comparator must order the items like the one of the queue
+ *  that saved them.
+ * @param path The file to read.
+ * @throw std::system_error if the file cannot be read, is not a snapshot of
+ *  this type of queue, or is truncated, or memory allocation failure. The
+ *  queue is unchanged if an exception is thrown.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+void PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+load(const std::string& path)
+{
+  static_assert(std::is_trivially_copyable<T>::value,
+                "only trivially copyable items can be loaded as raw bytes");
+
+  std::FILE *file = std::fopen(path.c_str(), "rb");
+  if (!file)
+    throw std::system_error(errno, std::generic_category(), path);
+
+  auto expected = detail::makeSnapshotHeader
+    (sizeof(T), Arity, detail::LayoutPage<Layout>::value, 0, 0);
+  detail::SnapshotHeader header;
+  pointer ptr;
+  size_type size;
+
+  try {
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, expected.magic, sizeof(header.magic)) ||
+        header.version != expected.version ||
+        header.itemBytes != expected.itemBytes ||
+        header.arity != expected.arity ||
+        header.layoutPage != expected.layoutPage)
+      throw std::system_error(EINVAL, std::generic_category(),
+                              path + ": not a snapshot of this queue");
+
+    ptr = readItems(file, header.count, size);
+  }
+  catch (...) {
+    std::fclose(file);
+    throw;
+  }
+
+  std::fclose(file);
+  adopt(ptr, size);
+  mCount = header.count;
+  mHash.restore(header.hash);
+}
+
+/**
+ * @brief Write the items as text, like the output operator does.
+ * @details The length of the text is worked out first, so the string is
+ *  allocated once. Integers, floating point numbers, characters and strings
+ *  are written directly; other items are written with their output operator,
+ *  and may grow the string.
+ * @return The items in the order they are stored, as <em>{a, b, c}</em>.
+ * @throw May throw memory allocation failure.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+std::string
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+toString() const
+{
+  using format = detail::TextFormat<T>;
+
+  size_type length = 2;
+  for (size_type i = 0; i < mCount; ++i)
+    length += format::length(mPtr[i]) + (i ? 2 : 0);
+
+  std::string str;
+  str.reserve(length);
+  str += '{';
+  for (size_type i = 0; i < mCount; ++i)
+  {
+    if (i)
+      str += ", ";
+    format::append(str, mPtr[i]);
+  }
+  str += '}';
+
+  return str;
+}
+
+/**
+ * @brief Get a hash of the items that does not depend on their order.
+ * @details The hash is a mix of the number of items and the sum of the mixed
+ *  hashes of the items, so queues with the same items have the same hash,
+ *  however they were built. With <em>std::hash</em>, the sum is kept up to
+ *  date as items are pushed and popped, and this takes O(1). Any other hash
+ *  function is applied to every item.
+ * @param hsh The hash function for the items.
+ * @return The hash of the queue.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<typename Hash>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+hashCode(const Hash& hsh) const noexcept
+{
+  using kept = std::integral_constant<bool,
+    std::is_same<Hash, std::hash<T>>::value && detail::IsHashable<T>::value>;
 
-  /**
-   * friends
-   */
-  template<typename U, typename CompareU, typename AllocU>
-  friend std::ostream&
-  operator<<(std::ostream&, const PriorityQueue<U, CompareU, AllocU>&);
+  return hashCode(hsh, kept());
+}
 
-  template<typename U, typename CompareU, typename AllocU>
-  friend bool operator==
-    (const PriorityQueue<U, CompareU, AllocU>&,
-     const PriorityQueue<U, CompareU, AllocU>&) noexcept;
+/**
+ * @brief Get the hash of the items from the sum kept up to date.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+hashCode(const std::hash<T>&, std::true_type) const noexcept
+{
+  return detail::finishHash(mHash.sum(), mCount);
+}
 
-  template<typename U> friend class PriorityQueueIter;
-};
+/**
+ * @brief Get the hash of the items by hashing every item.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<typename Hash>
+typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+hashCode(const Hash& hsh, std::false_type) const noexcept
+{
+  std::uint64_t sum = 0;
+  for (size_type i = 0; i < mCount; ++i)
+    sum += detail::mixHash(hsh(mPtr[i]));
 
-////////////////////////////////////////////////////////////////////////////////
-// Class Definition
-////////////////////////////////////////////////////////////////////////////////
+  return detail::finishHash(sum, mCount);
+}
 
 /**
- * @brief Default ctor.
- * @details The priority queue is initialized with an array of size 8, but none of
- * the elements in the dynamic array are constructed.
- * @throw May throw memory allocatoin failure.
+ * @brief Get parent of the node at the given index.
+ * @param index The index of the child node, which must not be the root.
+ * @return The index of the parent.
+ * @throw Never throws.
  */
-template<typename T, typename Compare, typename  Alloc>
-PriorityQueue<T, Compare, Alloc>::
-PriorityQueue()
-  : mPtr(nullptr),
-    mAlloc(),
-    mCompare(),
-    mSize(DEFAULT_SIZE),
-    mCount()
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+parent(size_type index) const noexcept
 {
-  mPtr = mAlloc.allocate(mSize);
+  assert(index > 0 && index < mCount);
+  return parent(index, Layout());
 }
 
 /**
- * @brief Constructor with one parameter.
- * @param size The starting capacity of the heap.
- * @throw May throw memory allocatoin failure.
+ * @brief Get the first child of the node at the given index.
+ * @detail The children of a node are <em>stride</em> apart, starting at the
+ *  first child. If not less than <em>mCount</em>, then the node is a leaf.
+ * @param index The index of the parent node.
+ * @param stride Set to the distance between the children.
+ * @return The index of the first child.
+ * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-PriorityQueue<T, Compare, Alloc>::
-PriorityQueue(const size_t size)
-  : mPtr(nullptr),
-    mAlloc(),
-    mCompare(),
-    mSize(size),
-    mCount()
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+firstChild(size_type index, size_type& stride) const noexcept
 {
-  mPtr = mAlloc.allocate(mSize);
+  assert(index < mCount);
+  return firstChild(index, stride, Layout());
 }
 
 /**
- * @brief Constructor with one parameter.
- * @param alloc The allocator for the heap.
- * @throw May throw memory allocatoin failure.
+ * @brief Get the last node that may have children.
+ * @return An index such that no node after it has a child. The queue must
+ *  hold at least two items.
+ * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-PriorityQueue<T, Compare, Alloc>::
-PriorityQueue(const allocator_type& alloc)
-  : mPtr(nullptr),
-    mAlloc(alloc),
-    mCompare(),
-    mSize(DEFAULT_SIZE),
-    mCount()
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+lastParent() const noexcept
 {
-  mPtr = mAlloc.allocate(mSize);
+  assert(mCount > 1);
+  return lastParent(Layout());
 }
 
 /**
- * @brief Constructor with one parameter.
- * @param comp The object used to compare items.
- * @throw May throw memory allocatoin failure.
+ * @brief Get the parent of a node that is not the root, in a flat heap.
+ * @param index The index of the child node.
+ * @return The index of the parent.
+ * @throw Never throws.
  */
-template<typename T, typename Compare, typename  Alloc>
-PriorityQueue<T, Compare, Alloc>::
-PriorityQueue(const compare_type& comp)
-  : mPtr(nullptr),
-    mAlloc(),
-    mCompare(comp),
-    mSize(DEFAULT_SIZE),
-    mCount()
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+parent(size_type index, FlatLayout) const noexcept
 {
-  mPtr = mAlloc.allocate(mSize);
+  return (index - 1) / Arity;
 }
 
-#if 0
-// ctor
-template<typename T, typename Compare, typename Alloc>
-PriorityQueue<T, Compare, Alloc>::
-PriorityQueue
-  (const size_t size,
-   const compare_type& comp,
-   const allocator_type& alloc)
-  : mPtr(nullptr),
-    mAlloc(alloc),
-    mCompare(comp),
-    mSize(size),
-    mCount()
+/**
+ * @brief Get the parent of a node that is not the root, in a B-heap.
+ * @details The parent of a block root is a leaf of the parent block; the
+ *  parent of any other node is in the same block.
+ * @param index The index of the child node.
+ * @return The index of the parent.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<std::size_t PageBytes>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+parent(size_type index, BHeapLayout<PageBytes>) const noexcept
 {
-  mPtr = mAlloc.allocate(mSize);
+  using shape = detail::BHeapGeometry<PageBytes, sizeof(T)>;
+  constexpr size_type shift = shape::shift;
+  constexpr size_type mask = shape::slots - 1;
+
+  auto offset = index & mask;
+  if (offset)
+    return (index & ~mask) + (offset >> 1);
+
+  // each leaf of the parent block has two child blocks
+  auto b = (index >> shift) - 1;
+  return ((b >> shift) << shift) + shape::leaves + ((b & mask) >> 1);
 }
-#endif
 
 /**
- * @brief Iterator range constructor.
- * @param first The iterator to the beginning of the range.
- * @param last One past the last iterator.
- * @throw May throw memory allocatoin failure.
+ * @brief Get the first child of a node in a flat heap.
+ * @param index The index of the parent node.
+ * @param stride Set to 1, since the children are contiguous.
+ * @return The index of the first child.
+ * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-  template<typename InputIterator, typename>
-PriorityQueue<T, Compare, Alloc>::
-PriorityQueue(InputIterator first, InputIterator last)
-  : mPtr(nullptr),
-    mAlloc(),
-    mCompare(),
-    mSize(DEFAULT_SIZE),
-    mCount()
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+firstChild(size_type index, size_type& stride, FlatLayout) const noexcept
 {
-  mPtr = mAlloc.allocate(mSize);
+  stride = 1;
+  return index * Arity + 1;
+}
 
-  while (first != last)
-  {
-    emplace(*first);
-    ++first;
+/**
+ * @brief Get the first child of a node in a B-heap.
+ * @details The block root has one child, the next slot. The children of an
+ *  inner node of the subtree are contiguous in the same block. The children
+ *  of a leaf of the subtree are the roots of consecutive blocks.
+ * @param index The index of the parent node.
+ * @param stride Set to the distance between the children, or to a distance
+ *  that goes past the end if there is only one child.
+ * @return The index of the first child, or <em>mCount</em> if there is no
+ *  child.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<std::size_t PageBytes>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+firstChild
+  (size_type index, size_type& stride, BHeapLayout<PageBytes>) const noexcept
+{
+  using shape = detail::BHeapGeometry<PageBytes, sizeof(T)>;
+  constexpr size_type shift = shape::shift;
+  constexpr size_type mask = shape::slots - 1;
+
+  auto offset = index & mask;
+  if (offset == 0) {
+    stride = mCount - index - 1;
+    return index + 1;
   }
+
+  if (offset < shape::leaves) {
+    stride = 1;
+    return index + offset;
+  }
+
+  auto leaf = offset - shape::leaves;
+  auto child = (((index >> shift) << shift) + 1 + 2 * leaf) << shift;
+
+  stride = size_type(1) << shift;
+  return child < mCount ? child : mCount;
 }
 
 /**
- * @brief Destructor.
+ * @brief Get the last node that may have children in a flat heap.
+ * @return The parent of the last node.
+ * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-PriorityQueue<T, Compare, Alloc>::
-~PriorityQueue() noexcept
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+lastParent(FlatLayout) const noexcept
 {
-  for (auto i = mCount - 1; i >= 0; --i)
-    mAlloc.destroy(mPtr+i);
-
-  mAlloc.deallocate(mPtr, mSize);
+  return parent(mCount - 1, FlatLayout());
 }
 
 /**
- * @brief Determine if the queue is empty.
- * @return True if the queue is empty, false otherwise.
+ * @brief Get the last node that may have children in a B-heap.
+ * @details The parent of the last node is not always the last node with a
+ *  child, since the inner nodes of the last full block come after it.
+ * @return The last node.
+ * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-inline bool PriorityQueue<T, Compare, Alloc>::
-empty() const noexcept
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+  template<std::size_t PageBytes>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+lastParent(BHeapLayout<PageBytes>) const noexcept
 {
-  return mCount == 0;
+  return mCount - 1;
 }
 
 /**
- * @brief Get the size of the queue.
- * @return The size of the queue.
+ * @brief Bubble down a node to its right place.
+ * @param index The index of the current node.
+ * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-inline size_t PriorityQueue<T, Compare, Alloc>::
-size() const noexcept
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+bubbleDown(size_type index) noexcept
 {
-  return static_cast<size_t>(mCount);
+  assert(index < mCount);
+
+  auto val = std::move(mPtr[index]);
+  index = holeDown(index, val);
+  mPtr[index] = std::move(val);
 }
 
 /**
- * @brief Get the top value.
- * @return A copy of the top value in the queue.
+ * @brief Bubble up a node up the heap to its right place.
+ * @param index The index of the node.
+ * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-inline T PriorityQueue<T, Compare, Alloc>::
-top() const noexcept
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+bubbleUp(size_type index) noexcept
 {
-  return mPtr[0];
+  assert(index < mCount);
+
+  auto val = std::move(mPtr[index]);
+  index = holeUp(index, val);
+  mPtr[index] = std::move(val);
 }
 
 /**
- * @brief Push an item into the queue by copying the value.
- * @param value The value copied and pushed into the queue.
+ * @brief Move a hole down the heap to where a value belongs.
+ * @details Children that should be above the value are moved up into the hole,
+ *  one level at a time. The value itself is not touched, so the caller fills
+ *  the returned hole.
+ * @param hole The index of the hole.
+ * @param val The value that will fill the hole.
+ * @return The index of the hole after it moved down.
+ * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-inline void PriorityQueue<T, Compare, Alloc>::
-push(const value_type& value)
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+holeDown(size_type hole, const T& val) noexcept
 {
-  emplace(value);
+  auto i = familyMin(val, hole);
+  size_type levels = 0;
+
+  while (i != hole)
+  {
+    mPtr[hole] = std::move(mPtr[i]);
+    hole = i;
+    i = familyMin(val, hole);
+    ++levels;
+  }
+
+  mStats.moved(levels);
+  mStats.siftedDown(levels);
+  return hole;
 }
 
 /**
- * @brief Push an item into the queue by moving it.
- * @param value The value moved into the queue.
+ * @brief Find where the last value goes after the top is popped, moving a hole
+ *  down from the root.
+ * @param val The value that will fill the hole.
+ * @return The index of the hole.
+ * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-inline void PriorityQueue<T, Compare, Alloc>::
-push(value_type&& value)
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+popHole(const T& val, TopDownPop) noexcept
 {
-  emplace(std::move(value));
+  return holeDown(0, val);
 }
 
 /**
- * @brief Push an item into the queue by constructing it in place.
- * @param args The arguments used to construct the object.
+ * @brief Find where the last value goes after the top is popped, moving the
+ *  root hole down to a leaf and then back up.
+ * @details Only the children are compared on the way down, so each level costs
+ *  one comparison less than <em>holeDown</em>. The way back up is usually
+ *  short.
+ * @param val The value that will fill the hole.
+ * @return The index of the hole.
+ * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-  template<typename... Args>
-inline void PriorityQueue<T, Compare, Alloc>::
-emplace(Args&&... args)
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+popHole(const T& val, BottomUpPop) noexcept
 {
-  if (mCount < mSize) {
-    mAlloc.construct(mPtr+mCount, std::forward<Args>(args)...);
-    ++mCount;
-    bubbleUp(mCount-1);
-    return;
+  size_type hole = 0;
+  size_type stride;
+  auto first = firstChild(hole, stride);
+
+  size_type levels = 0;
+
+  while (first < mCount)
+  {
+    auto best = bestChild(first, stride);
+    mPtr[hole] = std::move(mPtr[best]);
+    hole = best;
+    first = firstChild(hole, stride);
+    ++levels;
   }
 
-  auto oldSize = mSize;
-  mSize <<= SIZE_MULT;
-  auto tmp = mAlloc.allocate(mSize);
+  mStats.moved(levels);
+  mStats.siftedDown(levels);
+  return holeUp(hole, val);
+}
 
-  // copy items
-  // TODO: catch any exceptions that may arise during construction
-  for (int i = 0; i < mCount; ++i)
-    mAlloc.construct(tmp+i, mPtr[i]);
+/**
+ * @brief Move a hole up the heap to where a value belongs.
+ * @details Parents that should be below the value are moved down into the
+ *  hole, one level at a time. The caller fills the returned hole.
+ * @param hole The index of the hole.
+ * @param val The value that will fill the hole.
+ * @return The index of the hole after it moved up.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+holeUp(size_type hole, const T& val) noexcept
+{
+  size_type levels = 0;
 
-  // destroy copies of items
-  for (int i = 0; i < mCount; ++i)
-    mAlloc.destroy(mPtr+i);
+  while (hole > 0)
+  {
+    auto i = parent(hole);
+    if (!compare(val, mPtr[i]))
+      break;
 
-  // swap and release resources
-  mAlloc.deallocate(mPtr, oldSize);
-  mPtr = tmp;
+    mPtr[hole] = std::move(mPtr[i]);
+    hole = i;
+    ++levels;
+  }
 
-  // emplace args
-  mAlloc.construct(mPtr+mCount, std::forward<Args>(args)...);
-  ++mCount;
-  bubbleUp(mCount-1);
+  mStats.moved(levels);
+  mStats.siftedUp(levels);
+  return hole;
 }
 
 /**
- * @brief Remove the top value from the heap.
- * @throw Does not throw if the destructor for <em>T</em> does not throw.
+ * @brief Arrange all the items into a heap, bottom-up.
+ * @details Floyd's method: bubble down every internal node, starting from the
+ *  last one. Takes linear time.
+ * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-inline void PriorityQueue<T, Compare, Alloc>::
-pop() noexcept(std::is_nothrow_destructible<T>::value)
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+void PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+heapify() noexcept
 {
-  if (mCount == 0)
+  if (mCount < 2)
     return;
 
-  auto last = mCount - 1;
+  for (auto i = lastParent() + 1; i-- > 0;)
+    bubbleDown(i);
+}
 
-  // No need to shuffle items if the last value is being popped
-  if (!last) {
-    mAlloc.destroy(mPtr+last);
-    --mCount;
+/**
+ * @brief Restore the heap after items were appended without bubbling up.
+ * @details Rebuilding the heap costs about <em>n</em> bubble down steps,
+ *  while bubbling up each new item costs up to the height of the heap per
+ *  item, so the heap is rebuilt when the appended batch is large.
+ * @param first The index of the first appended item. The items before it
+ *  already form a heap.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+void PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+restoreHeap(size_type first) noexcept
+{
+  if (first >= mCount)
+    return;
+
+  auto batch = mCount - first;
+  size_type height = 1;
+  for (auto n = mCount; n > 1; n /= Arity)
+    ++height;
+
+  if (batch * height > mCount) {
+    heapify();
     return;
   }
 
-  mPtr[0] = mPtr[last];
-  mAlloc.destroy(mPtr+last);
-  --mCount;
-  bubbleDown();
+  for (auto i = first; i < mCount; ++i)
+    bubbleUp(i);
 }
 
 /**
- * @return The current capacity of the priority queue.
- * @details The capacity refers to the total number of items that can be added to
- * the queue before it needs to be reallocated to a different chunk of memory.
+ * @brief Fill the nodes that were moved out by <em>pop_n</em> and restore the
+ *  heap.
+ * @details The holes form a subtree that holds the root, and a parent is
+ *  always popped before its children. The last items are moved into the holes
+ *  before them, and then each filled node is fixed like a bottom-up pop, with
+ *  the children before the parents. The whole heap is rebuilt when that is
+ *  cheaper.
+ * @param holes The indices of the moved out items, in the order they were
+ *  popped.
+ * @param tail Scratch space for at least as many indices as there are holes.
  * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-inline size_t PriorityQueue<T, Compare, Alloc>::
-capacity() const noexcept
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+void PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+fillHoles(const std::vector<size_type>& holes,
+          std::vector<size_type>& tail) noexcept
 {
-  return static_cast<size_t>(mSize);
+  // mark the holes among the last items, which are dropped instead of moved
+  auto last = mCount;
+  mCount -= holes.size();
+  tail.assign(holes.size(), 0);
+  for (auto index : holes)
+    if (index >= mCount)
+      tail[index - mCount] = 1;
+
+  auto from = mCount;
+  for (auto index : holes)
+  {
+    if (index >= mCount)
+      continue;
+
+    while (tail[from - mCount])
+      ++from;
+    mPtr[index] = std::move(mPtr[from++]);
+  }
+
+  for (auto i = mCount; i < last; ++i)
+    alloc_traits::destroy(mAlloc, mPtr+i);
+
+  size_type height = 1;
+  for (auto n = mCount; n > 1; n /= Arity)
+    ++height;
+
+  if (holes.size() * height > mCount) {
+    heapify();
+    return;
+  }
+
+  // the subtrees of a filled node are heaps by the time it is reached, so its
+  // hole goes down to a leaf comparing only the children, and then back up
+  for (auto it = holes.rbegin(); it != holes.rend(); ++it)
+  {
+    auto top = *it;
+    if (top >= mCount)
+      continue;
+
+    auto val = std::move(mPtr[top]);
+    size_type hole = top;
+    size_type stride;
+    size_type down = 0;
+    for (auto child = firstChild(hole, stride); child < mCount;
+         child = firstChild(hole, stride))
+    {
+      auto best = bestChild(child, stride);
+      mPtr[hole] = std::move(mPtr[best]);
+      hole = best;
+      ++down;
+    }
+
+    size_type up = 0;
+    while (hole != top && compare(val, mPtr[parent(hole)]))
+    {
+      auto i = parent(hole);
+      mPtr[hole] = std::move(mPtr[i]);
+      hole = i;
+      ++up;
+    }
+
+    mPtr[hole] = std::move(val);
+    mStats.moved(down + up);
+    mStats.siftedDown(down);
+    mStats.siftedUp(up);
+  }
 }
 
-// TODO: implement
-template<typename T, typename Compare, typename Alloc>
-inline std::string PriorityQueue<T, Compare, Alloc>::
-toString() const
+/**
+ * @brief Return the index of the node with the value that should be at the top
+ *  between a parent and its children.
+ * @param val The value held by the parent node.
+ * @param index The index of the parent node.
+ * @return The index of the node with the value that should at the top.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+familyMin(const T& val, size_type index) const noexcept
 {
-  return std::string();
+  assert(index < mCount);
+
+  size_type stride;
+  auto first = firstChild(index, stride);
+  if (first >= mCount)
+    return index;
+
+  // find the best child, then compare it once against the parent
+  auto best = bestChild(first, stride);
+  return compare(mPtr[best], val) ? best : index;
 }
 
-// TODO: implement
-template<typename T, typename Compare, typename Alloc>
-  template<typename Hash>
-inline size_t PriorityQueue<T, Compare, Alloc>::
-hashCode(const Hash& hsh) const noexcept
+/**
+ * @brief Compare two items, counting the call.
+ * @param a The first item.
+ * @param b The second item.
+ * @return True if <em>a</em> should be above <em>b</em>.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline bool
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+compare(const T& a, const T& b) const noexcept
 {
-  return 0;
+  mStats.compared();
+  return mCompare(a, b);
 }
 
 /**
- * @brief Get parent of the node at the given index.
- * @detail If negative, then index refers to root node.
- * @param index The index of the child node.
- * @return The index of the left child.
+ * @brief Find the best of the children of a node.
+ * @details A full set of contiguous children is searched with SIMD
+ *  instructions when <em>detail::ChildSelect</em> supports the key type, the
+ *  comparator, and the arity, and the CPU has them. Otherwise the children
+ *  are compared one by one.
+ * @param first The index of the first child.
+ * @param stride The distance between the children.
+ * @return The index of the first child that should be on top.
  * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-inline int PriorityQueue<T, Compare, Alloc>::
-parent(int index) const noexcept
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+bestChild(size_type first, size_type stride) const noexcept
 {
-  assert(index >= 0 && index < mCount);
-  return (index - 1) >> 1;
+  using select = detail::ChildSelect<T, Compare, Arity>;
+
+  if (select::vectorized && stride == 1 && mCount - first >= Arity &&
+      select::enabled()) {
+    mStats.compared(Arity - 1);
+    return first + select::best(std::addressof(mPtr[first]));
+  }
+
+  auto best = first;
+  auto i = first;
+  for (std::size_t k = 1; k < Arity; ++k)
+  {
+    i += stride;
+    if (i >= mCount)
+      break;
+
+    if (compare(mPtr[i], mPtr[best]))
+      best = i;
+  }
+
+  return best;
 }
 
 /**
- * @brief Get the left child of the node at the given index.
- * @detail If greater then <em>mSize</em>, then index refers to left most child
- *  node.
- * @param index The index of the parent node.
- * @return The index of the left child.
+ * @brief Get the capacity of a new buffer for at least <em>size</em> items.
+ * @details The capacity is rounded up to the inline buffer of the allocator
+ *  when the items fit in it and it is free.
+ * @param size The minimum capacity.
+ * @return The capacity to allocate.
  * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-inline int PriorityQueue<T, Compare, Alloc>::
-leftChild(int index) const noexcept
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+storageFor(size_type size) const noexcept
 {
-  assert(index >= 0 && index < mCount);
-  return (index << 1) + 1;
+  return storage_traits::capacity(mAlloc, size);
 }
 
 /**
- * @brief Get the right child of the node at the given index.
- * @detail If greater then <em>mSize</em>, then index refers to right most child
- *  node.
- * @param index The index of the parent node.
- * @return The index of the right child.
+ * @brief Move the items into a new buffer.
+ * @details Items are moved if their move constructor does not throw, and are
+ *  copied otherwise, so the queue is left intact if an exception is thrown.
+ *  If the allocator remaps buffers and the items are trivially copyable, the
+ *  allocator resizes the buffer instead.
+ * @param size The capacity of the new buffer. Must not be less than the
+ *  number of items.
+ * @throw May throw memory allocation failure, or an exception thrown by the
+ *  copy constructor of <em>T</em>.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+void PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+reallocate(size_type size)
+{
+  assert(size >= mCount);
+
+  size = storageFor(size);
+  mStats.reallocated(mCount * sizeof(T));
+
+  if (REMAPS) {
+    mPtr = storage_traits::resize(mAlloc, mPtr, mSize, size);
+    mSize = size;
+    return;
+  }
+
+  auto tmp = alloc_traits::allocate(mAlloc, size);
+
+  try {
+    relocate(tmp);
+  }
+  catch (...) {
+    alloc_traits::deallocate(mAlloc, tmp, size);
+    throw;
+  }
+
+  adopt(tmp, size);
+}
+
+/**
+ * @brief Move or copy the items into uninitialized memory.
+ * @details Items are moved if their move constructor does not throw, and are
+ *  copied otherwise. If an exception is thrown, the items constructed in
+ *  <em>ptr</em> are destroyed and the items in the queue are intact.
+ * @param ptr The destination, with room for at least <em>mCount</em> items.
+ * @throw May throw an exception thrown by the copy constructor of <em>T</em>.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+void PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+relocate(pointer ptr)
+{
+  size_type i = 0;
+  try {
+    for (; i < mCount; ++i)
+      alloc_traits::construct(mAlloc, ptr+i, std::move_if_noexcept(mPtr[i]));
+    mStats.moved(mCount);
+  }
+  catch (...) {
+    while (i > 0)
+      alloc_traits::destroy(mAlloc, ptr + --i);
+    throw;
+  }
+}
+
+/**
+ * @brief Release the current buffer and take ownership of another one.
+ * @details The items in the current buffer are destroyed. The count and the
+ *  hash are kept, since the new buffer holds the same items.
+ * @param ptr The new buffer.
+ * @param size The capacity of the new buffer.
  * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-inline int PriorityQueue<T, Compare, Alloc>::
-rightChild(int index) const noexcept
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+adopt(pointer ptr, size_type size) noexcept
 {
-  assert(index >= 0 && index < mCount);
-  return (index << 1) + 2;
+  for (auto i = mCount; i-- > 0;)
+    alloc_traits::destroy(mAlloc, mPtr + i);
+  if (mPtr)
+    alloc_traits::deallocate(mAlloc, mPtr, mSize);
+  mPtr = ptr;
+  mSize = size;
 }
 
 /**
- * @brief Bubble down a node to its right place.
- * @param index The index of the current node.
+ * @brief Destroy all the items, but keep the buffer.
  * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-inline void PriorityQueue<T, Compare, Alloc>::
-bubbleDown(int index) noexcept
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+inline void
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+destroyAll() noexcept
 {
-  assert(index >= 0 && index < mCount);
+  while (mCount > 0)
+    alloc_traits::destroy(mAlloc, mPtr + --mCount);
+  mHash.reset();
+}
 
-  auto val = mPtr[index];
-  auto i = familyMin(val, index);
+/**
+ * @brief Take the items of a queue that has its own allocator.
+ * @details The buffer of <em>cont</em> is taken over if it is not inline.
+ *  Otherwise, a buffer is allocated, which is the inline buffer of this queue
+ *  since the items fit in it, and the items are moved into it. Either way,
+ *  <em>cont</em> is left empty and without capacity.
+ * @param cont The queue whose items are taken. This queue must have no buffer.
+ * @throw Never throws.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+void PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+takeBuffer(PriorityQueue& cont) noexcept
+{
+  assert(mPtr == nullptr && mCount == 0);
 
-  while (i != index)
-  {
-    mPtr[index] = mPtr[i];
-    index = i;
-    i = familyMin(val, index);
+  mHash = cont.mHash;
+  if (!storage_traits::owns(cont.mAlloc, cont.mPtr)) {
+    mPtr = cont.mPtr;
+    mSize = cont.mSize;
+    mCount = cont.mCount;
+  }
+  else {
+    mSize = storageFor(cont.mSize);
+    mPtr = alloc_traits::allocate(mAlloc, mSize);
+
+    for (; mCount < cont.mCount; ++mCount)
+    {
+      alloc_traits::construct
+        (mAlloc, mPtr+mCount, std::move(cont.mPtr[mCount]));
+    }
+
+    cont.destroyAll();
+    alloc_traits::deallocate(cont.mAlloc, cont.mPtr, cont.mSize);
   }
 
-  mPtr[index] = val;
+  cont.mPtr = nullptr;
+  cont.mSize = 0;
+  cont.mCount = 0;
+  cont.mHash.reset();
 }
 
 /**
- * @brief Bubble up a node up the heap to its right place.
- * @param index The index of the node.
+ * @brief Swap the items of two queues when a buffer is inline.
+ * @details The buffers that are not inline are still handed over, so only
+ *  the items of inline buffers are moved.
+ * @param cont The other priority queue.
  * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-inline void PriorityQueue<T, Compare, Alloc>::
-bubbleUp(int index) noexcept
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+void PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+swapItems(PriorityQueue& cont) noexcept
 {
-  assert(index >= 0 && index < mCount);
-
-  auto val = mPtr[index];
-  auto i = parent(index);
-
-  while (i >= 0 && mCompare(val, mPtr[i]))
-  {
-    mPtr[index] = mPtr[i];
-    index = i;
-    i = parent(index);
-  }  
+  using std::swap;
 
-  mPtr[index] = val;
+  PriorityQueue tmp(std::move(cont));
+  swap(mCompare, cont.mCompare);
+  swap(mCompare, tmp.mCompare);
+  cont.takeBuffer(*this);
+  takeBuffer(tmp);
 }
 
 /**
- * @brief Return the index of the node with the value that should be at the top
- *  between a parent and its two children.
- * @param index The index of the parent node.
- * @return The index of the node with the value that should at the top.
+ * @brief Heap sort the items in place.
+ * @details The top is repeatedly swapped with the last item of a shrinking
+ *  heap, so the buffer ends up ordered from the last item that would be popped
+ *  to the first. The items stay in the buffer and the count is unchanged, but
+ *  the buffer is no longer a heap, so the caller must empty the queue.
+ * @return The number of items.
  * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
-inline int PriorityQueue<T, Compare, Alloc>::
-familyMin(const T& val, int index) const noexcept
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::size_type
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+sortInPlace() noexcept
 {
-  assert(index >= 0 && index < mCount);
+  auto count = mCount;
 
-  auto lc = leftChild(index);
-  auto rc = rightChild(index);
+  while (mCount > 1)
+  {
+    auto last = mCount - 1;
+    auto val = std::move(mPtr[last]);
+    mPtr[last] = std::move(mPtr[0]);
+    --mCount;
+    auto hole = popHole(val, Pop());
+    mPtr[hole] = std::move(val);
+  }
 
-  if (lc < mCount && mCompare(mPtr[lc], val))
-    return mCompare(mPtr[lc], mPtr[rc]) ? lc : rc;
+  mCount = count;
+  return static_cast<size_type>(count);
+}
 
-  if (rc < mCount && mCompare(mPtr[rc], val))
-    return rc;
+/**
+ * @brief Get a buffer holding the items of a snapshot, by mapping the file if
+ *  the allocator can, or by reading it.
+ * @param file The snapshot, past its header.
+ * @param count The number of items.
+ * @param size Set to the capacity of the buffer.
+ * @return The buffer.
+ * @throw std::system_error if the file is truncated or cannot be read, or
+ *  memory allocation failure.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
+typename
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::pointer
+PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>::
+readItems(std::FILE *file, size_type count, size_type& size)
+{
+  const size_type offset = detail::SnapshotHeader::OFFSET;
+
+  if (std::fseek(file, 0, SEEK_END) != 0)
+    throw std::system_error(errno, std::generic_category(), "snapshot seek");
+  auto length = std::ftell(file);
+  if (length < 0 || count > (std::numeric_limits<size_type>::max() - offset) /
+                              sizeof(T) ||
+      static_cast<size_type>(length) < offset + count * sizeof(T))
+    throw std::system_error(EINVAL, std::generic_category(),
+                            "snapshot truncated");
+
+  auto ptr = storage_traits::mapFile(mAlloc, file, offset, count, size);
+  if (ptr)
+    return ptr;
+
+  size = storageFor(std::max<size_type>(count, DEFAULT_SIZE));
+  ptr = alloc_traits::allocate(mAlloc, size);
+
+  errno = 0;
+  if (count > 0 &&
+      (std::fseek(file, static_cast<long>(offset), SEEK_SET) != 0 ||
+       std::fread(static_cast<void*>(ptr), sizeof(T), count, file) != count)) {
+    int err = errno ? errno : EIO;
+    alloc_traits::deallocate(mAlloc, ptr, size);
+    throw std::system_error(err, std::generic_category(), "snapshot read");
+  }
 
-  return index;
+  return ptr;
 }
 
 /**
@@ -582,19 +2889,20 @@ familyMin(const T& val, int index) const noexcept
  * @param pq The priority queue.
  * @return A reference to the output stream.
  */
-template<typename T, typename Compare, typename Alloc>
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
 std::ostream&
-operator<<(std::ostream& os, const PriorityQueue<T, Compare, Alloc>& pq)
+operator<<
+  (std::ostream& os,
+   const PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>&
+     pq)
 {
   os << "{";
 
-  auto last = pq.mCount - 1;
-  for (int i = 0; i < last; ++i)
-    os << pq.mPtr[i] << ", ";
-
-  os << pq.mPtr[last] << "}";
+  for (std::size_t i = 0; i < pq.mCount; ++i)
+    os << (i ? ", " : "") << pq.mPtr[i];
 
-  return os;
+  return os << "}";
 }
 
 /**
@@ -604,15 +2912,19 @@ operator<<(std::ostream& os, const PriorityQueue<T, Compare, Alloc>& pq)
  * @return True if the queues are equal, false otherwise.
  * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
 bool operator==
-  (const PriorityQueue<T, Compare, Alloc>& pq1,
-   const PriorityQueue<T, Compare, Alloc>& pq2) noexcept
+  (const PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>&
+     pq1,
+   const PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>&
+     pq2)
+  noexcept
 {
   if (pq1.mCount != pq2.mCount)
     return false;
 
-  for (int i = 0; i < pq1.mCount; ++i)
+  for (std::size_t i = 0; i < pq1.mCount; ++i)
   {
     if (pq1.mPtr[i] != pq2.mPtr[i])
       return false;
@@ -628,10 +2940,14 @@ bool operator==
  * @return True if the queues are not equal, false otherwise.
  * @throw Never throws.
  */
-template<typename T, typename Compare, typename Alloc>
+template<typename T, typename Compare, typename Alloc, std::size_t Arity,
+         typename Growth, typename Pop, typename Layout, typename Stats>
 bool operator!=
-  (const PriorityQueue<T, Compare, Alloc>& pq1,
-   const PriorityQueue<T, Compare, Alloc>& pq2) noexcept
+  (const PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>&
+     pq1,
+   const PriorityQueue<T, Compare, Alloc, Arity, Growth, Pop, Layout, Stats>&
+     pq2)
+  noexcept
 {
   return !(pq1 == pq2);
 }
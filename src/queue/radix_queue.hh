@@ -0,0 +1,368 @@
+/**
+ * @file radix_queue.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _RADIX_QUEUE_H
+#define _RADIX_QUEUE_H
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <cassert>
+
+namespace ospp {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * RadixPriorityQueue.
+ * @details A min priority queue for integer keys that is monotone: a pushed key
+ *  may never be less than the last key popped, which holds for event times and
+ *  path distances in Dijkstra's algorithm.
+ *
+ *  Keys are kept in buckets by the highest bit in which they differ from the
+ *  last popped key; bucket 0 holds the keys equal to it. When a pop finds
+ *  bucket 0 empty, the first non-empty bucket is split into the lower buckets
+ *  around its minimum. Each key moves down at most once per bit, so push and
+ *  pop cost O(log C) amortized, where C is the key range, and neither does a
+ *  comparison based sift. The minimum of every bucket and a mask of the
+ *  non-empty buckets are kept up to date as keys are pushed and redistributed,
+ *  so the new top after a pop is found without scanning a bucket.
+ */
+template
+<
+  typename T,
+  typename Alloc = std::allocator<T>
+>
+class RadixPriorityQueue
+{
+  static_assert(std::is_integral<T>::value,
+                "the radix priority queue requires integer keys");
+
+  using key_type = typename std::make_unsigned<T>::type;
+
+  /**
+   * The number of buckets: one for every bit of the key, plus bucket 0.
+   */
+  enum { BUCKETS = std::numeric_limits<key_type>::digits + 1 };
+
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using allocator_type = Alloc;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+
+  /**
+   * Initialize
+   */
+  explicit RadixPriorityQueue();
+  explicit RadixPriorityQueue(const allocator_type& alloc);
+
+  /**
+   * priority queue functionality
+   */
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  const_reference top() const noexcept;
+  void push(const value_type& value);
+  void pop();
+  void clear() noexcept;
+
+private:
+  using bucket_type = std::vector<value_type, allocator_type>;
+
+  /**
+   * helper functions
+   */
+  static key_type key(value_type value) noexcept;
+  static size_type bucket(value_type value, value_type last) noexcept;
+  size_type firstBucket() const noexcept;
+  void add(size_type index, value_type value);
+  void refill();
+
+  /**
+   * The buckets.
+   */
+  bucket_type mBuckets[BUCKETS];
+
+  /**
+   * The smallest key in each bucket, if not empty.
+   */
+  value_type mMins[BUCKETS];
+
+  /**
+   * A mask of the non-empty buckets, bit i - 1 for bucket i > 0.
+   */
+  unsigned long long mUsed;
+
+  /**
+   * The last key popped. Buckets are relative to it.
+   */
+  value_type mLast;
+
+  /**
+   * The smallest key in the queue, if not empty.
+   */
+  value_type mTop;
+
+  /**
+   * The number of items held by the priority queue.
+   */
+  size_type mCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Default ctor.
+ * @details The first key may be any value.
+ */
+template<typename T, typename Alloc>
+RadixPriorityQueue<T, Alloc>::
+RadixPriorityQueue()
+  : mBuckets(),
+    mMins(),
+    mUsed(),
+    mLast(std::numeric_limits<value_type>::min()),
+    mTop(),
+    mCount()
+{}
+
+/**
+ * @brief Constructor with one parameter.
+ * @param alloc The allocator for the buckets.
+ */
+template<typename T, typename Alloc>
+RadixPriorityQueue<T, Alloc>::
+RadixPriorityQueue(const allocator_type& alloc)
+  : mBuckets(),
+    mMins(),
+    mUsed(),
+    mLast(std::numeric_limits<value_type>::min()),
+    mTop(),
+    mCount()
+{
+  for (auto& b : mBuckets)
+    b = bucket_type(alloc);
+}
+
+/**
+ * @brief Determine if the queue is empty.
+ * @return True if the queue is empty, false otherwise.
+ */
+template<typename T, typename Alloc>
+inline bool RadixPriorityQueue<T, Alloc>::
+empty() const noexcept
+{
+  return mCount == 0;
+}
+
+/**
+ * @brief Get the size of the queue.
+ * @return The size of the queue.
+ */
+template<typename T, typename Alloc>
+inline typename RadixPriorityQueue<T, Alloc>::size_type
+RadixPriorityQueue<T, Alloc>::
+size() const noexcept
+{
+  return mCount;
+}
+
+/**
+ * @brief Get the top value.
+ * @return A reference to the smallest key. The queue must not be empty.
+ */
+template<typename T, typename Alloc>
+inline typename RadixPriorityQueue<T, Alloc>::const_reference
+RadixPriorityQueue<T, Alloc>::
+top() const noexcept
+{
+  assert(mCount > 0);
+  return mTop;
+}
+
+/**
+ * @brief Push a key into the queue.
+ * @param value The key. Must not be less than the last key popped.
+ * @throw May throw memory allocation failure.
+ */
+template<typename T, typename Alloc>
+inline void RadixPriorityQueue<T, Alloc>::
+push(const value_type& value)
+{
+  assert(key(value) >= key(mLast) && "keys must be monotone");
+
+  add(bucket(value, mLast), value);
+
+  if (mCount == 0 || key(value) < key(mTop))
+    mTop = value;
+
+  ++mCount;
+}
+
+/**
+ * @brief Remove the smallest key from the queue.
+ * @throw May throw memory allocation failure when a bucket is split, in which
+ *  case the queue is unchanged.
+ */
+template<typename T, typename Alloc>
+inline void RadixPriorityQueue<T, Alloc>::
+pop()
+{
+  if (mCount == 0)
+    return;
+
+  if (mBuckets[0].empty())
+    refill();
+
+  mBuckets[0].pop_back();
+  --mCount;
+
+  if (mCount)
+    mTop = mBuckets[0].empty() ? mMins[firstBucket()] : mLast;
+}
+
+/**
+ * @brief Remove all the keys.
+ * @details The monotone contract starts over, so the next key may be any value.
+ */
+template<typename T, typename Alloc>
+inline void RadixPriorityQueue<T, Alloc>::
+clear() noexcept
+{
+  for (auto& b : mBuckets)
+    b.clear();
+
+  mUsed = 0;
+  mLast = std::numeric_limits<value_type>::min();
+  mTop = value_type();
+  mCount = 0;
+}
+
+/**
+ * @brief Map a key to an unsigned key with the same order.
+ * @param value The key.
+ * @return The unsigned key.
+ */
+template<typename T, typename Alloc>
+inline typename RadixPriorityQueue<T, Alloc>::key_type
+RadixPriorityQueue<T, Alloc>::
+key(value_type value) noexcept
+{
+  // flip the sign bit of signed keys, so negative keys come first
+  return std::is_signed<value_type>::value
+    ? static_cast<key_type>(value) ^
+        (key_type(1) << (std::numeric_limits<key_type>::digits - 1))
+    : static_cast<key_type>(value);
+}
+
+/**
+ * @brief Get the bucket of a key.
+ * @param value The key.
+ * @param last The last key popped.
+ * @return One plus the index of the highest bit in which the key differs from
+ *  the last key popped, or 0 if they are equal.
+ */
+template<typename T, typename Alloc>
+inline typename RadixPriorityQueue<T, Alloc>::size_type
+RadixPriorityQueue<T, Alloc>::
+bucket(value_type value, value_type last) noexcept
+{
+  auto diff = static_cast<unsigned long long>(key(value) ^ key(last));
+
+  if (diff == 0)
+    return 0;
+
+  return static_cast<size_type>(
+    std::numeric_limits<unsigned long long>::digits - __builtin_clzll(diff));
+}
+
+/**
+ * @brief Get the first non-empty bucket.
+ * @details The queue must not be empty. Since every key is relative to the
+ *  last popped key, the smallest key in this bucket is the smallest key in the
+ *  queue.
+ * @return The index of the bucket.
+ */
+template<typename T, typename Alloc>
+inline typename RadixPriorityQueue<T, Alloc>::size_type
+RadixPriorityQueue<T, Alloc>::
+firstBucket() const noexcept
+{
+  if (not mBuckets[0].empty())
+    return 0;
+
+  assert(mUsed != 0);
+  return 1 + static_cast<size_type>(__builtin_ctzll(mUsed));
+}
+
+/**
+ * @brief Add a key to a bucket and update the minimum and the mask.
+ * @param index The index of the bucket.
+ * @param value The key.
+ * @throw May throw memory allocation failure, in which case the bucket is
+ *  unchanged.
+ */
+template<typename T, typename Alloc>
+inline void RadixPriorityQueue<T, Alloc>::
+add(size_type index, value_type value)
+{
+  auto& b = mBuckets[index];
+  bool least = b.empty() || key(value) < key(mMins[index]);
+
+  b.push_back(value);
+
+  if (least)
+    mMins[index] = value;
+
+  if (index)
+    mUsed |= 1ull << (index - 1);
+}
+
+/**
+ * @brief Split the first non-empty bucket around the smallest key.
+ * @details The smallest key becomes the last popped key, which it is about to
+ *  be, and every key in the bucket moves to a lower bucket, the smallest one
+ *  to bucket 0. The keys are copied before the last popped key changes, and
+ *  the lower buckets were empty, so a failure only has to clear them.
+ * @throw May throw memory allocation failure, in which case the queue is
+ *  unchanged.
+ */
+template<typename T, typename Alloc>
+void RadixPriorityQueue<T, Alloc>::
+refill()
+{
+  auto i = firstBucket();
+  auto& from = mBuckets[i];
+
+  try {
+    for (auto v : from)
+      add(bucket(v, mTop), v);
+  }
+  catch (...) {
+    for (size_type j = 0; j < i; ++j)
+      mBuckets[j].clear();
+    mUsed &= ~((1ull << (i - 1)) - 1);
+    throw;
+  }
+
+  mLast = mTop;
+  from.clear();
+  mUsed &= ~(1ull << (i - 1));
+}
+
+} // namespace ospp
+
+#endif /* _RADIX_QUEUE_H */
@@ -0,0 +1,635 @@
+/**
+ * @file ring_queue.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _RING_QUEUE_H
+#define _RING_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <cassert>
+
+namespace ospp {
+
+/**
+ * The producers and consumers a RingQueue is built for.
+ */
+enum class RingKind
+{
+  MPMC, //!< many producers, many consumers
+  MPSC, //!< many producers, one consumer
+  SPSC  //!< one producer, one consumer
+};
+
+namespace detail {
+
+/**
+ * Size of a cache line, used to keep the producer and consumer counters on
+ * separate lines.
+ */
+enum { CACHE_LINE = 64 };
+
+/**
+ * @brief Round up to a power of two.
+ * @param n The number to round up.
+ * @return The smallest power of two that is not less than <em>n</em>, and at
+ *  least 2.
+ */
+inline std::size_t ceilPowerOfTwo(std::size_t n) noexcept
+{
+  std::size_t p = 2;
+  while (p < n)
+    p <<= 1;
+  return p;
+}
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * RingQueue.
+ * @details A bounded lock-free FIFO queue on a ring buffer whose capacity is a
+ *  power of two.
+ *
+ *  The MPMC and MPSC kinds follow Vyukov's design: each slot has a sequence
+ *  number that tells producers when the slot is free and consumers when it
+ *  holds an item, so a producer or consumer claims a slot with a single
+ *  compare and swap on the tail or head. With a single consumer, the head is
+ *  advanced with a plain store. The SPSC kind is specialized below.
+ *
+ *  The try_ functions never block. <em>push</em> and <em>pop</em> spin,
+ *  yielding the thread, until they succeed.
+ */
+template<typename T, RingKind Kind = RingKind::MPMC>
+class RingQueue
+{
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using size_type = std::size_t;
+
+  /**
+   * Initialize
+   */
+  explicit RingQueue(size_type capacity);
+
+  RingQueue(const RingQueue&) = delete;
+  RingQueue& operator=(const RingQueue&) = delete;
+
+  /**
+   * Destructor
+   */
+  ~RingQueue() noexcept;
+
+  /**
+   * queue functionality
+   */
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type capacity() const noexcept;
+  bool try_push(const value_type& value);
+  bool try_push(value_type&& value);
+  template<typename... Args>
+  bool try_emplace(Args&&... args);
+  bool try_pop(value_type& value);
+  void push(const value_type& value);
+  void push(value_type&& value);
+  void pop(value_type& value);
+
+private:
+  /**
+   * A slot of the ring, with its sequence number.
+   */
+  struct Cell
+  {
+    std::atomic<size_type> seq;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+    T* item() noexcept { return reinterpret_cast<T*>(&storage); }
+  };
+
+  /**
+   * The ring.
+   */
+  std::unique_ptr<Cell[]> mCells;
+
+  /**
+   * The capacity minus one, used to wrap positions.
+   */
+  size_type mMask;
+
+  char mPad0[detail::CACHE_LINE];
+
+  /**
+   * The next position to push to.
+   */
+  std::atomic<size_type> mTail;
+
+  char mPad1[detail::CACHE_LINE];
+
+  /**
+   * The next position to pop from.
+   */
+  std::atomic<size_type> mHead;
+
+  char mPad2[detail::CACHE_LINE];
+};
+
+/**
+ * RingQueue with one producer and one consumer.
+ * @details The producer owns the tail and the consumer owns the head, so no
+ *  slot needs a sequence number. Each side keeps a cached copy of the other
+ *  side's counter and only reloads it when the ring looks full or empty.
+ */
+template<typename T>
+class RingQueue<T, RingKind::SPSC>
+{
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using size_type = std::size_t;
+
+  /**
+   * Initialize
+   */
+  explicit RingQueue(size_type capacity);
+
+  RingQueue(const RingQueue&) = delete;
+  RingQueue& operator=(const RingQueue&) = delete;
+
+  /**
+   * Destructor
+   */
+  ~RingQueue() noexcept;
+
+  /**
+   * queue functionality
+   */
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type capacity() const noexcept;
+  bool try_push(const value_type& value);
+  bool try_push(value_type&& value);
+  template<typename... Args>
+  bool try_emplace(Args&&... args);
+  bool try_pop(value_type& value);
+  void push(const value_type& value);
+  void push(value_type&& value);
+  void pop(value_type& value);
+
+private:
+  using storage_type =
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+  T* item(size_type pos) noexcept
+  { return reinterpret_cast<T*>(&mSlots[pos & mMask]); }
+
+  /**
+   * The ring.
+   */
+  std::unique_ptr<storage_type[]> mSlots;
+
+  /**
+   * The capacity minus one, used to wrap positions.
+   */
+  size_type mMask;
+
+  char mPad0[detail::CACHE_LINE];
+
+  /**
+   * The next position to push to, and the producer's copy of the head.
+   */
+  std::atomic<size_type> mTail;
+  size_type mCachedHead;
+
+  char mPad1[detail::CACHE_LINE];
+
+  /**
+   * The next position to pop from, and the consumer's copy of the tail.
+   */
+  std::atomic<size_type> mHead;
+  size_type mCachedTail;
+
+  char mPad2[detail::CACHE_LINE];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Constructor.
+ * @param capacity The minimum capacity, rounded up to a power of two.
+ * @throw May throw memory allocation failure.
+ */
+template<typename T, RingKind Kind>
+RingQueue<T, Kind>::
+RingQueue(size_type capacity)
+  : mCells(new Cell[detail::ceilPowerOfTwo(capacity)]),
+    mMask(detail::ceilPowerOfTwo(capacity) - 1),
+    mPad0(),
+    mTail(0),
+    mPad1(),
+    mHead(0),
+    mPad2()
+{
+  for (size_type i = 0; i <= mMask; ++i)
+    mCells[i].seq.store(i, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Destructor.
+ * @details Destroys the items left in the queue. No other thread may use the
+ *  queue.
+ */
+template<typename T, RingKind Kind>
+RingQueue<T, Kind>::
+~RingQueue() noexcept
+{
+  auto head = mHead.load(std::memory_order_relaxed);
+  auto tail = mTail.load(std::memory_order_relaxed);
+
+  for (; head != tail; ++head)
+    mCells[head & mMask].item()->~T();
+}
+
+/**
+ * @brief Determine if the queue is empty.
+ * @details The answer may be stale by the time it is returned if other threads
+ *  use the queue.
+ * @return True if the queue is empty, false otherwise.
+ */
+template<typename T, RingKind Kind>
+inline bool RingQueue<T, Kind>::
+empty() const noexcept
+{
+  return size() == 0;
+}
+
+/**
+ * @brief Get the number of items in the queue.
+ * @details The answer may be stale by the time it is returned if other threads
+ *  use the queue.
+ * @return The number of items.
+ */
+template<typename T, RingKind Kind>
+inline typename RingQueue<T, Kind>::size_type
+RingQueue<T, Kind>::
+size() const noexcept
+{
+  auto head = mHead.load(std::memory_order_acquire);
+  auto tail = mTail.load(std::memory_order_acquire);
+  return tail > head ? tail - head : 0;
+}
+
+/**
+ * @return The number of items the queue can hold.
+ */
+template<typename T, RingKind Kind>
+inline typename RingQueue<T, Kind>::size_type
+RingQueue<T, Kind>::
+capacity() const noexcept
+{
+  return mMask + 1;
+}
+
+/**
+ * @brief Push a copy of an item, unless the queue is full.
+ * @param value The value.
+ * @return True if the item was pushed.
+ */
+template<typename T, RingKind Kind>
+inline bool RingQueue<T, Kind>::
+try_push(const value_type& value)
+{
+  return try_emplace(value);
+}
+
+/**
+ * @brief Move an item into the queue, unless the queue is full.
+ * @param value The value, which is left untouched if the queue is full.
+ * @return True if the item was pushed.
+ */
+template<typename T, RingKind Kind>
+inline bool RingQueue<T, Kind>::
+try_push(value_type&& value)
+{
+  return try_emplace(std::move(value));
+}
+
+/**
+ * @brief Construct an item in the queue, unless the queue is full.
+ * @param args The arguments used to construct the object.
+ * @return True if the item was pushed.
+ * @throw If constructing the item throws, the slot is left claimed and the
+ *  queue stops making progress, so <em>T</em> should not throw here.
+ */
+template<typename T, RingKind Kind>
+  template<typename... Args>
+bool RingQueue<T, Kind>::
+try_emplace(Args&&... args)
+{
+  Cell *cell;
+  auto pos = mTail.load(std::memory_order_relaxed);
+
+  for (;;)
+  {
+    cell = &mCells[pos & mMask];
+    auto seq = cell->seq.load(std::memory_order_acquire);
+    auto dif = static_cast<std::ptrdiff_t>(seq - pos);
+
+    if (dif == 0)
+    {
+      if (mTail.compare_exchange_weak
+            (pos, pos + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (dif < 0)
+      return false;
+    else
+      pos = mTail.load(std::memory_order_relaxed);
+  }
+
+  ::new (static_cast<void*>(cell->item())) T(std::forward<Args>(args)...);
+  cell->seq.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+/**
+ * @brief Pop the oldest item, unless the queue is empty.
+ * @param value Set to the popped item, if any.
+ * @return True if an item was popped.
+ */
+template<typename T, RingKind Kind>
+bool RingQueue<T, Kind>::
+try_pop(value_type& value)
+{
+  Cell *cell;
+  auto pos = mHead.load(std::memory_order_relaxed);
+
+  for (;;)
+  {
+    cell = &mCells[pos & mMask];
+    auto seq = cell->seq.load(std::memory_order_acquire);
+    auto dif = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+
+    if (dif == 0)
+    {
+      // a single consumer owns the head and does not need to race for it
+      if (Kind == RingKind::MPSC)
+      {
+        mHead.store(pos + 1, std::memory_order_relaxed);
+        break;
+      }
+
+      if (mHead.compare_exchange_weak
+            (pos, pos + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (dif < 0)
+      return false;
+    else
+      pos = mHead.load(std::memory_order_relaxed);
+  }
+
+  auto item = cell->item();
+  value = std::move(*item);
+  item->~T();
+  cell->seq.store(pos + mMask + 1, std::memory_order_release);
+  return true;
+}
+
+/**
+ * @brief Push a copy of an item, waiting while the queue is full.
+ * @param value The value.
+ */
+template<typename T, RingKind Kind>
+inline void RingQueue<T, Kind>::
+push(const value_type& value)
+{
+  while (!try_emplace(value))
+    std::this_thread::yield();
+}
+
+/**
+ * @brief Move an item into the queue, waiting while the queue is full.
+ * @param value The value.
+ */
+template<typename T, RingKind Kind>
+inline void RingQueue<T, Kind>::
+push(value_type&& value)
+{
+  while (!try_emplace(std::move(value)))
+    std::this_thread::yield();
+}
+
+/**
+ * @brief Pop the oldest item, waiting while the queue is empty.
+ * @param value Set to the popped item.
+ */
+template<typename T, RingKind Kind>
+inline void RingQueue<T, Kind>::
+pop(value_type& value)
+{
+  while (!try_pop(value))
+    std::this_thread::yield();
+}
+
+/**
+ * @brief Constructor.
+ * @param capacity The minimum capacity, rounded up to a power of two.
+ * @throw May throw memory allocation failure.
+ */
+template<typename T>
+RingQueue<T, RingKind::SPSC>::
+RingQueue(size_type capacity)
+  : mSlots(new storage_type[detail::ceilPowerOfTwo(capacity)]),
+    mMask(detail::ceilPowerOfTwo(capacity) - 1),
+    mPad0(),
+    mTail(0),
+    mCachedHead(0),
+    mPad1(),
+    mHead(0),
+    mCachedTail(0),
+    mPad2()
+{}
+
+/**
+ * @brief Destructor.
+ * @details Destroys the items left in the queue. No other thread may use the
+ *  queue.
+ */
+template<typename T>
+RingQueue<T, RingKind::SPSC>::
+~RingQueue() noexcept
+{
+  auto head = mHead.load(std::memory_order_relaxed);
+  auto tail = mTail.load(std::memory_order_relaxed);
+
+  for (; head != tail; ++head)
+    item(head)->~T();
+}
+
+/**
+ * @brief Determine if the queue is empty.
+ * @return True if the queue is empty, false otherwise.
+ */
+template<typename T>
+inline bool RingQueue<T, RingKind::SPSC>::
+empty() const noexcept
+{
+  return size() == 0;
+}
+
+/**
+ * @brief Get the number of items in the queue.
+ * @return The number of items.
+ */
+template<typename T>
+inline typename RingQueue<T, RingKind::SPSC>::size_type
+RingQueue<T, RingKind::SPSC>::
+size() const noexcept
+{
+  auto head = mHead.load(std::memory_order_acquire);
+  auto tail = mTail.load(std::memory_order_acquire);
+  return tail > head ? tail - head : 0;
+}
+
+/**
+ * @return The number of items the queue can hold.
+ */
+template<typename T>
+inline typename RingQueue<T, RingKind::SPSC>::size_type
+RingQueue<T, RingKind::SPSC>::
+capacity() const noexcept
+{
+  return mMask + 1;
+}
+
+/**
+ * @brief Push a copy of an item, unless the queue is full.
+ * @param value The value.
+ * @return True if the item was pushed.
+ */
+template<typename T>
+inline bool RingQueue<T, RingKind::SPSC>::
+try_push(const value_type& value)
+{
+  return try_emplace(value);
+}
+
+/**
+ * @brief Move an item into the queue, unless the queue is full.
+ * @param value The value, which is left untouched if the queue is full.
+ * @return True if the item was pushed.
+ */
+template<typename T>
+inline bool RingQueue<T, RingKind::SPSC>::
+try_push(value_type&& value)
+{
+  return try_emplace(std::move(value));
+}
+
+/**
+ * @brief Construct an item in the queue, unless the queue is full.
+ * @details Must only be called by the producer thread.
+ * @param args The arguments used to construct the object.
+ * @return True if the item was pushed.
+ */
+template<typename T>
+  template<typename... Args>
+bool RingQueue<T, RingKind::SPSC>::
+try_emplace(Args&&... args)
+{
+  auto tail = mTail.load(std::memory_order_relaxed);
+
+  if (tail - mCachedHead > mMask)
+  {
+    mCachedHead = mHead.load(std::memory_order_acquire);
+    if (tail - mCachedHead > mMask)
+      return false;
+  }
+
+  ::new (static_cast<void*>(item(tail))) T(std::forward<Args>(args)...);
+  mTail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+/**
+ * @brief Pop the oldest item, unless the queue is empty.
+ * @details Must only be called by the consumer thread.
+ * @param value Set to the popped item, if any.
+ * @return True if an item was popped.
+ */
+template<typename T>
+bool RingQueue<T, RingKind::SPSC>::
+try_pop(value_type& value)
+{
+  auto head = mHead.load(std::memory_order_relaxed);
+
+  if (head == mCachedTail)
+  {
+    mCachedTail = mTail.load(std::memory_order_acquire);
+    if (head == mCachedTail)
+      return false;
+  }
+
+  auto p = item(head);
+  value = std::move(*p);
+  p->~T();
+  mHead.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+/**
+ * @brief Push a copy of an item, waiting while the queue is full.
+ * @param value The value.
+ */
+template<typename T>
+inline void RingQueue<T, RingKind::SPSC>::
+push(const value_type& value)
+{
+  while (!try_emplace(value))
+    std::this_thread::yield();
+}
+
+/**
+ * @brief Move an item into the queue, waiting while the queue is full.
+ * @param value The value.
+ */
+template<typename T>
+inline void RingQueue<T, RingKind::SPSC>::
+push(value_type&& value)
+{
+  while (!try_emplace(std::move(value)))
+    std::this_thread::yield();
+}
+
+/**
+ * @brief Pop the oldest item, waiting while the queue is empty.
+ * @param value Set to the popped item.
+ */
+template<typename T>
+inline void RingQueue<T, RingKind::SPSC>::
+pop(value_type& value)
+{
+  while (!try_pop(value))
+    std::this_thread::yield();
+}
+
+} // namespace ospp
+
+#endif /* _RING_QUEUE_H */
@@ -0,0 +1,380 @@
+/**
+ * @file slot_table.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _SLOT_TABLE_H
+#define _SLOT_TABLE_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+namespace ospp {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * SlotTable.
+ * @details An array of items that grows at the end without ever moving the
+ *  items it holds. The items live in blocks of a fixed power of two size,
+ *  about a page each, and a table of pointers to the blocks is all that grows.
+ *  References to an item stay valid until it is popped or the table is
+ *  cleared or destroyed, and growing costs no moves or copies of the items.
+ *
+ *  Indexing takes a shift, a mask and one more load than a vector.
+ */
+template<typename T, typename Alloc = std::allocator<T>>
+class SlotTable
+{
+  using alloc_traits = std::allocator_traits<Alloc>;
+  using pointer = typename alloc_traits::pointer;
+  using block_alloc = typename alloc_traits::template rebind_alloc<pointer>;
+
+  /**
+   * @return The largest power of two that is not greater than <em>n</em>,
+   *  and at least <em>p</em>.
+   */
+  static constexpr std::size_t floorPowerOfTwo(std::size_t n, std::size_t p)
+    noexcept
+  {
+    return p * 2 > n ? p : floorPowerOfTwo(n, p * 2);
+  }
+
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using allocator_type = Alloc;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+
+  /**
+   * The number of items in a block: as many as fit in 4K, but at least 16.
+   */
+  static constexpr size_type block = floorPowerOfTwo(4096 / sizeof(T), 16);
+
+  /**
+   * Initialize
+   */
+  explicit SlotTable(const allocator_type& alloc = allocator_type());
+  SlotTable(const SlotTable& other);
+  SlotTable(SlotTable&& other) noexcept;
+
+  /**
+   * Assignment
+   */
+  SlotTable& operator=(const SlotTable& other);
+  SlotTable& operator=(SlotTable&& other) noexcept;
+
+  /**
+   * Destructor
+   */
+  ~SlotTable() noexcept;
+
+  /**
+   * table functionality
+   */
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type capacity() const noexcept;
+  reference operator[](size_type index) noexcept;
+  const_reference operator[](size_type index) const noexcept;
+  template<typename... Args>
+  reference emplace_back(Args&&... args);
+  void pop_back() noexcept;
+  void reserve(size_type size);
+  void clear() noexcept;
+  void swap(SlotTable& other) noexcept;
+
+private:
+  /**
+   * helper functions
+   */
+  void addBlock();
+  void release() noexcept;
+
+  /**
+   * The allocator for the items and the blocks.
+   */
+  allocator_type mAlloc;
+
+  /**
+   * The blocks, all of them full except maybe the last one in use.
+   */
+  std::vector<pointer, block_alloc> mBlocks;
+
+  /**
+   * The number of items.
+   */
+  size_type mCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Alloc>
+constexpr typename SlotTable<T, Alloc>::size_type SlotTable<T, Alloc>::block;
+
+/**
+ * @brief Constructor.
+ * @param alloc The allocator for the items.
+ */
+template<typename T, typename Alloc>
+SlotTable<T, Alloc>::
+SlotTable(const allocator_type& alloc)
+  : mAlloc(alloc),
+    mBlocks(block_alloc(alloc)),
+    mCount(0)
+{}
+
+/**
+ * @brief Copy constructor.
+ * @param other The table to copy.
+ * @throw May throw memory allocation failure, or an exception thrown while
+ *  copying an item.
+ */
+template<typename T, typename Alloc>
+SlotTable<T, Alloc>::
+SlotTable(const SlotTable& other)
+  : mAlloc(alloc_traits::select_on_container_copy_construction(other.mAlloc)),
+    mBlocks(block_alloc(mAlloc)),
+    mCount(0)
+{
+  try {
+    reserve(other.mCount);
+    for (size_type i = 0; i < other.mCount; ++i)
+      emplace_back(other[i]);
+  }
+  catch (...) {
+    release();
+    throw;
+  }
+}
+
+/**
+ * @brief Move constructor.
+ * @details The blocks are taken over, so the items do not move.
+ * @param other The table to move. It is left empty.
+ */
+template<typename T, typename Alloc>
+SlotTable<T, Alloc>::
+SlotTable(SlotTable&& other) noexcept
+  : mAlloc(std::move(other.mAlloc)),
+    mBlocks(std::move(other.mBlocks)),
+    mCount(other.mCount)
+{
+  other.mBlocks.clear();
+  other.mCount = 0;
+}
+
+/**
+ * @brief Copy assignment operator.
+ * @param other The table to copy.
+ * @return A reference to this table.
+ * @throw May throw memory allocation failure, or an exception thrown while
+ *  copying an item, in which case this table is unchanged.
+ */
+template<typename T, typename Alloc>
+SlotTable<T, Alloc>& SlotTable<T, Alloc>::
+operator=(const SlotTable& other)
+{
+  if (this != &other) {
+    SlotTable copy(other);
+    swap(copy);
+  }
+
+  return *this;
+}
+
+/**
+ * @brief Move assignment operator.
+ * @param other The table to move. It is left with the items of this table.
+ * @return A reference to this table.
+ */
+template<typename T, typename Alloc>
+SlotTable<T, Alloc>& SlotTable<T, Alloc>::
+operator=(SlotTable&& other) noexcept
+{
+  swap(other);
+  return *this;
+}
+
+/**
+ * @brief Destructor.
+ */
+template<typename T, typename Alloc>
+SlotTable<T, Alloc>::
+~SlotTable() noexcept
+{
+  release();
+}
+
+/**
+ * @return True if the table has no items.
+ */
+template<typename T, typename Alloc>
+inline bool SlotTable<T, Alloc>::
+empty() const noexcept
+{
+  return mCount == 0;
+}
+
+/**
+ * @return The number of items.
+ */
+template<typename T, typename Alloc>
+inline typename SlotTable<T, Alloc>::size_type SlotTable<T, Alloc>::
+size() const noexcept
+{
+  return mCount;
+}
+
+/**
+ * @return The number of items the blocks already allocated can hold.
+ */
+template<typename T, typename Alloc>
+inline typename SlotTable<T, Alloc>::size_type SlotTable<T, Alloc>::
+capacity() const noexcept
+{
+  return mBlocks.size() * block;
+}
+
+/**
+ * @param index The index of an item, less than the size.
+ * @return A reference to the item.
+ */
+template<typename T, typename Alloc>
+inline typename SlotTable<T, Alloc>::reference SlotTable<T, Alloc>::
+operator[](size_type index) noexcept
+{
+  assert(index < mCount);
+  return mBlocks[index / block][index % block];
+}
+
+/**
+ * @param index The index of an item, less than the size.
+ * @return A reference to the item.
+ */
+template<typename T, typename Alloc>
+inline typename SlotTable<T, Alloc>::const_reference SlotTable<T, Alloc>::
+operator[](size_type index) const noexcept
+{
+  assert(index < mCount);
+  return mBlocks[index / block][index % block];
+}
+
+/**
+ * @brief Construct an item at the end, allocating a block if needed.
+ * @param args The arguments used to construct the item.
+ * @return A reference to the item.
+ * @throw May throw memory allocation failure, or an exception thrown while
+ *  constructing the item, in which case the items are unchanged.
+ */
+template<typename T, typename Alloc>
+  template<typename... Args>
+typename SlotTable<T, Alloc>::reference SlotTable<T, Alloc>::
+emplace_back(Args&&... args)
+{
+  if (mCount == capacity())
+    addBlock();
+
+  auto ptr = mBlocks[mCount / block] + mCount % block;
+  alloc_traits::construct(mAlloc, ptr, std::forward<Args>(args)...);
+  ++mCount;
+  return *ptr;
+}
+
+/**
+ * @brief Destroy the last item. Its block is kept for later items.
+ */
+template<typename T, typename Alloc>
+inline void SlotTable<T, Alloc>::
+pop_back() noexcept
+{
+  assert(mCount > 0);
+  --mCount;
+  alloc_traits::destroy(mAlloc, mBlocks[mCount / block] + mCount % block);
+}
+
+/**
+ * @brief Allocate blocks for at least <em>size</em> items.
+ * @param size The minimum capacity.
+ * @throw May throw memory allocation failure.
+ */
+template<typename T, typename Alloc>
+void SlotTable<T, Alloc>::
+reserve(size_type size)
+{
+  mBlocks.reserve((size + block - 1) / block);
+  while (capacity() < size)
+    addBlock();
+}
+
+/**
+ * @brief Destroy all the items. The blocks are kept for later items.
+ */
+template<typename T, typename Alloc>
+void SlotTable<T, Alloc>::
+clear() noexcept
+{
+  while (mCount > 0)
+    pop_back();
+}
+
+/**
+ * @brief Swap the items of two tables.
+ * @param other The other table.
+ */
+template<typename T, typename Alloc>
+inline void SlotTable<T, Alloc>::
+swap(SlotTable& other) noexcept
+{
+  using std::swap;
+  swap(mAlloc, other.mAlloc);
+  mBlocks.swap(other.mBlocks);
+  swap(mCount, other.mCount);
+}
+
+/**
+ * @brief Allocate a block at the end of the block table.
+ * @throw May throw memory allocation failure, in which case the table is
+ *  unchanged.
+ */
+template<typename T, typename Alloc>
+void SlotTable<T, Alloc>::
+addBlock()
+{
+  auto ptr = alloc_traits::allocate(mAlloc, block);
+  try {
+    mBlocks.push_back(ptr);
+  }
+  catch (...) {
+    alloc_traits::deallocate(mAlloc, ptr, block);
+    throw;
+  }
+}
+
+/**
+ * @brief Destroy the items and free the blocks.
+ */
+template<typename T, typename Alloc>
+void SlotTable<T, Alloc>::
+release() noexcept
+{
+  clear();
+  for (auto ptr : mBlocks)
+    alloc_traits::deallocate(mAlloc, ptr, block);
+  mBlocks.clear();
+}
+
+} // namespace ospp
+
+#endif // _SLOT_TABLE_H
@@ -0,0 +1,609 @@
+/**
+ * @file static_queue.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _STATIC_QUEUE_H
+#define _STATIC_QUEUE_H
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <cassert>
+
+#include "queue/queue.hh"
+
+namespace ospp {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * StaticPriorityQueue.
+ * @details A binary heap with room for <em>N</em> items stored inside the
+ *  object, for small queues that live on the stack or inside another object.
+ *  It never allocates memory, and it has no allocator.
+ *
+ *  The height of the heap is known at compile time, so the sift loops are
+ *  unrolled into one step per level. Pushing into a full queue is an error;
+ *  use <em>try_push</em> when the queue may be full.
+ */
+template
+<
+  typename T,
+  std::size_t N,
+  typename Compare = std::less<T>
+>
+class StaticPriorityQueue
+{
+  static_assert(N > 0, "the queue must have room for at least one item");
+
+  /**
+   * The number of levels below the root.
+   */
+  using height = std::integral_constant
+    <std::size_t, detail::log2(detail::floorPowerOfTwo(N))>;
+
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+  using compare_type = Compare;
+
+  /**
+   * Initialize
+   */
+  explicit StaticPriorityQueue(const compare_type& comp = compare_type());
+
+  /**
+   * Copy Construct
+   */
+  StaticPriorityQueue(const StaticPriorityQueue& cont);
+  StaticPriorityQueue(StaticPriorityQueue&& cont)
+    noexcept(std::is_nothrow_move_constructible<T>::value);
+
+  /**
+   * Assignment
+   */
+  StaticPriorityQueue& operator=(const StaticPriorityQueue& cont);
+  StaticPriorityQueue& operator=(StaticPriorityQueue&& cont)
+    noexcept(std::is_nothrow_move_constructible<T>::value);
+
+  /**
+   * Destructor
+   */
+  ~StaticPriorityQueue() noexcept;
+
+  /**
+   * priority queue functionality
+   */
+  bool empty() const noexcept;
+  bool full() const noexcept;
+  size_type size() const noexcept;
+  static constexpr size_type capacity() noexcept { return N; }
+  const_reference top() const noexcept;
+  void push(const value_type& value);
+  void push(value_type&& value);
+  template<typename... Args>
+  void emplace(Args&&... args);
+  bool try_push(const value_type& value);
+  bool try_push(value_type&& value);
+  void pop() noexcept(std::is_nothrow_destructible<T>::value);
+  value_type pop_value();
+  void replace_top(const value_type& value);
+  void replace_top(value_type&& value);
+  void clear() noexcept;
+
+private:
+  /**
+   * helper functions
+   */
+  T *at(size_type index) noexcept;
+  const T *at(size_type index) const noexcept;
+  void copyItems(const StaticPriorityQueue& cont);
+  void moveItems(StaticPriorityQueue& cont);
+  template<std::size_t Levels>
+  size_type holeDown
+    (size_type hole, const T& val,
+     std::integral_constant<std::size_t, Levels>) noexcept;
+  size_type holeDown
+    (size_type hole, const T& val,
+     std::integral_constant<std::size_t, 0>) noexcept;
+  template<std::size_t Levels>
+  size_type holeUp
+    (size_type hole, const T& val,
+     std::integral_constant<std::size_t, Levels>) noexcept;
+  size_type holeUp
+    (size_type hole, const T& val,
+     std::integral_constant<std::size_t, 0>) noexcept;
+
+  /**
+   * The storage for the items.
+   */
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type mData[N];
+
+  /**
+   * The comparator.
+   */
+  compare_type mCompare;
+
+  /**
+   * The number of items held by the queue.
+   */
+  size_type mCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Constructor.
+ * @details No item is constructed.
+ * @param comp The object used to compare items.
+ */
+template<typename T, std::size_t N, typename Compare>
+StaticPriorityQueue<T, N, Compare>::
+StaticPriorityQueue(const compare_type& comp)
+  : mCompare(comp),
+    mCount()
+{}
+
+/**
+ * @brief Copy constructor.
+ * @param cont The queue being copied.
+ * @throw May throw an exception thrown by the copy constructor of <em>T</em>.
+ *  The items copied before the exception are destroyed.
+ */
+template<typename T, std::size_t N, typename Compare>
+StaticPriorityQueue<T, N, Compare>::
+StaticPriorityQueue(const StaticPriorityQueue& cont)
+  : mCompare(cont.mCompare),
+    mCount()
+{
+  copyItems(cont);
+}
+
+/**
+ * @brief Move constructor.
+ * @details The items are moved one by one, since they are stored inline.
+ *  <em>cont</em> keeps its items, in a moved-from state.
+ * @param cont The queue being moved.
+ */
+template<typename T, std::size_t N, typename Compare>
+StaticPriorityQueue<T, N, Compare>::
+StaticPriorityQueue(StaticPriorityQueue&& cont)
+  noexcept(std::is_nothrow_move_constructible<T>::value)
+  : mCompare(std::move(cont.mCompare)),
+    mCount()
+{
+  moveItems(cont);
+}
+
+/**
+ * @brief Copy assignment.
+ * @param cont The queue being copied.
+ * @return A reference to this queue.
+ * @throw Same as the copy constructor. The queue is left empty if an
+ *  exception is thrown.
+ */
+template<typename T, std::size_t N, typename Compare>
+StaticPriorityQueue<T, N, Compare>&
+StaticPriorityQueue<T, N, Compare>::
+operator=(const StaticPriorityQueue& cont)
+{
+  if (this != &cont)
+  {
+    clear();
+    mCompare = cont.mCompare;
+    copyItems(cont);
+  }
+
+  return *this;
+}
+
+/**
+ * @brief Move assignment.
+ * @param cont The queue being moved.
+ * @return A reference to this queue.
+ */
+template<typename T, std::size_t N, typename Compare>
+StaticPriorityQueue<T, N, Compare>&
+StaticPriorityQueue<T, N, Compare>::
+operator=(StaticPriorityQueue&& cont)
+  noexcept(std::is_nothrow_move_constructible<T>::value)
+{
+  if (this != &cont)
+  {
+    clear();
+    mCompare = std::move(cont.mCompare);
+    moveItems(cont);
+  }
+
+  return *this;
+}
+
+/**
+ * @brief Destructor.
+ */
+template<typename T, std::size_t N, typename Compare>
+StaticPriorityQueue<T, N, Compare>::
+~StaticPriorityQueue() noexcept
+{
+  clear();
+}
+
+/**
+ * @brief Determine if the queue is empty.
+ * @return True if the queue is empty, false otherwise.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline bool StaticPriorityQueue<T, N, Compare>::
+empty() const noexcept
+{
+  return mCount == 0;
+}
+
+/**
+ * @brief Determine if the queue holds <em>N</em> items.
+ * @return True if the queue is full, false otherwise.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline bool StaticPriorityQueue<T, N, Compare>::
+full() const noexcept
+{
+  return mCount == N;
+}
+
+/**
+ * @brief Get the size of the queue.
+ * @return The number of items in the queue.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline typename StaticPriorityQueue<T, N, Compare>::size_type
+StaticPriorityQueue<T, N, Compare>::
+size() const noexcept
+{
+  return mCount;
+}
+
+/**
+ * @brief Get the top value.
+ * @return A reference to the top value. The queue must not be empty.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline typename StaticPriorityQueue<T, N, Compare>::const_reference
+StaticPriorityQueue<T, N, Compare>::
+top() const noexcept
+{
+  assert(mCount > 0);
+  return *at(0);
+}
+
+/**
+ * @brief Push an item into the queue by copying the value.
+ * @param value The value copied into the queue. The queue must not be full.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline void StaticPriorityQueue<T, N, Compare>::
+push(const value_type& value)
+{
+  emplace(value);
+}
+
+/**
+ * @brief Push an item into the queue by moving it.
+ * @param value The value moved into the queue. The queue must not be full.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline void StaticPriorityQueue<T, N, Compare>::
+push(value_type&& value)
+{
+  emplace(std::move(value));
+}
+
+/**
+ * @brief Push an item into the queue by constructing it in place.
+ * @details The item is constructed in the first free slot and then bubbled
+ *  up. The queue must not be full.
+ * @param args The arguments used to construct the object.
+ * @throw May throw an exception thrown while constructing the item. The queue
+ *  is unchanged if an exception is thrown.
+ */
+template<typename T, std::size_t N, typename Compare>
+  template<typename... Args>
+inline void StaticPriorityQueue<T, N, Compare>::
+emplace(Args&&... args)
+{
+  assert(mCount < N);
+
+  auto slot = at(mCount);
+  ::new (slot) T(std::forward<Args>(args)...);
+  ++mCount;
+
+  auto val = std::move(*slot);
+  auto hole = holeUp(mCount - 1, val, height());
+  *at(hole) = std::move(val);
+}
+
+/**
+ * @brief Push a copy of an item, unless the queue is full.
+ * @param value The value.
+ * @return True if the item was pushed, false if the queue is full.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline bool StaticPriorityQueue<T, N, Compare>::
+try_push(const value_type& value)
+{
+  if (mCount == N)
+    return false;
+
+  emplace(value);
+  return true;
+}
+
+/**
+ * @brief Move an item into the queue, unless the queue is full.
+ * @param value The value, which is left untouched if the queue is full.
+ * @return True if the item was pushed, false if the queue is full.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline bool StaticPriorityQueue<T, N, Compare>::
+try_push(value_type&& value)
+{
+  if (mCount == N)
+    return false;
+
+  emplace(std::move(value));
+  return true;
+}
+
+/**
+ * @brief Remove the top value from the queue.
+ * @throw Does not throw if the destructor for <em>T</em> does not throw.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline void StaticPriorityQueue<T, N, Compare>::
+pop() noexcept(std::is_nothrow_destructible<T>::value)
+{
+  if (mCount == 0)
+    return;
+
+  auto last = at(--mCount);
+  if (mCount == 0) {
+    last->~T();
+    return;
+  }
+
+  // move the last value out and drop it into the hole left by the top
+  auto val = std::move(*last);
+  last->~T();
+  auto hole = holeDown(0, val, height());
+  *at(hole) = std::move(val);
+}
+
+/**
+ * @brief Remove the top value from the queue and return it.
+ * @return The top value, moved out of the queue. The queue must not be empty.
+ * @throw May throw if moving <em>T</em> throws.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline T StaticPriorityQueue<T, N, Compare>::
+pop_value()
+{
+  assert(mCount > 0);
+
+  auto val = std::move(*at(0));
+  pop();
+  return val;
+}
+
+/**
+ * @brief Replace the top value with another one.
+ * @details Same as a pop followed by a push, but with a single bubble down.
+ * @param value The value copied into the queue. The queue must not be empty.
+ * @throw May throw if copying <em>T</em> throws.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline void StaticPriorityQueue<T, N, Compare>::
+replace_top(const value_type& value)
+{
+  assert(mCount > 0);
+
+  auto hole = holeDown(0, value, height());
+  *at(hole) = value;
+}
+
+/**
+ * @brief Replace the top value with another one.
+ * @details Same as a pop followed by a push, but with a single bubble down.
+ * @param value The value moved into the queue. The queue must not be empty.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline void StaticPriorityQueue<T, N, Compare>::
+replace_top(value_type&& value)
+{
+  assert(mCount > 0);
+
+  auto hole = holeDown(0, value, height());
+  *at(hole) = std::move(value);
+}
+
+/**
+ * @brief Remove all the items.
+ * @throw Never throws.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline void StaticPriorityQueue<T, N, Compare>::
+clear() noexcept
+{
+  while (mCount > 0)
+    at(--mCount)->~T();
+}
+
+/**
+ * @brief Get the slot at the given index.
+ * @param index The index of the slot.
+ * @return A pointer to the slot.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline T *StaticPriorityQueue<T, N, Compare>::
+at(size_type index) noexcept
+{
+  return reinterpret_cast<T*>(&mData[index]);
+}
+
+/**
+ * @brief Get the slot at the given index.
+ * @param index The index of the slot.
+ * @return A pointer to the slot.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline const T *StaticPriorityQueue<T, N, Compare>::
+at(size_type index) const noexcept
+{
+  return reinterpret_cast<const T*>(&mData[index]);
+}
+
+/**
+ * @brief Copy the items of another queue into this empty one.
+ * @param cont The queue being copied.
+ * @throw May throw an exception thrown by the copy constructor of <em>T</em>.
+ *  The items copied before the exception are destroyed.
+ */
+template<typename T, std::size_t N, typename Compare>
+void StaticPriorityQueue<T, N, Compare>::
+copyItems(const StaticPriorityQueue& cont)
+{
+  try {
+    for (; mCount < cont.mCount; ++mCount)
+      ::new (at(mCount)) T(*cont.at(mCount));
+  }
+  catch (...) {
+    clear();
+    throw;
+  }
+}
+
+/**
+ * @brief Move the items of another queue into this empty one.
+ * @param cont The queue being moved, which keeps its items in a moved-from
+ *  state.
+ * @throw May throw an exception thrown by the move constructor of <em>T</em>.
+ *  The items moved before the exception are destroyed.
+ */
+template<typename T, std::size_t N, typename Compare>
+void StaticPriorityQueue<T, N, Compare>::
+moveItems(StaticPriorityQueue& cont)
+{
+  try {
+    for (; mCount < cont.mCount; ++mCount)
+      ::new (at(mCount)) T(std::move(*cont.at(mCount)));
+  }
+  catch (...) {
+    clear();
+    throw;
+  }
+}
+
+/**
+ * @brief Move a hole down the heap to where a value belongs.
+ * @details Each call handles one level and then calls the one for the level
+ *  below, so the whole sift is unrolled.
+ * @param hole The index of the hole.
+ * @param val The value that will fill the hole.
+ * @return The index of the hole after it moved down.
+ * @throw Never throws.
+ */
+template<typename T, std::size_t N, typename Compare>
+  template<std::size_t Levels>
+inline typename StaticPriorityQueue<T, N, Compare>::size_type
+StaticPriorityQueue<T, N, Compare>::
+holeDown
+  (size_type hole, const T& val,
+   std::integral_constant<std::size_t, Levels>) noexcept
+{
+  auto child = 2 * hole + 1;
+  if (child >= mCount)
+    return hole;
+
+  if (child + 1 < mCount && mCompare(*at(child + 1), *at(child)))
+    ++child;
+
+  if (!mCompare(*at(child), val))
+    return hole;
+
+  *at(hole) = std::move(*at(child));
+  return holeDown
+    (child, val, std::integral_constant<std::size_t, Levels - 1>());
+}
+
+/**
+ * @brief The hole is at the deepest level, so it stays where it is.
+ * @param hole The index of the hole.
+ * @return The index of the hole.
+ * @throw Never throws.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline typename StaticPriorityQueue<T, N, Compare>::size_type
+StaticPriorityQueue<T, N, Compare>::
+holeDown
+  (size_type hole, const T&, std::integral_constant<std::size_t, 0>) noexcept
+{
+  return hole;
+}
+
+/**
+ * @brief Move a hole up the heap to where a value belongs.
+ * @details Each call handles one level and then calls the one for the level
+ *  above, so the whole sift is unrolled.
+ * @param hole The index of the hole.
+ * @param val The value that will fill the hole.
+ * @return The index of the hole after it moved up.
+ * @throw Never throws.
+ */
+template<typename T, std::size_t N, typename Compare>
+  template<std::size_t Levels>
+inline typename StaticPriorityQueue<T, N, Compare>::size_type
+StaticPriorityQueue<T, N, Compare>::
+holeUp
+  (size_type hole, const T& val,
+   std::integral_constant<std::size_t, Levels>) noexcept
+{
+  if (hole == 0)
+    return hole;
+
+  auto parent = (hole - 1) / 2;
+  if (!mCompare(val, *at(parent)))
+    return hole;
+
+  *at(hole) = std::move(*at(parent));
+  return holeUp
+    (parent, val, std::integral_constant<std::size_t, Levels - 1>());
+}
+
+/**
+ * @brief The hole is at the root, so it stays where it is.
+ * @param hole The index of the hole.
+ * @return The index of the hole.
+ * @throw Never throws.
+ */
+template<typename T, std::size_t N, typename Compare>
+inline typename StaticPriorityQueue<T, N, Compare>::size_type
+StaticPriorityQueue<T, N, Compare>::
+holeUp
+  (size_type hole, const T&, std::integral_constant<std::size_t, 0>) noexcept
+{
+  return hole;
+}
+
+} // namespace ospp
+
+#endif /* _STATIC_QUEUE_H */
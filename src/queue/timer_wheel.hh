@@ -0,0 +1,677 @@
+/**
+ * @file timer_wheel.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _TIMER_WHEEL_H
+#define _TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+namespace ospp {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * TimerWheel.
+ * @details A hierarchical timer wheel, for timers that are mostly scheduled a
+ *  bounded time ahead and often cancelled before they expire. Time is counted
+ *  in integer ticks. Each of the <em>Levels</em> wheels has 64 slots, and a
+ *  slot of level <em>k</em> spans 64^k ticks, so the wheels cover 64^Levels
+ *  ticks ahead. Timers further ahead wait in the top wheel and go around it
+ *  again until they are close enough.
+ *
+ *  A timer goes in the slot of the highest level where its deadline differs
+ *  from the current time. Each slot is a circular doubly linked list of timers
+ *  threaded through a slot table, so scheduling and cancelling are O(1). When
+ *  <em>advance</em> reaches the start of a slot of a higher level, the timers
+ *  of the slot cascade to lower levels, and the timers of the level 0 slot of
+ *  each tick expire. A bitmap of the busy slots of each level lets
+ *  <em>advance</em> skip idle ticks.
+ *
+ *  Every timer gets a handle, which carries a generation count so that the
+ *  handle of an expired or cancelled timer never refers to a later timer that
+ *  reuses its slot.
+ */
+template
+<
+  typename T,
+  std::size_t Levels = 6,
+  typename Alloc = std::allocator<T>
+>
+class TimerWheel
+{
+  static_assert(Levels >= 2 && Levels <= 10,
+                "a timer wheel has between 2 and 10 levels");
+
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using allocator_type = Alloc;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+  using time_type = std::uint64_t;
+  using handle_type = std::uint64_t;
+
+  /**
+   * The number of levels and the number of slots per level.
+   */
+  static constexpr size_type levels = Levels;
+  static constexpr size_type slots = 64;
+
+  /**
+   * Initialize
+   */
+  explicit TimerWheel(time_type now = 0);
+  explicit TimerWheel(const allocator_type& alloc, time_type now = 0);
+
+  /**
+   * timer functionality
+   */
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  time_type now() const noexcept;
+  handle_type schedule(time_type deadline, const value_type& value);
+  handle_type schedule(time_type deadline, value_type&& value);
+  template<typename... Args>
+  handle_type emplace(time_type deadline, Args&&... args);
+  bool cancel(handle_type handle) noexcept;
+  template<typename Fun>
+  size_type advance(time_type now, Fun&& fun);
+  void reserve(size_type size);
+  void clear() noexcept;
+
+  /**
+   * handle functionality
+   */
+  bool contains(handle_type handle) const noexcept;
+  const_reference get(handle_type handle) const noexcept;
+  time_type deadline(handle_type handle) const noexcept;
+
+private:
+  enum : unsigned { SLOT_BITS = 6 };
+
+  /**
+   * A timer, linked into the list of its slot. <em>bucket</em> is the index
+   * of the slot over all levels, or <em>npos</em> if the entry is free, in
+   * which case <em>next</em> links it to the next free entry.
+   */
+  struct Entry
+  {
+    value_type value;
+    time_type deadline;
+    std::uint32_t prev;
+    std::uint32_t next;
+    std::uint32_t bucket;
+    std::uint32_t generation;
+
+    template<typename... Args>
+    Entry(time_type d, Args&&... args)
+      : value(std::forward<Args>(args)...), deadline(d), prev(0), next(0),
+        bucket(0), generation(0) {}
+  };
+
+  using alloc_traits = std::allocator_traits<Alloc>;
+  using entry_alloc = typename alloc_traits::template rebind_alloc<Entry>;
+
+  static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+  /**
+   * slot functions
+   */
+  static size_type digit(time_type time, size_type level) noexcept;
+  static size_type highestBit(std::uint64_t bits) noexcept;
+  static size_type lowestBit(std::uint64_t bits) noexcept;
+  handle_type handleOf(std::uint32_t index) const noexcept;
+  void place(std::uint32_t index, time_type key) noexcept;
+  void link(std::uint32_t index, std::uint32_t bucket) noexcept;
+  void unlink(std::uint32_t index) noexcept;
+  void release(std::uint32_t index) noexcept;
+  time_type nextEvent() const noexcept;
+  void cascade(size_type level) noexcept;
+  template<typename Fun>
+  size_type expire(Fun& fun);
+
+  /**
+   * The timers, indexed by the low half of the handle.
+   */
+  std::vector<Entry, entry_alloc> mEntries;
+
+  /**
+   * The first free entry, or <em>npos</em>. The free entries are chained
+   * through <em>next</em>, so freeing one never allocates.
+   */
+  std::uint32_t mFree;
+
+  /**
+   * The first timer of each slot, or <em>npos</em>.
+   */
+  std::uint32_t mHeads[Levels * slots];
+
+  /**
+   * The busy slots of each level.
+   */
+  std::uint64_t mBusy[Levels];
+
+  /**
+   * The current time.
+   */
+  time_type mNow;
+
+  /**
+   * The number of pending timers.
+   */
+  size_type mCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, std::size_t Levels, typename Alloc>
+constexpr typename TimerWheel<T, Levels, Alloc>::size_type
+TimerWheel<T, Levels, Alloc>::levels;
+
+template<typename T, std::size_t Levels, typename Alloc>
+constexpr typename TimerWheel<T, Levels, Alloc>::size_type
+TimerWheel<T, Levels, Alloc>::slots;
+
+template<typename T, std::size_t Levels, typename Alloc>
+constexpr std::uint32_t TimerWheel<T, Levels, Alloc>::npos;
+
+/**
+ * @brief Constructor.
+ * @param now The current time.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+TimerWheel<T, Levels, Alloc>::
+TimerWheel(time_type now)
+  : TimerWheel(allocator_type(), now)
+{}
+
+/**
+ * @brief Constructor with an allocator.
+ * @param alloc The allocator for the timers.
+ * @param now The current time.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+TimerWheel<T, Levels, Alloc>::
+TimerWheel(const allocator_type& alloc, time_type now)
+  : mEntries(entry_alloc(alloc)),
+    mFree(npos),
+    mNow(now),
+    mCount(0)
+{
+  for (auto& head : mHeads)
+    head = npos;
+  for (auto& busy : mBusy)
+    busy = 0;
+}
+
+/**
+ * @brief Determine if no timer is pending.
+ * @return True if empty, false otherwise.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline bool TimerWheel<T, Levels, Alloc>::
+empty() const noexcept
+{
+  return mCount == 0;
+}
+
+/**
+ * @return The number of pending timers.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline typename TimerWheel<T, Levels, Alloc>::size_type
+TimerWheel<T, Levels, Alloc>::
+size() const noexcept
+{
+  return mCount;
+}
+
+/**
+ * @return The current time, the last time passed to <em>advance</em>.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline typename TimerWheel<T, Levels, Alloc>::time_type
+TimerWheel<T, Levels, Alloc>::
+now() const noexcept
+{
+  return mNow;
+}
+
+/**
+ * @brief Schedule a timer with a copy of a value.
+ * @param deadline The time at which the timer expires.
+ * @param value The value.
+ * @return The handle of the timer.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline typename TimerWheel<T, Levels, Alloc>::handle_type
+TimerWheel<T, Levels, Alloc>::
+schedule(time_type deadline, const value_type& value)
+{
+  return emplace(deadline, value);
+}
+
+/**
+ * @brief Schedule a timer by moving a value.
+ * @param deadline The time at which the timer expires.
+ * @param value The value.
+ * @return The handle of the timer.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline typename TimerWheel<T, Levels, Alloc>::handle_type
+TimerWheel<T, Levels, Alloc>::
+schedule(time_type deadline, value_type&& value)
+{
+  return emplace(deadline, std::move(value));
+}
+
+/**
+ * @brief Schedule a timer with a value constructed in place.
+ * @details A deadline that is not after the current time expires on the next
+ *  tick.
+ * @param deadline The time at which the timer expires.
+ * @param args The arguments used to construct the value.
+ * @return The handle of the timer.
+ * @throw May throw memory allocation failure, or an exception thrown while
+ *  constructing the value. The wheel is unchanged if an exception is thrown.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+  template<typename... Args>
+typename TimerWheel<T, Levels, Alloc>::handle_type
+TimerWheel<T, Levels, Alloc>::
+emplace(time_type deadline, Args&&... args)
+{
+  std::uint32_t index;
+  if (mFree == npos)
+  {
+    assert(mEntries.size() < npos && "too many timers");
+    index = static_cast<std::uint32_t>(mEntries.size());
+    mEntries.emplace_back(deadline, std::forward<Args>(args)...);
+  }
+  else
+  {
+    index = mFree;
+    mEntries[index].value = value_type(std::forward<Args>(args)...);
+    mEntries[index].deadline = deadline;
+    mFree = mEntries[index].next;
+  }
+
+  place(index, deadline > mNow ? deadline : mNow + 1);
+  ++mCount;
+  return handleOf(index);
+}
+
+/**
+ * @brief Cancel a timer.
+ * @param handle The handle of the timer.
+ * @return True if the timer was pending, false if it already expired or was
+ *  cancelled.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline bool TimerWheel<T, Levels, Alloc>::
+cancel(handle_type handle) noexcept
+{
+  if (!contains(handle))
+    return false;
+
+  auto index = static_cast<std::uint32_t>(handle);
+  unlink(index);
+  release(index);
+  return true;
+}
+
+/**
+ * @brief Move the current time forward, expiring the timers that are due.
+ * @details Each expired timer is removed from the wheel and its value is
+ *  moved into <em>fun</em>, in the order of the deadlines. <em>fun</em> may
+ *  schedule and cancel timers; a timer it schedules for a past tick expires
+ *  on the next one. Ticks without a busy slot are skipped.
+ * @param now The new current time. Nothing happens if it is not after the
+ *  current time.
+ * @param fun The function called with the value of each expired timer.
+ * @return The number of expired timers.
+ * @throw May throw an exception thrown by <em>fun</em>, which is left at the
+ *  tick of the timer that threw.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+  template<typename Fun>
+typename TimerWheel<T, Levels, Alloc>::size_type
+TimerWheel<T, Levels, Alloc>::
+advance(time_type now, Fun&& fun)
+{
+  size_type expired = 0;
+  while (mNow < now)
+  {
+    auto next = mCount > 0 ? nextEvent() : now;
+    if (next > now) {
+      mNow = now;
+      break;
+    }
+
+    mNow = next;
+    for (auto level = Levels - 1; level > 0; --level)
+    {
+      if ((mNow & ((time_type(1) << (level * SLOT_BITS)) - 1)) == 0)
+        cascade(level);
+    }
+
+    expired += expire(fun);
+  }
+
+  return expired;
+}
+
+/**
+ * @brief Make room for at least <em>size</em> timers.
+ * @param size The minimum capacity.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline void TimerWheel<T, Levels, Alloc>::
+reserve(size_type size)
+{
+  mEntries.reserve(size);
+}
+
+/**
+ * @brief Cancel all the timers. All handles become invalid; the current time
+ *  does not change.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline void TimerWheel<T, Levels, Alloc>::
+clear() noexcept
+{
+  mEntries.clear();
+  mFree = npos;
+  for (auto& head : mHeads)
+    head = npos;
+  for (auto& busy : mBusy)
+    busy = 0;
+  mCount = 0;
+}
+
+/**
+ * @brief Determine if a handle refers to a pending timer.
+ * @param handle The handle.
+ * @return True if the timer has not expired or been cancelled, false
+ *  otherwise.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline bool TimerWheel<T, Levels, Alloc>::
+contains(handle_type handle) const noexcept
+{
+  auto index = static_cast<std::uint32_t>(handle);
+  return index < mEntries.size()
+    && mEntries[index].bucket != npos
+    && mEntries[index].generation == static_cast<std::uint32_t>(handle >> 32);
+}
+
+/**
+ * @brief Get the value of a timer.
+ * @param handle The handle of the timer, which must be pending.
+ * @return A reference to the value.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline typename TimerWheel<T, Levels, Alloc>::const_reference
+TimerWheel<T, Levels, Alloc>::
+get(handle_type handle) const noexcept
+{
+  assert(contains(handle));
+  return mEntries[static_cast<std::uint32_t>(handle)].value;
+}
+
+/**
+ * @brief Get the deadline of a timer.
+ * @param handle The handle of the timer, which must be pending.
+ * @return The deadline it was scheduled with.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline typename TimerWheel<T, Levels, Alloc>::time_type
+TimerWheel<T, Levels, Alloc>::
+deadline(handle_type handle) const noexcept
+{
+  assert(contains(handle));
+  return mEntries[static_cast<std::uint32_t>(handle)].deadline;
+}
+
+/**
+ * @brief Get the slot of a time in a level.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline typename TimerWheel<T, Levels, Alloc>::size_type
+TimerWheel<T, Levels, Alloc>::
+digit(time_type time, size_type level) noexcept
+{
+  return (time >> (level * SLOT_BITS)) & (slots - 1);
+}
+
+/**
+ * @return The index of the highest set bit. <em>bits</em> must not be 0.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline typename TimerWheel<T, Levels, Alloc>::size_type
+TimerWheel<T, Levels, Alloc>::
+highestBit(std::uint64_t bits) noexcept
+{
+  return 63 - __builtin_clzll(bits);
+}
+
+/**
+ * @return The index of the lowest set bit. <em>bits</em> must not be 0.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline typename TimerWheel<T, Levels, Alloc>::size_type
+TimerWheel<T, Levels, Alloc>::
+lowestBit(std::uint64_t bits) noexcept
+{
+  return __builtin_ctzll(bits);
+}
+
+/**
+ * @return The handle of the timer in an entry.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline typename TimerWheel<T, Levels, Alloc>::handle_type
+TimerWheel<T, Levels, Alloc>::
+handleOf(std::uint32_t index) const noexcept
+{
+  return static_cast<handle_type>(mEntries[index].generation) << 32 | index;
+}
+
+/**
+ * @brief Put a timer in the slot for a time.
+ * @details The level is the highest one where <em>key</em> and the current
+ *  time differ, or the top level if they differ above it.
+ * @param index The entry of the timer.
+ * @param key The time the slot is picked for, not before the current time.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline void TimerWheel<T, Levels, Alloc>::
+place(std::uint32_t index, time_type key) noexcept
+{
+  auto diff = key ^ mNow;
+  size_type level = diff ? highestBit(diff) / SLOT_BITS : 0;
+  if (level >= Levels)
+    level = Levels - 1;
+
+  link(index, static_cast<std::uint32_t>(level * slots + digit(key, level)));
+}
+
+/**
+ * @brief Append a timer to the list of a slot.
+ * @param index The entry of the timer.
+ * @param bucket The slot over all levels.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline void TimerWheel<T, Levels, Alloc>::
+link(std::uint32_t index, std::uint32_t bucket) noexcept
+{
+  auto& entry = mEntries[index];
+  entry.bucket = bucket;
+
+  auto first = mHeads[bucket];
+  if (first == npos)
+  {
+    entry.prev = entry.next = index;
+    mHeads[bucket] = index;
+    mBusy[bucket / slots] |= std::uint64_t(1) << (bucket % slots);
+    return;
+  }
+
+  auto last = mEntries[first].prev;
+  entry.prev = last;
+  entry.next = first;
+  mEntries[last].next = index;
+  mEntries[first].prev = index;
+}
+
+/**
+ * @brief Remove a timer from the list of its slot.
+ * @param index The entry of the timer.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+inline void TimerWheel<T, Levels, Alloc>::
+unlink(std::uint32_t index) noexcept
+{
+  auto& entry = mEntries[index];
+  auto bucket = entry.bucket;
+
+  if (entry.next == index)
+  {
+    mHeads[bucket] = npos;
+    mBusy[bucket / slots] &= ~(std::uint64_t(1) << (bucket % slots));
+    return;
+  }
+
+  mEntries[entry.prev].next = entry.next;
+  mEntries[entry.next].prev = entry.prev;
+  if (mHeads[bucket] == index)
+    mHeads[bucket] = entry.next;
+}
+
+/**
+ * @brief Free the entry of a timer that was unlinked.
+ * @param index The entry.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+void TimerWheel<T, Levels, Alloc>::
+release(std::uint32_t index) noexcept
+{
+  auto& entry = mEntries[index];
+  entry.bucket = npos;
+  entry.next = mFree;
+  ++entry.generation;
+  mFree = index;
+  --mCount;
+
+  // release the resources held by the value right away
+  static_cast<void>(value_type(std::move(entry.value)));
+}
+
+/**
+ * @brief Find the next tick where a slot cascades or expires.
+ * @details For each level, the next busy slot after the current one, going
+ *  around the wheel, starts at the first tick after the current time where
+ *  the level has that slot and the lower levels are at 0. Some timer must be
+ *  pending.
+ * @return The earliest such tick over all levels.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+typename TimerWheel<T, Levels, Alloc>::time_type
+TimerWheel<T, Levels, Alloc>::
+nextEvent() const noexcept
+{
+  auto next = ~time_type(0);
+  for (size_type level = 0; level < Levels; ++level)
+  {
+    auto busy = mBusy[level];
+    if (!busy)
+      continue;
+
+    // rotate so that bit 0 is the slot after the current one
+    auto shift = (digit(mNow, level) + 1) % slots;
+    auto rotated = shift ? busy >> shift | busy << (slots - shift) : busy;
+    auto distance = static_cast<time_type>(lowestBit(rotated) + 1);
+
+    auto width = level * SLOT_BITS;
+    auto tick = (mNow >> width << width) + (distance << width);
+    if (tick < next)
+      next = tick;
+  }
+
+  return next;
+}
+
+/**
+ * @brief Move the timers of the current slot of a level to lower levels.
+ * @details Timers further ahead than the wheels reach go back to the top
+ *  level.
+ * @param level The level, above 0.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+void TimerWheel<T, Levels, Alloc>::
+cascade(size_type level) noexcept
+{
+  auto bucket = level * slots + digit(mNow, level);
+  auto first = mHeads[bucket];
+  if (first == npos)
+    return;
+
+  mHeads[bucket] = npos;
+  mBusy[level] &= ~(std::uint64_t(1) << (bucket % slots));
+
+  auto last = mEntries[first].prev;
+  for (auto index = first;;)
+  {
+    auto next = mEntries[index].next;
+    auto deadline = mEntries[index].deadline;
+    place(index, deadline > mNow ? deadline : mNow);
+    if (index == last)
+      break;
+    index = next;
+  }
+}
+
+/**
+ * @brief Expire the timers of the level 0 slot of the current time.
+ * @param fun The function called with the value of each expired timer.
+ * @return The number of expired timers.
+ */
+template<typename T, std::size_t Levels, typename Alloc>
+  template<typename Fun>
+typename TimerWheel<T, Levels, Alloc>::size_type
+TimerWheel<T, Levels, Alloc>::
+expire(Fun& fun)
+{
+  auto bucket = digit(mNow, 0);
+  size_type expired = 0;
+
+  // fun may cancel or schedule timers, so the list is read again each time
+  while (mHeads[bucket] != npos)
+  {
+    auto index = mHeads[bucket];
+    unlink(index);
+    auto value = std::move(mEntries[index].value);
+    release(index);
+    ++expired;
+    fun(std::move(value));
+  }
+
+  return expired;
+}
+
+} // namespace ospp
+
+#endif /* _TIMER_WHEEL_H */
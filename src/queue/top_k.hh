@@ -0,0 +1,338 @@
+/**
+ * @file top_k.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _TOP_K_H
+#define _TOP_K_H
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "queue/queue.hh"
+#include "traits/iter_traits.hh"
+
+namespace ospp {
+
+/**
+ * Comparator that orders items the other way around.
+ */
+template<typename Compare>
+struct ReverseCompare
+{
+  Compare comp;
+
+  template<typename T>
+  bool operator()(const T& a, const T& b) const
+  {
+    return comp(b, a);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * TopK.
+ * @details Keeps the <em>K</em> best items of a stream, where the best items
+ *  are the ones a <em>PriorityQueue</em> with the same comparator would pop
+ *  first. The items are held in a <em>PriorityQueue</em> with the comparator
+ *  reversed, so the worst retained item is on top.
+ *
+ *  Once full, an offered item costs one comparison against the worst retained
+ *  item when it is rejected, and one bubble down when it replaces it. The
+ *  buffer is sized for <em>K</em> items up front and never grows.
+ */
+template
+<
+  typename T,
+  typename Compare = std::less<T>,
+  typename Alloc = std::allocator<T>,
+  std::size_t Arity = 2
+>
+class TopK
+{
+public:
+  /**
+   * Aliases
+   */
+  using value_type = T;
+  using allocator_type = Alloc;
+  using const_reference = const value_type&;
+  using size_type = std::size_t;
+  using compare_type = Compare;
+  using queue_type =
+    PriorityQueue<T, ReverseCompare<Compare>, Alloc, Arity>;
+
+  /**
+   * Initialize
+   */
+  explicit TopK(size_type k, const compare_type& comp = compare_type());
+
+  /**
+   * top-k functionality
+   */
+  bool empty() const noexcept;
+  bool full() const noexcept;
+  size_type size() const noexcept;
+  size_type capacity() const noexcept;
+  const_reference worst() const noexcept;
+  bool offer(const value_type& value);
+  bool offer(value_type&& value);
+  template
+  <
+    typename InputIterator,
+    typename = typename std::enable_if<is_input_iter<InputIterator>::value>::type
+  >
+  size_type offer(InputIterator first, InputIterator last);
+  template<typename OutputIterator>
+  OutputIterator drain_sorted(OutputIterator out);
+
+private:
+  template<typename InputIterator>
+  InputIterator fill
+    (InputIterator first, InputIterator last, std::input_iterator_tag);
+  template<typename ForwardIterator>
+  ForwardIterator fill
+    (ForwardIterator first, ForwardIterator last, std::forward_iterator_tag);
+
+  /**
+   * The retained items, worst on top.
+   */
+  queue_type mQueue;
+
+  /**
+   * The maximum number of items retained.
+   */
+  size_type mLimit;
+
+  /**
+   * The comparator.
+   */
+  compare_type mCompare;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Constructor.
+ * @param k The number of items to retain.
+ * @param comp The object used to compare items.
+ * @throw May throw memory allocation failure.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+TopK<T, Compare, Alloc, Arity>::
+TopK(size_type k, const compare_type& comp)
+  : mQueue(ReverseCompare<Compare>{comp}),
+    mLimit(k),
+    mCompare(comp)
+{
+  mQueue.reserve(k);
+}
+
+/**
+ * @brief Determine if no item is retained.
+ * @return True if empty, false otherwise.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline bool TopK<T, Compare, Alloc, Arity>::
+empty() const noexcept
+{
+  return mQueue.empty();
+}
+
+/**
+ * @brief Determine if <em>K</em> items are retained.
+ * @return True if full, false otherwise.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline bool TopK<T, Compare, Alloc, Arity>::
+full() const noexcept
+{
+  return mQueue.size() == mLimit;
+}
+
+/**
+ * @return The number of items retained.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline typename TopK<T, Compare, Alloc, Arity>::size_type
+TopK<T, Compare, Alloc, Arity>::
+size() const noexcept
+{
+  return mQueue.size();
+}
+
+/**
+ * @return The maximum number of items retained, <em>K</em>.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline typename TopK<T, Compare, Alloc, Arity>::size_type
+TopK<T, Compare, Alloc, Arity>::
+capacity() const noexcept
+{
+  return mLimit;
+}
+
+/**
+ * @brief Get the worst item retained.
+ * @return A reference to the item that the next accepted item would evict
+ *  when full. Must not be empty.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline typename TopK<T, Compare, Alloc, Arity>::const_reference
+TopK<T, Compare, Alloc, Arity>::
+worst() const noexcept
+{
+  return mQueue.top();
+}
+
+/**
+ * @brief Offer a copy of an item.
+ * @param value The value.
+ * @return True if the item was retained, false if it was rejected.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline bool TopK<T, Compare, Alloc, Arity>::
+offer(const value_type& value)
+{
+  if (mQueue.size() < mLimit) {
+    mQueue.push(value);
+    return true;
+  }
+
+  if (mLimit == 0 || !mCompare(value, mQueue.top()))
+    return false;
+
+  mQueue.replace_top(value);
+  return true;
+}
+
+/**
+ * @brief Offer an item by moving it.
+ * @param value The value, which is left untouched if rejected.
+ * @return True if the item was retained, false if it was rejected.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+inline bool TopK<T, Compare, Alloc, Arity>::
+offer(value_type&& value)
+{
+  if (mQueue.size() < mLimit) {
+    mQueue.push(std::move(value));
+    return true;
+  }
+
+  if (mLimit == 0 || !mCompare(value, mQueue.top()))
+    return false;
+
+  mQueue.replace_top(std::move(value));
+  return true;
+}
+
+/**
+ * @brief Offer a range of items.
+ * @details Until <em>K</em> items are retained, the items are pushed as a
+ *  batch; after that each item is compared against the worst one.
+ * @param first The iterator to the beginning of the range.
+ * @param last One past the last iterator.
+ * @return The number of items retained.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+  template<typename InputIterator, typename>
+typename TopK<T, Compare, Alloc, Arity>::size_type
+TopK<T, Compare, Alloc, Arity>::
+offer(InputIterator first, InputIterator last)
+{
+  using category =
+    typename std::iterator_traits<InputIterator>::iterator_category;
+
+  auto before = mQueue.size();
+  first = fill(first, last, category());
+  size_type accepted = mQueue.size() - before;
+
+  if (mLimit == 0)
+    return accepted;
+
+  for (; first != last; ++first)
+  {
+    if (mCompare(*first, mQueue.top())) {
+      mQueue.replace_top(*first);
+      ++accepted;
+    }
+  }
+
+  return accepted;
+}
+
+/**
+ * @brief Move the retained items out, best first.
+ * @details The items are heap sorted in place, so no memory is allocated.
+ *  Afterwards no item is retained.
+ * @param out The output iterator.
+ * @return The output iterator past the last item written.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+  template<typename OutputIterator>
+OutputIterator TopK<T, Compare, Alloc, Arity>::
+drain_sorted(OutputIterator out)
+{
+  // the queue pops the worst item first, so after sorting in place the best
+  // item is at the front of the buffer
+  auto count = mQueue.sortInPlace();
+  for (size_type i = 0; i < count; ++i)
+  {
+    *out = std::move(mQueue.mPtr[i]);
+    ++out;
+  }
+
+  mQueue.destroyAll();
+  return out;
+}
+
+/**
+ * @brief Push items of an input range until full.
+ * @param first The iterator to the beginning of the range.
+ * @param last One past the last iterator.
+ * @return The iterator to the first item not pushed.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+  template<typename InputIterator>
+InputIterator TopK<T, Compare, Alloc, Arity>::
+fill(InputIterator first, InputIterator last, std::input_iterator_tag)
+{
+  for (; first != last && mQueue.size() < mLimit; ++first)
+    mQueue.push(*first);
+
+  return first;
+}
+
+/**
+ * @brief Push items of a forward range as one batch until full.
+ * @param first The iterator to the beginning of the range.
+ * @param last One past the last iterator.
+ * @return The iterator to the first item not pushed.
+ */
+template<typename T, typename Compare, typename Alloc, std::size_t Arity>
+  template<typename ForwardIterator>
+ForwardIterator TopK<T, Compare, Alloc, Arity>::
+fill(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
+{
+  auto room = mLimit - mQueue.size();
+  auto mid = first;
+  for (size_type i = 0; i < room && mid != last; ++i)
+    ++mid;
+
+  mQueue.push_range(first, mid);
+  return mid;
+}
+
+} // namespace ospp
+
+#endif /* _TOP_K_H */
@@ -0,0 +1,265 @@
+/**
+ * @file worker_pool.hh
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+#ifndef _WORKER_POOL_H
+#define _WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ospp {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declaration
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * WorkerPool.
+ * @details A fixed set of threads that run batches of tasks. <em>run</em>
+ *  hands out the task indices of a batch to the workers and to the calling
+ *  thread, and returns when all of them are done, so a batch acts as a
+ *  barrier between steps of an algorithm. The threads are started once and
+ *  wait on a condition variable between batches.
+ *
+ *  Tasks must not throw; if one does, std::terminate is called.
+ */
+class WorkerPool
+{
+public:
+  /**
+   * Aliases
+   */
+  using size_type = std::size_t;
+
+  /**
+   * Initialize
+   */
+  explicit WorkerPool(size_type threads);
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * Destructor
+   */
+  ~WorkerPool() noexcept;
+
+  /**
+   * pool functionality
+   */
+  size_type threads() const noexcept;
+  template<typename Task>
+  void run(size_type count, const Task& task);
+
+private:
+  /**
+   * helper functions
+   */
+  template<typename Task>
+  static void invoke(const void *task, size_type index);
+  void work() noexcept;
+  void runTasks() noexcept;
+  void stop() noexcept;
+
+  /**
+   * The threads, not counting the one that calls <em>run</em>.
+   */
+  std::vector<std::thread> mWorkers;
+
+  /**
+   * Guards the batch and wakes the workers when a batch starts or ends.
+   */
+  std::mutex mLock;
+  std::condition_variable mStart;
+  std::condition_variable mDone;
+
+  /**
+   * The task of the current batch, and the function that calls it.
+   */
+  const void *mTask;
+  void (*mInvoke)(const void*, size_type);
+
+  /**
+   * The number of tasks in the batch, and the next one to hand out.
+   */
+  size_type mCount;
+  std::atomic<size_type> mNext;
+
+  /**
+   * Counts the batches, so that workers can tell a new one has started.
+   */
+  size_type mBatch;
+
+  /**
+   * The number of workers still working on the current batch.
+   */
+  size_type mBusy;
+
+  /**
+   * True when the workers should exit.
+   */
+  bool mStop;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Definition
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Constructor.
+ * @param threads The number of threads that run tasks, counting the thread
+ *  that calls <em>run</em>. With one thread or none, tasks run on the calling
+ *  thread only.
+ * @throw May throw std::system_error if a thread cannot be started, in which
+ *  case the threads already started are joined.
+ */
+inline WorkerPool::WorkerPool(size_type threads)
+  : mWorkers(),
+    mLock(),
+    mStart(),
+    mDone(),
+    mTask(nullptr),
+    mInvoke(nullptr),
+    mCount(),
+    mNext(0),
+    mBatch(),
+    mBusy(),
+    mStop(false)
+{
+  if (threads < 2)
+    return;
+
+  try {
+    mWorkers.reserve(threads - 1);
+    for (size_type i = 1; i < threads; ++i)
+      mWorkers.emplace_back(&WorkerPool::work, this);
+  }
+  catch (...) {
+    stop();
+    throw;
+  }
+}
+
+/**
+ * @brief Destructor.
+ * @details Stops and joins the workers.
+ */
+inline WorkerPool::~WorkerPool() noexcept
+{
+  stop();
+}
+
+/**
+ * @return The number of threads that run tasks, counting the calling thread.
+ */
+inline WorkerPool::size_type WorkerPool::threads() const noexcept
+{
+  return mWorkers.size() + 1;
+}
+
+/**
+ * @brief Run a batch of tasks on the pool.
+ * @details Each task index is handed out once, to whichever thread is free
+ *  first. The calling thread runs tasks too. Only one thread may call
+ *  <em>run</em> at a time.
+ * @param count The number of tasks.
+ * @param task Called as <em>task(i)</em> for each <em>i</em> in [0, count).
+ *  Called from several threads at once.
+ */
+template<typename Task>
+void WorkerPool::run(size_type count, const Task& task)
+{
+  if (mWorkers.empty() || count < 2) {
+    for (size_type i = 0; i < count; ++i)
+      task(i);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(mLock);
+    mTask = &task;
+    mInvoke = &WorkerPool::invoke<Task>;
+    mCount = count;
+    mNext = 0;
+    mBusy = mWorkers.size();
+    ++mBatch;
+  }
+
+  mStart.notify_all();
+  runTasks();
+
+  std::unique_lock<std::mutex> guard(mLock);
+  mDone.wait(guard, [this]() { return mBusy == 0; });
+  mTask = nullptr;
+}
+
+/**
+ * @brief Call a task through a type erased pointer.
+ * @param task Points to the task.
+ * @param index The index of the task.
+ */
+template<typename Task>
+void WorkerPool::invoke(const void *task, size_type index)
+{
+  (*static_cast<const Task*>(task))(index);
+}
+
+/**
+ * @brief The loop of a worker: wait for a batch, run its tasks, repeat.
+ */
+inline void WorkerPool::work() noexcept
+{
+  size_type batch = 0;
+
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> guard(mLock);
+      mStart.wait(guard, [&]() { return mStop || mBatch != batch; });
+      if (mStop)
+        return;
+      batch = mBatch;
+    }
+
+    runTasks();
+
+    std::lock_guard<std::mutex> guard(mLock);
+    if (--mBusy == 0)
+      mDone.notify_one();
+  }
+}
+
+/**
+ * @brief Run tasks of the current batch until none are left.
+ */
+inline void WorkerPool::runTasks() noexcept
+{
+  for (auto i = mNext++; i < mCount; i = mNext++)
+    mInvoke(mTask, i);
+}
+
+/**
+ * @brief Tell the workers to exit, and join them.
+ */
+inline void WorkerPool::stop() noexcept
+{
+  {
+    std::lock_guard<std::mutex> guard(mLock);
+    mStop = true;
+  }
+
+  mStart.notify_all();
+  for (auto& worker : mWorkers)
+    worker.join();
+  mWorkers.clear();
+}
+
+} // namespace ospp
+
+#endif // _WORKER_POOL_H
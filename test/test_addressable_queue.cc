@@ -0,0 +1,246 @@
+/**
+ * @file test_addressable_queue.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/addressable_queue.hh"
+
+
+namespace {
+
+
+using ospp::AddressablePriorityQueue;
+
+
+/**
+ * An allocator that counts the allocations made through any of its copies.
+ */
+template<typename T>
+struct CountingAllocator
+{
+  using value_type = T;
+
+  explicit CountingAllocator(std::size_t *count) : count(count) {}
+
+  template<typename U>
+  CountingAllocator(const CountingAllocator<U>& other) : count(other.count) {}
+
+  T* allocate(std::size_t n)
+  {
+    ++*count;
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T *ptr, std::size_t n)
+  {
+    std::allocator<T>().deallocate(ptr, n);
+  }
+
+  std::size_t *count;
+};
+
+template<typename T, typename U>
+bool operator==(const CountingAllocator<T>& a, const CountingAllocator<U>& b)
+{
+  return a.count == b.count;
+}
+
+template<typename T, typename U>
+bool operator!=(const CountingAllocator<T>& a, const CountingAllocator<U>& b)
+{
+  return !(a == b);
+}
+
+
+TEST(TestAddressablePriorityQueue, DefaultCtorShouldYieldEmptyQueue)
+{
+  AddressablePriorityQueue<int> pq;
+  EXPECT_TRUE(pq.empty());
+  EXPECT_EQ(0, pq.size());
+}
+
+
+TEST(TestAddressablePriorityQueue, PushShouldReturnHandleToItem)
+{
+  AddressablePriorityQueue<std::string> pq;
+  auto b = pq.push("b");
+  auto a = pq.push("a");
+  auto c = pq.push("c");
+
+  EXPECT_EQ(3, pq.size());
+  EXPECT_EQ("a", pq.top());
+  EXPECT_EQ(a, pq.top_handle());
+  EXPECT_EQ("b", pq.get(b));
+  EXPECT_EQ("c", pq.get(c));
+  EXPECT_TRUE(pq.contains(b));
+}
+
+
+TEST(TestAddressablePriorityQueue, DecreaseKeyShouldMoveItemToTop)
+{
+  AddressablePriorityQueue<int> pq;
+  pq.push(5);
+  pq.push(3);
+  auto h = pq.push(9);
+
+  pq.decrease_key(h, 1);
+  EXPECT_EQ(1, pq.top());
+  EXPECT_EQ(h, pq.top_handle());
+}
+
+
+TEST(TestAddressablePriorityQueue, IncreaseKeyShouldMoveItemDown)
+{
+  AddressablePriorityQueue<int, std::less<int>, std::allocator<int>, 4> pq;
+  auto h = pq.push(1);
+  pq.push(5);
+  pq.push(3);
+
+  pq.increase_key(h, 7);
+  EXPECT_EQ(3, pq.pop_value());
+  EXPECT_EQ(5, pq.pop_value());
+  EXPECT_EQ(7, pq.pop_value());
+  EXPECT_TRUE(pq.empty());
+}
+
+
+TEST(TestAddressablePriorityQueue, EraseShouldRemoveOnlyThatItem)
+{
+  AddressablePriorityQueue<int> pq;
+  std::vector<AddressablePriorityQueue<int>::handle_type> handles;
+  for (int i : {8, 2, 6, 4, 0})
+    handles.push_back(pq.push(i));
+
+  pq.erase(handles[2]);
+  pq.erase(handles[4]);
+  EXPECT_FALSE(pq.contains(handles[2]));
+  EXPECT_EQ(3, pq.size());
+
+  std::vector<int> ordered;
+  while (not pq.empty())
+    ordered.push_back(pq.pop_value());
+  EXPECT_EQ(std::vector<int>({2, 4, 8}), ordered);
+}
+
+
+TEST(TestAddressablePriorityQueue, HandlesShouldBeReused)
+{
+  AddressablePriorityQueue<int> pq;
+  auto h1 = pq.push(1);
+  pq.push(2);
+  pq.pop();
+  EXPECT_FALSE(pq.contains(h1));
+
+  auto h3 = pq.push(3);
+  EXPECT_EQ(h1, h3);
+  EXPECT_EQ(3, pq.get(h3));
+  EXPECT_EQ(2, pq.top());
+}
+
+
+TEST(TestAddressablePriorityQueue, UpdateShouldFollowExternalPriority)
+{
+  std::vector<int> dist({10, 20, 30});
+  auto comp = [&dist](int a, int b) { return dist[a] < dist[b]; };
+  AddressablePriorityQueue<int, decltype(comp)> pq(comp);
+  std::vector<AddressablePriorityQueue<int, decltype(comp)>::handle_type> h;
+  for (int i = 0; i < 3; ++i)
+    h.push_back(pq.push(i));
+
+  EXPECT_EQ(0, pq.top());
+  dist[2] = 5;
+  pq.update(h[2]);
+  EXPECT_EQ(2, pq.top());
+  dist[2] = 25;
+  pq.update(h[2]);
+  EXPECT_EQ(0, pq.top());
+}
+
+
+TEST(TestAddressablePriorityQueue, RandomOperationsShouldMatchSortedVector)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(0, 10000),
+                           std::default_random_engine(103));
+  AddressablePriorityQueue<int, std::greater<int>> pq;
+  std::vector<AddressablePriorityQueue<int>::handle_type> handles;
+  std::vector<int> values;
+
+  for (int i = 0; i < 500; ++i) {
+    auto v = randInt();
+    handles.push_back(pq.push(v));
+    values.push_back(v);
+  }
+
+  // change half the keys and erase a fifth of the items
+  for (int i = 0; i < 500; i += 2) {
+    values[i] = randInt();
+    pq.update(handles[i], values[i]);
+  }
+  std::vector<int> expected;
+  for (int i = 0; i < 500; ++i) {
+    if (i % 5 == 0)
+      pq.erase(handles[i]);
+    else
+      expected.push_back(values[i]);
+  }
+
+  std::vector<int> ordered;
+  while (not pq.empty())
+    ordered.push_back(pq.pop_value());
+
+  std::sort(expected.begin(), expected.end(), std::greater<int>());
+  EXPECT_EQ(expected, ordered);
+}
+
+TEST(TestAddressablePriorityQueue, PushAndPopShouldAllocateLogarithmically)
+{
+  std::size_t count = 0;
+  using Queue = AddressablePriorityQueue<int, std::less<int>,
+                                         CountingAllocator<int>>;
+  Queue pq{CountingAllocator<int>(&count)};
+
+  // the heap and the free list grow geometrically, so about 2 * log2(n)
+  // allocations, and the slot table takes a block per 16 slots at most
+  const int items = 100000;
+  for (int i = 0; i < items; ++i)
+    pq.push(items - i);
+  for (int i = 0; i < items; ++i)
+    pq.push(pq.pop_value());
+  while (not pq.empty())
+    pq.pop();
+
+  EXPECT_LT(count, 2u * 20 + items / 16 + 20);
+}
+
+
+TEST(TestAddressablePriorityQueue, ReferencesShouldSurviveOtherPushes)
+{
+  AddressablePriorityQueue<std::string> pq;
+  auto handle = pq.push("the last value, long enough to be allocated");
+  auto& value = pq.get(handle);
+  pq.push("0, the first value");
+  auto& top = pq.top();
+
+  // the slot table grows many times, but does not move the items
+  for (int i = 0; i < 10000; ++i)
+    pq.push("another value long enough to be allocated " + std::to_string(i));
+  EXPECT_EQ(&top, &pq.top());
+  EXPECT_EQ(&value, &pq.get(handle));
+
+  for (int i = 0; i < 5000; ++i)
+    pq.pop();
+  EXPECT_EQ(&value, &pq.get(handle));
+  EXPECT_EQ("the last value, long enough to be allocated", value);
+}
+
+} // anonymous namespace
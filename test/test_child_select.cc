@@ -0,0 +1,139 @@
+/**
+ * @file test_child_select.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/child_select.hh"
+#include "queue/queue.hh"
+
+
+namespace {
+
+
+using ospp::PriorityQueue;
+using ospp::detail::ChildSelect;
+
+
+/**
+ * @brief Check the selected child against a scalar loop on random keys drawn
+ *  from a small range, so that ties are common.
+ */
+template<typename T, typename Compare, std::size_t Arity>
+void expectSameAsScalar(unsigned seed)
+{
+  using select = ChildSelect<T, Compare, Arity>;
+  if (!select::enabled())
+    return;
+
+  std::default_random_engine engine(seed);
+  std::uniform_int_distribution<int> dist(-4, 4);
+  Compare comp;
+
+  for (int run = 0; run < 1000; ++run)
+  {
+    T keys[Arity];
+    for (auto& k : keys)
+      k = static_cast<T>(dist(engine));
+
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < Arity; ++i)
+      if (comp(keys[i], keys[best]))
+        best = i;
+
+    ASSERT_EQ(static_cast<int>(best), select::best(keys));
+  }
+}
+
+
+template<typename T, typename Compare, std::size_t Arity>
+void expectSortedPops(unsigned seed)
+{
+  std::default_random_engine engine(seed);
+  std::uniform_int_distribution<int> dist(-100000, 100000);
+  std::vector<T> keys;
+  for (int i = 0; i < 5000; ++i)
+    keys.push_back(static_cast<T>(dist(engine)));
+
+  PriorityQueue<T, Compare, std::allocator<T>, Arity> pq;
+  for (auto k : keys)
+    pq.push(k);
+
+  std::vector<T> ordered;
+  while (not pq.empty()) {
+    ordered.push_back(pq.top());
+    pq.pop();
+  }
+
+  std::sort(keys.begin(), keys.end(), Compare());
+  EXPECT_EQ(keys, ordered);
+}
+
+
+TEST(TestChildSelect, ShouldOnlyVectorizeSupportedQueues)
+{
+  EXPECT_FALSE((ChildSelect<int, std::less<int>, 2>::vectorized));
+  EXPECT_FALSE((ChildSelect<int, std::less<int>, 4>::vectorized));
+  EXPECT_FALSE((ChildSelect<double, std::less<double>, 8>::vectorized));
+  EXPECT_FALSE((ChildSelect<int, std::less_equal<int>, 8>::vectorized));
+}
+
+
+TEST(TestChildSelect, BestShouldMatchScalarLoop)
+{
+  expectSameAsScalar<std::int32_t, std::less<std::int32_t>, 8>(1);
+  expectSameAsScalar<std::int32_t, std::greater<std::int32_t>, 16>(2);
+  expectSameAsScalar<std::uint32_t, std::less<std::uint32_t>, 16>(3);
+  expectSameAsScalar<std::uint32_t, std::greater<std::uint32_t>, 8>(4);
+  expectSameAsScalar<float, std::less<float>, 16>(5);
+  expectSameAsScalar<float, std::greater<float>, 8>(6);
+}
+
+
+TEST(TestChildSelect, UnsignedKeysShouldNotCompareAsSigned)
+{
+  using select = ChildSelect<std::uint32_t, std::greater<std::uint32_t>, 8>;
+  if (!select::enabled())
+    return;
+
+  std::uint32_t keys[8] = {1, 2, 0x80000000u, 3, 0xffffffffu, 4, 5, 6};
+  EXPECT_EQ(4, select::best(keys));
+}
+
+
+TEST(TestChildSelect, QueuesShouldPopInOrder)
+{
+  expectSortedPops<int, std::less<int>, 8>(11);
+  expectSortedPops<int, std::greater<int>, 16>(12);
+  expectSortedPops<std::uint32_t, std::less<std::uint32_t>, 8>(13);
+  expectSortedPops<float, std::greater<float>, 8>(14);
+  expectSortedPops<float, std::less<float>, 16>(15);
+}
+
+
+TEST(TestChildSelect, BottomUpPopShouldUseSameSelection)
+{
+  std::vector<int> keys;
+  for (int i = 0; i < 3000; ++i) keys.push_back((i * 7919) % 3001);
+
+  PriorityQueue<int, std::less<int>, std::allocator<int>, 16,
+                ospp::DoublingGrowth, ospp::BottomUpPop> pq(
+    keys.begin(), keys.end());
+
+  std::vector<int> ordered;
+  pq.drain_sorted(std::back_inserter(ordered));
+  std::sort(keys.begin(), keys.end());
+  EXPECT_EQ(keys, ordered);
+}
+
+
+} // namespace
@@ -0,0 +1,191 @@
+/**
+ * @file test_external_queue.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <system_error>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "queue/external_queue.hh"
+
+
+namespace {
+
+
+using ospp::ExternalPriorityQueue;
+using ospp::PriorityQueue;
+
+
+std::vector<int64_t> randomInts(int n, unsigned seed)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<int64_t>(-1000, 1000),
+                           std::default_random_engine(seed));
+  std::vector<int64_t> ivec;
+  for (int i = 0; i < n; ++i) ivec.push_back(randInt());
+  return ivec;
+}
+
+
+TEST(TestExternalPriorityQueue, SmallQueueShouldNotSpill)
+{
+  ExternalPriorityQueue<int64_t> pq(1 << 20, "/tmp", 4096);
+  EXPECT_TRUE(pq.empty());
+
+  for (auto i : randomInts(100, 3)) pq.push(i);
+  EXPECT_EQ(100, pq.size());
+  EXPECT_EQ(0, pq.spills());
+  EXPECT_EQ(0, pq.runs());
+  EXPECT_EQ("/tmp", pq.directory());
+}
+
+
+TEST(TestExternalPriorityQueue, PopShouldMergeTheRunsInOrder)
+{
+  // 512 items in the buffer, blocks of 16 items
+  ExternalPriorityQueue<int64_t> pq(8192, "/tmp", 128);
+  auto ivec = randomInts(5000, 7);
+  for (auto i : ivec) pq.push(i);
+
+  EXPECT_EQ(5000, pq.size());
+  EXPECT_EQ(9, pq.spills());
+  EXPECT_EQ(9 * 512 * sizeof(int64_t), pq.bytes_written());
+
+  std::vector<int64_t> ordered;
+  while (!pq.empty()) ordered.push_back(pq.pop_value());
+
+  std::sort(ivec.begin(), ivec.end());
+  EXPECT_EQ(ivec, ordered);
+  EXPECT_EQ(pq.bytes_written(), pq.bytes_read());
+}
+
+
+TEST(TestExternalPriorityQueue, ManyRunsShouldBeCompacted)
+{
+  // 64 items in the buffer, blocks of 32 items, at most 2 runs
+  ExternalPriorityQueue<int64_t, std::greater<int64_t>> pq(1024, "/tmp", 256);
+  auto ivec = randomInts(2000, 11);
+  for (auto i : ivec) pq.push(i);
+
+  EXPECT_EQ(31, pq.spills());
+  EXPECT_LE(pq.runs(), 2);
+  EXPECT_GT(pq.bytes_written(), 31 * 64 * sizeof(int64_t));
+
+  std::vector<int64_t> ordered;
+  while (!pq.empty()) {
+    ordered.push_back(pq.top());
+    pq.pop();
+  }
+
+  std::sort(ivec.begin(), ivec.end(), std::greater<int64_t>());
+  EXPECT_EQ(ivec, ordered);
+}
+
+
+TEST(TestExternalPriorityQueue, InterleavedPushAndPopShouldMatchPriorityQueue)
+{
+  ExternalPriorityQueue<int64_t> epq(1024, "/tmp", 128);
+  PriorityQueue<int64_t> pq;
+  auto ivec = randomInts(20000, 13);
+  auto randOp = std::bind(std::uniform_int_distribution<>(0, 2),
+                          std::default_random_engine(17));
+
+  for (auto i : ivec)
+  {
+    epq.push(i);
+    pq.push(i);
+    if (randOp() == 0) {
+      ASSERT_EQ(pq.top(), epq.top());
+      pq.pop();
+      epq.pop();
+    }
+  }
+
+  EXPECT_GT(epq.spills(), 0);
+  ASSERT_EQ(pq.size(), epq.size());
+  while (!pq.empty()) {
+    ASSERT_EQ(pq.top(), epq.top());
+    pq.pop();
+    epq.pop();
+  }
+  EXPECT_TRUE(epq.empty());
+}
+
+
+TEST(TestExternalPriorityQueue, MoveShouldKeepTheRuns)
+{
+  ExternalPriorityQueue<int64_t> pq1(1024, "/tmp", 128);
+  for (int64_t i = 1000; i > 0; --i) pq1.emplace(i);
+
+  auto pq2 = std::move(pq1);
+  EXPECT_EQ(1000, pq2.size());
+  for (int64_t i = 1; i <= 1000; ++i) ASSERT_EQ(i, pq2.pop_value());
+}
+
+
+TEST(TestExternalPriorityQueue, BadDirectoryShouldThrowOnSpill)
+{
+  ExternalPriorityQueue<int64_t> pq(64, "/nonexistent/ospp", 64);
+  pq.push(1);
+  pq.push(2);
+  pq.push(3);
+  pq.push(4);
+  EXPECT_THROW(pq.push(5), std::system_error);
+}
+
+
+TEST(TestExternalPriorityQueue, FailedSpillShouldKeepThePopOrder)
+{
+  char dir[] = "/tmp/ospp-test-XXXXXX";
+  ASSERT_NE(nullptr, ::mkdtemp(dir));
+
+  // 64 items in the buffer, blocks of 16 items, at most 3 runs
+  ExternalPriorityQueue<int64_t> epq(1024, dir, 128);
+  PriorityQueue<int64_t> pq;
+  for (int64_t i = 0; i < 256; ++i) {
+    epq.push(i);
+    pq.push(i);
+  }
+
+  // use up the first run, so the next spill drops it
+  for (int i = 0; i < 70; ++i) {
+    epq.pop();
+    pq.pop();
+  }
+
+  ASSERT_EQ(0, ::rmdir(dir));
+  EXPECT_THROW(epq.push(1000), std::system_error);
+  ASSERT_EQ(0, ::mkdir(dir, 0700));
+
+  // pop from the runs before the next spill rebuilds the merge heap
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(pq.top(), epq.top());
+    pq.pop();
+    epq.pop();
+  }
+
+  for (auto i : randomInts(200, 19)) {
+    epq.push(i);
+    pq.push(i);
+  }
+  ASSERT_EQ(pq.size(), epq.size());
+  while (!pq.empty()) {
+    ASSERT_EQ(pq.top(), epq.top());
+    pq.pop();
+    epq.pop();
+  }
+  EXPECT_TRUE(epq.empty());
+  ::rmdir(dir);
+}
+
+
+} // anonymous namespace
@@ -0,0 +1,157 @@
+/**
+ * @file test_inline_allocator.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/inline_allocator.hh"
+
+
+namespace {
+
+
+using ospp::InlineAllocator;
+using ospp::PriorityQueue;
+
+using SmallQueue = PriorityQueue<int, std::less<int>, InlineAllocator<int, 16>>;
+using SmallStringQueue =
+  PriorityQueue<std::string, std::less<std::string>,
+                InlineAllocator<std::string, 4>>;
+
+
+std::vector<int> randomInts(int n, unsigned seed)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(-1000, 1000),
+                           std::default_random_engine(seed));
+  std::vector<int> ivec;
+  for (int i = 0; i < n; ++i) ivec.push_back(randInt());
+  return ivec;
+}
+
+
+template<typename Queue>
+std::vector<typename Queue::value_type> drain(Queue& pq)
+{
+  std::vector<typename Queue::value_type> out;
+  pq.drain_sorted(std::back_inserter(out));
+  return out;
+}
+
+
+TEST(TestInlineAllocator, AllocateShouldUseTheInlineBufferOnce)
+{
+  InlineAllocator<int, 8> alloc;
+  EXPECT_EQ(8, alloc.capacity(3));
+  EXPECT_EQ(9, alloc.capacity(9));
+
+  auto p = alloc.allocate(8);
+  EXPECT_TRUE(alloc.owns(p));
+  EXPECT_EQ(4, alloc.capacity(4));
+
+  auto q = alloc.allocate(4);
+  EXPECT_FALSE(alloc.owns(q));
+
+  alloc.deallocate(q, 4);
+  alloc.deallocate(p, 8);
+  EXPECT_EQ(8, alloc.capacity(4));
+}
+
+
+TEST(TestInlineAllocator, QueueShouldStayInlineUntilItSpills)
+{
+  SmallQueue pq;
+  EXPECT_EQ(16, pq.capacity());
+
+  auto ivec = randomInts(100, 1);
+  for (int i = 0; i < 16; ++i)
+    pq.push(ivec[i]);
+  EXPECT_EQ(16, pq.capacity());
+
+  for (int i = 16; i < 100; ++i)
+    pq.push(ivec[i]);
+  EXPECT_LE(100, pq.capacity());
+
+  std::sort(ivec.begin(), ivec.end());
+  EXPECT_EQ(ivec, drain(pq));
+
+  pq.shrink_to_fit();
+  EXPECT_EQ(16, pq.capacity());
+}
+
+
+TEST(TestInlineAllocator, MoveShouldMoveInlineItems)
+{
+  auto ivec = randomInts(10, 2);
+  SmallQueue pq(ivec.begin(), ivec.end());
+
+  SmallQueue moved(std::move(pq));
+  EXPECT_TRUE(pq.empty());
+  EXPECT_EQ(10, moved.size());
+
+  pq.push(5);
+  EXPECT_EQ(5, pq.top());
+
+  std::sort(ivec.begin(), ivec.end());
+  EXPECT_EQ(ivec, drain(moved));
+}
+
+
+TEST(TestInlineAllocator, SwapShouldWorkAcrossInlineAndSpilledBuffers)
+{
+  auto small = randomInts(5, 3);
+  auto large = randomInts(50, 4);
+  SmallStringQueue pq1;
+  SmallStringQueue pq2;
+  for (auto i : small)
+    pq1.push(std::to_string(i));
+  for (auto i : large)
+    pq2.push(std::to_string(i));
+
+  pq1.swap(pq2);
+  EXPECT_EQ(50, pq1.size());
+  EXPECT_EQ(5, pq2.size());
+
+  SmallStringQueue pq3;
+  pq3.push("x");
+  pq3 = pq2;
+  pq2 = std::move(pq1);
+
+  std::vector<std::string> expectSmall, expectLarge;
+  for (auto i : small)
+    expectSmall.push_back(std::to_string(i));
+  for (auto i : large)
+    expectLarge.push_back(std::to_string(i));
+  std::sort(expectSmall.begin(), expectSmall.end());
+  std::sort(expectLarge.begin(), expectLarge.end());
+
+  EXPECT_EQ(expectSmall, drain(pq3));
+  EXPECT_EQ(expectLarge, drain(pq2));
+}
+
+
+TEST(TestInlineAllocator, MergeShouldWorkWithInlineBuffers)
+{
+  auto ivec1 = randomInts(3, 5);
+  auto ivec2 = randomInts(12, 6);
+  SmallQueue pq1(ivec1.begin(), ivec1.end());
+  SmallQueue pq2(ivec2.begin(), ivec2.end());
+
+  pq1.merge(std::move(pq2));
+  EXPECT_TRUE(pq2.empty());
+  EXPECT_EQ(15, pq1.size());
+
+  ivec1.insert(ivec1.end(), ivec2.begin(), ivec2.end());
+  std::sort(ivec1.begin(), ivec1.end());
+  EXPECT_EQ(ivec1, drain(pq1));
+}
+
+
+} // anonymous namespace
@@ -0,0 +1,209 @@
+/**
+ * @file test_keyed_queue.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/keyed_queue.hh"
+
+
+namespace {
+
+
+using ospp::KeyedPriorityQueue;
+
+
+/**
+ * Counts how many times values of this type are moved or copied.
+ */
+struct Payload
+{
+  static int moves;
+  int id;
+  char bytes[48];
+
+  explicit Payload(int i) : id(i), bytes() {}
+  Payload(const Payload& other) : id(other.id), bytes() { ++moves; }
+  Payload(Payload&& other) noexcept : id(other.id), bytes() { ++moves; }
+  Payload& operator=(const Payload& other)
+  {
+    id = other.id;
+    ++moves;
+    return *this;
+  }
+  Payload& operator=(Payload&& other) noexcept
+  {
+    id = other.id;
+    ++moves;
+    return *this;
+  }
+};
+
+int Payload::moves = 0;
+
+
+TEST(TestKeyedPriorityQueue, DefaultCtorShouldYieldEmptyQueue)
+{
+  KeyedPriorityQueue<std::int64_t, std::string> pq;
+  EXPECT_TRUE(pq.empty());
+  EXPECT_EQ(0, pq.size());
+  pq.pop();
+  EXPECT_TRUE(pq.empty());
+}
+
+
+TEST(TestKeyedPriorityQueue, PopShouldYieldValuesInKeyOrder)
+{
+  KeyedPriorityQueue<int, std::string> pq;
+  pq.push(3, "three");
+  pq.push(1, "one");
+  pq.push(4, "four");
+  pq.push(2, std::string("two"));
+
+  EXPECT_EQ(4, pq.size());
+  EXPECT_EQ(1, pq.top_key());
+  EXPECT_EQ("one", pq.top());
+
+  std::vector<std::string> ordered;
+  while (not pq.empty())
+    ordered.push_back(pq.pop_value());
+  EXPECT_EQ(std::vector<std::string>({"one", "two", "three", "four"}),
+            ordered);
+}
+
+
+TEST(TestKeyedPriorityQueue, ValuesShouldFollowTheirKeys)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(0, 1000),
+                           std::default_random_engine(17));
+
+  KeyedPriorityQueue<int, int, std::greater<int>,
+                     std::allocator<int>, 4> pq;
+  std::vector<int> keys;
+  for (int i = 0; i < 3000; ++i) {
+    auto k = randInt();
+    keys.push_back(k);
+    pq.push(k, -k);
+
+    // pop now and then, so that slots are reused
+    if (i % 3 == 0) {
+      EXPECT_EQ(-pq.top_key(), pq.top());
+      auto top = std::max_element(keys.begin(), keys.end());
+      EXPECT_EQ(*top, pq.top_key());
+      keys.erase(top);
+      pq.pop();
+    }
+  }
+
+  std::sort(keys.begin(), keys.end(), std::greater<int>());
+  for (auto k : keys) {
+    EXPECT_EQ(k, pq.top_key());
+    EXPECT_EQ(-k, pq.pop_value());
+  }
+  EXPECT_TRUE(pq.empty());
+}
+
+
+TEST(TestKeyedPriorityQueue, SiftingShouldNotMoveValues)
+{
+  KeyedPriorityQueue<std::int64_t, Payload> pq;
+  pq.reserve(1000);
+
+  Payload::moves = 0;
+  for (int i = 0; i < 1000; ++i)
+    pq.emplace((i * 7919) % 1000, i);
+  EXPECT_EQ(0, Payload::moves);
+
+  // pop releases each value with one move
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(i, pq.top_key());
+    pq.pop();
+  }
+  EXPECT_EQ(1000, Payload::moves);
+
+  // a reused slot takes one move on push, and pop_value one move out
+  Payload::moves = 0;
+  pq.push(5, Payload(1));
+  EXPECT_EQ(1, Payload::moves);
+  auto p = pq.pop_value();
+  EXPECT_EQ(1, p.id);
+  EXPECT_EQ(2, Payload::moves);
+}
+
+
+TEST(TestKeyedPriorityQueue, GrowingShouldNotMoveValues)
+{
+  // no reserve, so the values cross many growth boundaries
+  KeyedPriorityQueue<std::int64_t, Payload> pq;
+
+  Payload::moves = 0;
+  for (int i = 0; i < 5000; ++i)
+    pq.emplace(i, i);
+  EXPECT_EQ(0, Payload::moves);
+
+  // each pushed value is moved once, and only once
+  for (int i = 0; i < 5000; ++i)
+    pq.push(5000 + i, Payload(5000 + i));
+  EXPECT_EQ(5000, Payload::moves);
+
+  for (int i = 0; i < 10000; ++i) {
+    ASSERT_EQ(i, pq.top().id);
+    pq.pop();
+  }
+}
+
+
+TEST(TestKeyedPriorityQueue, PopShouldReleaseTheValue)
+{
+  KeyedPriorityQueue<int, std::shared_ptr<int>> pq;
+  auto ptr = std::make_shared<int>(7);
+  pq.push(1, ptr);
+  pq.push(2, ptr);
+  EXPECT_EQ(3, ptr.use_count());
+
+  pq.pop();
+  EXPECT_EQ(2, ptr.use_count());
+  pq.pop_value();
+  EXPECT_EQ(1, ptr.use_count());
+}
+
+
+TEST(TestKeyedPriorityQueue, MoveOnlyValuesShouldWork)
+{
+  KeyedPriorityQueue<double, std::unique_ptr<int>> pq;
+  pq.emplace(2.5, new int(25));
+  pq.push(0.5, std::unique_ptr<int>(new int(5)));
+  pq.emplace(1.5, new int(15));
+
+  EXPECT_EQ(5, *pq.pop_value());
+  EXPECT_EQ(15, *pq.pop_value());
+  EXPECT_EQ(25, *pq.top());
+}
+
+
+TEST(TestKeyedPriorityQueue, ClearShouldEmptyQueue)
+{
+  KeyedPriorityQueue<int, std::string> pq;
+  pq.push(2, "b");
+  pq.push(1, "a");
+  pq.pop();
+  pq.clear();
+  EXPECT_TRUE(pq.empty());
+
+  pq.push(7, "g");
+  EXPECT_EQ(7, pq.top_key());
+  EXPECT_EQ("g", pq.top());
+  EXPECT_EQ(1, pq.size());
+}
+
+
+} // namespace
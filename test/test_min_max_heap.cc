@@ -0,0 +1,168 @@
+/**
+ * @file test_min_max_heap.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/min_max_heap.hh"
+
+
+namespace {
+
+
+using ospp::MinMaxHeap;
+
+
+TEST(TestMinMaxHeap, DefaultCtorShouldYieldEmptyHeap)
+{
+  MinMaxHeap<int> heap;
+  EXPECT_TRUE(heap.empty());
+  EXPECT_EQ(0, heap.size());
+  heap.pop_min();
+  heap.pop_max();
+  EXPECT_TRUE(heap.empty());
+}
+
+
+TEST(TestMinMaxHeap, SmallHeapsShouldFindBothEnds)
+{
+  MinMaxHeap<int> heap;
+  heap.push(5);
+  EXPECT_EQ(5, heap.min());
+  EXPECT_EQ(5, heap.max());
+  heap.push(3);
+  EXPECT_EQ(3, heap.min());
+  EXPECT_EQ(5, heap.max());
+  heap.push(9);
+  EXPECT_EQ(3, heap.min());
+  EXPECT_EQ(9, heap.max());
+
+  EXPECT_EQ(9, heap.pop_max_value());
+  EXPECT_EQ(3, heap.pop_min_value());
+  EXPECT_EQ(5, heap.min());
+  EXPECT_EQ(5, heap.max());
+  heap.pop_max();
+  EXPECT_TRUE(heap.empty());
+}
+
+
+TEST(TestMinMaxHeap, MixedOperationsShouldMatchSortedSet)
+{
+  std::default_random_engine randEngine(23);
+  auto randInt = std::uniform_int_distribution<>(-1000, 1000);
+  auto randOp = std::uniform_int_distribution<>(0, 3);
+
+  MinMaxHeap<int> heap;
+  std::multiset<int> expected;
+  for (int i = 0; i < 20000; ++i)
+  {
+    auto op = randOp(randEngine);
+    if (op < 2 || expected.empty()) {
+      auto value = randInt(randEngine);
+      heap.push(value);
+      expected.insert(value);
+    }
+    else if (op == 2) {
+      EXPECT_EQ(*expected.begin(), heap.pop_min_value());
+      expected.erase(expected.begin());
+    }
+    else {
+      EXPECT_EQ(*expected.rbegin(), heap.pop_max_value());
+      expected.erase(std::prev(expected.end()));
+    }
+
+    ASSERT_EQ(expected.size(), heap.size());
+    if (!expected.empty()) {
+      ASSERT_EQ(*expected.begin(), heap.min());
+      ASSERT_EQ(*expected.rbegin(), heap.max());
+    }
+  }
+}
+
+
+TEST(TestMinMaxHeap, ComparatorShouldDecideWhichEndIsMin)
+{
+  std::vector<std::string> words{"pear", "fig", "apple", "kiwi", "date",
+                                 "plum", "lime", "banana", "cherry"};
+  MinMaxHeap<std::string, std::greater<std::string>> heap(
+    words.begin(), words.end());
+  EXPECT_EQ(words.size(), heap.size());
+
+  // with greater, min is the item a PriorityQueue would pop first
+  std::sort(words.begin(), words.end());
+  std::vector<std::string> fromMin, fromMax;
+  while (heap.size() > 1)
+  {
+    fromMin.push_back(heap.pop_min_value());
+    fromMax.push_back(heap.pop_max_value());
+  }
+
+  EXPECT_EQ((std::vector<std::string>{"plum", "pear", "lime", "kiwi"}),
+            fromMin);
+  EXPECT_EQ((std::vector<std::string>{"apple", "banana", "cherry", "date"}),
+            fromMax);
+  EXPECT_EQ("fig", heap.min());
+}
+
+
+TEST(TestMinMaxHeap, RangeCtorShouldBuildValidHeap)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(0, 100),
+                           std::default_random_engine(31));
+  for (int count : {0, 1, 2, 3, 7, 8, 100, 1001}) {
+    std::vector<int> ivec;
+    for (int i = 0; i < count; ++i) ivec.push_back(randInt());
+
+    MinMaxHeap<int> heap(ivec.begin(), ivec.end());
+    std::sort(ivec.begin(), ivec.end());
+
+    // pop from both ends alternately until they meet
+    std::vector<int> low, high;
+    for (bool fromMin = true; !heap.empty(); fromMin = !fromMin)
+    {
+      if (fromMin)
+        low.push_back(heap.pop_min_value());
+      else
+        high.push_back(heap.pop_max_value());
+    }
+
+    low.insert(low.end(), high.rbegin(), high.rend());
+    EXPECT_EQ(ivec, low);
+  }
+}
+
+
+TEST(TestMinMaxHeap, MoveOnlyItemsShouldBeSupported)
+{
+  struct PtrLess
+  {
+    bool operator()(const std::unique_ptr<int>& a,
+                    const std::unique_ptr<int>& b) const
+    { return *a < *b; }
+  };
+  MinMaxHeap<std::unique_ptr<int>, PtrLess> heap;
+  for (int i : {4, 8, 1, 6, 3})
+    heap.emplace(new int(i));
+
+  EXPECT_EQ(8, *heap.pop_max_value());
+  EXPECT_EQ(1, *heap.pop_min_value());
+  EXPECT_EQ(3, *heap.min());
+  EXPECT_EQ(6, *heap.max());
+
+  MinMaxHeap<std::unique_ptr<int>, PtrLess> other;
+  other.swap(heap);
+  EXPECT_TRUE(heap.empty());
+  EXPECT_EQ(3, other.size());
+}
+
+
+} // anonymous namespace
@@ -0,0 +1,180 @@
+/**
+ * @file test_mmap_allocator.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "queue/mmap_allocator.hh"
+
+
+namespace {
+
+
+using ospp::MmapAllocator;
+using ospp::PriorityQueue;
+
+
+std::vector<std::int64_t> randomInts(int n, unsigned seed)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<std::int64_t>(),
+                           std::default_random_engine(seed));
+  std::vector<std::int64_t> ivec;
+  for (int i = 0; i < n; ++i) ivec.push_back(randInt());
+  return ivec;
+}
+
+
+/**
+ * @brief Create an empty file with a unique name, so that concurrent test runs
+ *  never share a snapshot.
+ * @return The path of the file, which the test removes.
+ */
+std::string makeTempFile()
+{
+  char path[] = "/tmp/ospp-test-XXXXXX";
+  int fd = ::mkstemp(path);
+  EXPECT_LE(0, fd);
+  if (fd >= 0)
+    ::close(fd);
+  return path;
+}
+
+
+TEST(TestMmapAllocator, CapacityShouldFillWholePages)
+{
+  MmapAllocator<std::int32_t> alloc;
+  EXPECT_EQ(1024, alloc.capacity(0));
+  EXPECT_EQ(1024, alloc.capacity(1));
+  EXPECT_EQ(2048, alloc.capacity(1025));
+
+  auto huge = MmapAllocator<std::int32_t>::HUGE_PAGE / 4;
+  EXPECT_EQ(huge, alloc.capacity(huge - 1));
+  EXPECT_EQ(2 * huge, alloc.capacity(huge + 1));
+}
+
+
+TEST(TestMmapAllocator, ResizeShouldKeepTheContents)
+{
+  MmapAllocator<int> alloc;
+  auto n = alloc.capacity(1000);
+  auto ptr = alloc.allocate(n);
+  for (std::size_t i = 0; i < n; ++i)
+    ptr[i] = static_cast<int>(i);
+
+  auto size = alloc.capacity(5000000);
+  ptr = alloc.resize(ptr, n, size);
+  for (std::size_t i = 0; i < n; ++i)
+    ASSERT_EQ(static_cast<int>(i), ptr[i]);
+  EXPECT_EQ(0, ptr[size - 1]);
+
+  ptr = alloc.resize(ptr, size, 10);
+  EXPECT_EQ(9, ptr[9]);
+  alloc.deallocate(ptr, 10);
+}
+
+
+TEST(TestMmapAllocator, QueueShouldGrowByRemapping)
+{
+  auto ivec = randomInts(1000000, 1);
+  PriorityQueue<std::int64_t, std::greater<std::int64_t>,
+                MmapAllocator<std::int64_t>> pq;
+  EXPECT_EQ(512, pq.capacity());
+
+  for (auto i : ivec)
+    pq.push(i);
+  EXPECT_EQ(ivec.size(), pq.size());
+  EXPECT_LE(ivec.size(), pq.capacity());
+
+  for (int i = 0; i < 600000; ++i)
+    pq.pop();
+  pq.shrink_to_fit();
+  EXPECT_EQ(524288, pq.capacity());
+
+  std::vector<std::int64_t> out;
+  pq.drain_sorted(std::back_inserter(out));
+
+  std::sort(ivec.begin(), ivec.end(), std::greater<std::int64_t>());
+  ivec.erase(ivec.begin(), ivec.begin() + 600000);
+  EXPECT_EQ(ivec, out);
+}
+
+
+TEST(TestMmapAllocator, LoadShouldMapTheSnapshotCopyOnWrite)
+{
+  const std::string path = makeTempFile();
+  using Queue = PriorityQueue<std::int64_t, std::greater<std::int64_t>,
+                              MmapAllocator<std::int64_t>>;
+
+  // a partial last page, and one that fills its pages exactly
+  for (int count : {100003, 1 << 17}) {
+    auto ivec = randomInts(count, 3);
+    Queue pq(ivec.begin(), ivec.end());
+    pq.save(path);
+
+    Queue loaded;
+    loaded.load(path);
+    EXPECT_EQ(pq, loaded);
+    EXPECT_EQ(pq.hashCode(), loaded.hashCode());
+    EXPECT_LT(ivec.size(), loaded.capacity());
+
+    // writes go to private pages, and growing copies out of the mapping
+    for (int i = 0; i < 1000; ++i)
+      loaded.pop();
+    for (auto i : randomInts(count, 4))
+      loaded.push(i);
+    EXPECT_EQ(2 * ivec.size() - 1000, loaded.size());
+
+    Queue again;
+    again.load(path);
+    EXPECT_EQ(pq, again);
+
+    // saving over the file leaves the mapped queue alone
+    Queue().save(path);
+    std::vector<std::int64_t> out;
+    again.drain_sorted(std::back_inserter(out));
+    std::sort(ivec.begin(), ivec.end(), std::greater<std::int64_t>());
+    EXPECT_EQ(ivec, out);
+
+    loaded.shrink_to_fit();
+    loaded.push(0);
+    EXPECT_EQ(2 * ivec.size() - 999, loaded.size());
+  }
+
+  std::remove(path.c_str());
+}
+
+
+TEST(TestMmapAllocator, QueueShouldMoveItemsThatAreNotTriviallyCopyable)
+{
+  PriorityQueue<std::string, std::less<std::string>,
+                MmapAllocator<std::string>> pq;
+  std::vector<std::string> svec;
+  for (auto i : randomInts(3000, 2))
+    svec.push_back(std::to_string(i));
+
+  pq.push_range(svec.begin(), svec.end());
+  auto copy = pq;
+
+  std::vector<std::string> out;
+  copy.drain_sorted(std::back_inserter(out));
+
+  std::sort(svec.begin(), svec.end());
+  EXPECT_EQ(svec, out);
+  EXPECT_EQ(svec.front(), pq.top());
+}
+
+
+} // anonymous namespace
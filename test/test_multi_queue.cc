@@ -0,0 +1,115 @@
+/**
+ * @file test_multi_queue.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/multi_queue.hh"
+
+
+namespace {
+
+
+using ospp::MultiQueue;
+
+
+TEST(TestMultiQueue, CtorShouldCreateShardsPerThread)
+{
+  MultiQueue<int> mq(4);
+  EXPECT_EQ(8, mq.shards());
+  EXPECT_TRUE(mq.empty());
+
+  MultiQueue<int> single(1, 1);
+  EXPECT_EQ(2, single.shards());
+}
+
+
+TEST(TestMultiQueue, TryPopOnEmptyQueueShouldFail)
+{
+  MultiQueue<int> mq(2);
+  int value = -1;
+  EXPECT_FALSE(mq.try_pop(value));
+  EXPECT_EQ(-1, value);
+}
+
+
+TEST(TestMultiQueue, PoppedItemsShouldMatchPushedItems)
+{
+  MultiQueue<int> mq(2);
+  std::vector<int> pushed;
+  for (int i = 0; i < 1000; ++i) {
+    mq.push(i * 7 % 1000);
+    pushed.push_back(i * 7 % 1000);
+  }
+  EXPECT_EQ(1000, mq.size());
+
+  std::vector<int> popped;
+  int value;
+  while (mq.try_pop(value))
+    popped.push_back(value);
+
+  EXPECT_TRUE(mq.empty());
+  std::sort(pushed.begin(), pushed.end());
+  std::sort(popped.begin(), popped.end());
+  EXPECT_EQ(pushed, popped);
+}
+
+
+TEST(TestMultiQueue, PopsShouldBeRoughlyOrdered)
+{
+  MultiQueue<int> mq(1, 2);
+  for (int i = 999; i >= 0; --i)
+    mq.push(i);
+
+  // with two shards, the first pop is the best of both tops
+  int value;
+  ASSERT_TRUE(mq.try_pop(value));
+  EXPECT_EQ(0, value);
+}
+
+
+TEST(TestMultiQueue, ConcurrentPushAndPopShouldNotLoseItems)
+{
+  const int threads = 4;
+  const int perThread = 5000;
+  MultiQueue<int> mq(threads);
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&mq, t]() {
+      for (int i = 0; i < perThread; ++i)
+        mq.push(t * perThread + i);
+    });
+  }
+  for (auto& w : workers)
+    w.join();
+  EXPECT_EQ(threads * perThread, mq.size());
+
+  std::vector<std::vector<int>> popped(threads);
+  workers.clear();
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&mq, &popped, t]() {
+      int value;
+      while (mq.try_pop(value))
+        popped[t].push_back(value);
+    });
+  }
+  for (auto& w : workers)
+    w.join();
+
+  std::vector<int> all;
+  for (auto& p : popped)
+    all.insert(all.end(), p.begin(), p.end());
+  std::sort(all.begin(), all.end());
+
+  ASSERT_EQ(threads * perThread, all.size());
+  for (int i = 0; i < threads * perThread; ++i)
+    EXPECT_EQ(i, all[i]);
+}
+
+} // anonymous namespace
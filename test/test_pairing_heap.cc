@@ -0,0 +1,176 @@
+/**
+ * @file test_pairing_heap.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/pairing_heap.hh"
+
+
+namespace {
+
+
+using ospp::PairingHeap;
+
+
+template<typename Heap>
+std::vector<typename Heap::value_type> drain(Heap& heap)
+{
+  std::vector<typename Heap::value_type> ordered;
+  while (not heap.empty())
+    ordered.push_back(heap.pop_value());
+  return ordered;
+}
+
+
+TEST(TestPairingHeap, DefaultCtorShouldYieldEmptyHeap)
+{
+  PairingHeap<int> heap;
+  EXPECT_TRUE(heap.empty());
+  EXPECT_EQ(0, heap.size());
+  heap.pop();
+  EXPECT_TRUE(heap.empty());
+}
+
+
+TEST(TestPairingHeap, PopShouldYieldItemsInOrder)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(-500, 500),
+                           std::default_random_engine(7));
+  std::vector<int> ivec;
+  for (int i = 0; i < 2000; ++i) ivec.push_back(randInt());
+
+  PairingHeap<int, std::greater<int>> heap;
+  for (auto i : ivec)
+    heap.push(i);
+  EXPECT_EQ(2000, heap.size());
+  EXPECT_EQ(*std::max_element(ivec.begin(), ivec.end()), heap.top());
+
+  std::sort(ivec.begin(), ivec.end(), std::greater<int>());
+  EXPECT_EQ(ivec, drain(heap));
+}
+
+
+TEST(TestPairingHeap, InterleavedPushAndPopShouldPreserveOrder)
+{
+  PairingHeap<int> heap;
+  std::multiset<int> expected;
+  for (int i = 0; i < 100; ++i) {
+    heap.push((i * 37) % 101);
+    heap.push((i * 53) % 101);
+    expected.insert((i * 37) % 101);
+    expected.insert((i * 53) % 101);
+
+    EXPECT_EQ(*expected.begin(), heap.pop_value());
+    expected.erase(expected.begin());
+  }
+
+  EXPECT_EQ(std::vector<int>(expected.begin(), expected.end()), drain(heap));
+}
+
+
+TEST(TestPairingHeap, MergeShouldTakeAllItemsAndEmptyOther)
+{
+  PairingHeap<int> a, b, c;
+  for (int i : {9, 4, 7})
+    a.push(i);
+  for (int i : {3, 8, 1, 6})
+    b.push(i);
+
+  a.merge(std::move(b));
+  EXPECT_TRUE(b.empty());
+  EXPECT_EQ(7, a.size());
+  EXPECT_EQ(1, a.top());
+
+  a.merge(std::move(c));
+  EXPECT_EQ(7, a.size());
+  c.merge(std::move(a));
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(std::vector<int>({1, 3, 4, 6, 7, 8, 9}), drain(c));
+
+  b.push(2);
+  EXPECT_EQ(2, b.top());
+}
+
+
+TEST(TestPairingHeap, CopyShouldBeIndependent)
+{
+  PairingHeap<std::string> heap;
+  for (auto s : {"pear", "fig", "apple", "kiwi", "date"})
+    heap.push(s);
+
+  PairingHeap<std::string> copy(heap);
+  EXPECT_EQ(5, copy.size());
+  heap.pop();
+  EXPECT_EQ("apple", copy.top());
+  EXPECT_EQ("date", heap.top());
+
+  PairingHeap<std::string> assigned;
+  assigned.push("zebra");
+  assigned = copy;
+  EXPECT_EQ(std::vector<std::string>({"apple", "date", "fig", "kiwi", "pear"}),
+            drain(assigned));
+  EXPECT_EQ(5, copy.size());
+}
+
+
+TEST(TestPairingHeap, MoveShouldLeaveSourceEmpty)
+{
+  PairingHeap<int> heap;
+  heap.push(5);
+  heap.push(2);
+
+  PairingHeap<int> moved(std::move(heap));
+  EXPECT_TRUE(heap.empty());
+  EXPECT_EQ(2, moved.top());
+
+  heap = std::move(moved);
+  EXPECT_EQ(2, heap.size());
+  EXPECT_EQ(2, heap.top());
+}
+
+
+TEST(TestPairingHeap, MoveOnlyItemsShouldWork)
+{
+  struct PtrGreater
+  {
+    bool operator()
+      (const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) const
+    { return *a > *b; }
+  };
+
+  PairingHeap<std::unique_ptr<int>, PtrGreater> heap;
+  heap.emplace(new int(3));
+  heap.push(std::unique_ptr<int>(new int(10)));
+  heap.emplace(new int(7));
+
+  EXPECT_EQ(10, *heap.pop_value());
+  EXPECT_EQ(7, *heap.pop_value());
+  EXPECT_EQ(3, *heap.top());
+}
+
+
+TEST(TestPairingHeap, ClearShouldReleaseDeepTrees)
+{
+  // pushing increasing keys builds a long chain of children
+  PairingHeap<int, std::greater<int>> heap;
+  for (int i = 0; i < 200000; ++i)
+    heap.push(i);
+
+  heap.clear();
+  EXPECT_TRUE(heap.empty());
+  heap.push(1);
+  EXPECT_EQ(1, heap.top());
+}
+
+
+} // namespace
@@ -0,0 +1,91 @@
+/**
+ * @file test_parallel_queue.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/parallel_queue.hh"
+
+
+namespace {
+
+
+using ospp::PriorityQueue;
+using ospp::parallel_build;
+using ospp::parallel_drain_sorted;
+
+
+TEST(TestParallelQueue, ParallelBuildShouldBuildTheSameHeap)
+{
+  using Queue4 =
+    PriorityQueue<int, std::greater<int>, std::allocator<int>, 4>;
+  auto randInt = std::bind(std::uniform_int_distribution<>(0, 100000),
+                           std::default_random_engine(113));
+  for (int count : {0, 1, 100, 20000, 70001}) {
+    std::vector<int> ivec;
+    for (int i = 0; i < count; ++i) ivec.push_back(randInt());
+
+    // the levels are built in the same order, so the heaps are the same
+    for (std::size_t threads : {1, 2, 3, 5}) {
+      PriorityQueue<int> pq2(ivec.begin(), ivec.end());
+      auto parallel2 = parallel_build<PriorityQueue<int>>(
+        ivec.begin(), ivec.end(), threads);
+      EXPECT_EQ(pq2.toString(), parallel2.toString());
+
+      Queue4 pq4(ivec.begin(), ivec.end());
+      auto parallel4 =
+        parallel_build<Queue4>(ivec.begin(), ivec.end(), threads);
+      EXPECT_EQ(pq4.toString(), parallel4.toString());
+      EXPECT_EQ(pq4.hashCode(), parallel4.hashCode());
+    }
+  }
+}
+
+
+TEST(TestParallelQueue, ParallelDrainSortedShouldEmptyQueueInPopOrder)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(0, 5000),
+                           std::default_random_engine(127));
+  for (int count : {10, 20000, 50003}) {
+    std::vector<int> ivec;
+    for (int i = 0; i < count; ++i) ivec.push_back(randInt());
+    std::vector<int> sorted(ivec);
+    std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+
+    for (std::size_t threads : {1, 2, 3, 4, 7}) {
+      PriorityQueue<int, std::greater<int>> pq(ivec.begin(), ivec.end());
+      auto capacity = pq.capacity();
+
+      std::vector<int> drained;
+      parallel_drain_sorted(pq, std::back_inserter(drained), threads);
+      EXPECT_TRUE(pq.empty());
+      EXPECT_EQ(capacity, pq.capacity());
+      EXPECT_EQ(sorted, drained);
+    }
+  }
+
+  // move-only items
+  std::vector<std::unique_ptr<int>> drained;
+  auto before = [](const std::unique_ptr<int>& a,
+                   const std::unique_ptr<int>& b) { return *a < *b; };
+  PriorityQueue<std::unique_ptr<int>, std::function<bool(
+    const std::unique_ptr<int>&, const std::unique_ptr<int>&)>> pq(before);
+  for (int i = 0; i < 30000; ++i)
+    pq.emplace(new int((i * 7919) % 30011));
+  parallel_drain_sorted(pq, std::back_inserter(drained), 3);
+
+  ASSERT_EQ(30000, drained.size());
+  EXPECT_TRUE(std::is_sorted(drained.begin(), drained.end(), before));
+}
+
+
+} // anonymous namespace
@@ -5,8 +5,23 @@
  */
 
 #include <vector>
+#include <string>
+#include <stdexcept>
+#include <sstream>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <memory>
 #include <functional>
 #include <random>
+#include <algorithm>
+#include <utility>
+#include <cstdio>
+#include <cstdlib>
+#include <system_error>
+#include <thread>
+
+#include <unistd.h>
 
 #include "gtest/gtest.h"
 #include "queue/queue.hh"
@@ -18,6 +33,79 @@ namespace {
 using ospp::PriorityQueue;
 
 
+/**
+ * @brief Create an empty file with a unique name, so that concurrent test runs
+ *  never share a snapshot.
+ * @return The path of the file, which the test removes.
+ */
+std::string makeTempFile()
+{
+  char path[] = "/tmp/ospp-test-XXXXXX";
+  int fd = ::mkstemp(path);
+  EXPECT_LE(0, fd);
+  if (fd >= 0)
+    ::close(fd);
+  return path;
+}
+
+
+/**
+ * Copyable type whose move constructor may throw, and whose copy constructor
+ * throws once a global budget of copies runs out.
+ */
+struct ThrowingCopy
+{
+  static int copiesLeft;
+  int value;
+
+  ThrowingCopy(int v) : value(v) {}
+  ThrowingCopy(const ThrowingCopy& other) : value(other.value)
+  {
+    if (copiesLeft-- <= 0)
+      throw std::runtime_error("copy failed");
+  }
+  ThrowingCopy& operator=(const ThrowingCopy&) = default;
+  bool operator<(const ThrowingCopy& other) const { return value < other.value; }
+};
+
+int ThrowingCopy::copiesLeft = 0;
+
+
+/**
+ * Counts how many times values of this type are copied.
+ */
+struct CountingCopy
+{
+  static int copies;
+  int value;
+
+  CountingCopy(int v) : value(v) {}
+  CountingCopy(const CountingCopy& other) : value(other.value) { ++copies; }
+  CountingCopy(CountingCopy&&) noexcept = default;
+  CountingCopy& operator=(const CountingCopy& other)
+  {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+  CountingCopy& operator=(CountingCopy&&) noexcept = default;
+  bool operator<(const CountingCopy& other) const { return value < other.value; }
+};
+
+int CountingCopy::copies = 0;
+
+
+/**
+ * Orders unique pointers by the values they point to.
+ */
+struct PtrLess
+{
+  bool operator()
+    (const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) const
+  { return *a < *b; }
+};
+
+
 TEST(TestPriorityQueue, DefaultCtorShouldYieldEmptyQueue)
 {
   PriorityQueue<int> pq;
@@ -59,6 +147,116 @@ TEST(TestPriorityQueue, CtorWithRangeIteratorsShouldWork)
 }
 
 
+TEST(TestPriorityQueue, CtorWithForwardRangeShouldAllocateOnce)
+{
+  std::list<int> ilist({4, 8, 15, 16, 23, 42, 1, 2, 3, 5, 7, 11});
+  PriorityQueue<int> pq(ilist.begin(), ilist.end());
+  EXPECT_EQ(12, pq.size());
+  EXPECT_EQ(12, pq.capacity());
+  EXPECT_EQ(1, pq.top());
+}
+
+
+TEST(TestPriorityQueue, CtorWithInputRangeShouldWork)
+{
+  std::istringstream iss("9 4 7 1 8 2");
+  PriorityQueue<int> pq((std::istream_iterator<int>(iss)),
+                        std::istream_iterator<int>());
+  EXPECT_EQ(6, pq.size());
+
+  std::vector<int> ordered;
+  while (not pq.empty()) {
+    ordered.push_back(pq.top());
+    pq.pop();
+  }
+  EXPECT_EQ(std::vector<int>({1, 2, 4, 7, 8, 9}), ordered);
+}
+
+
+TEST(TestPriorityQueue, CtorWithEmptyRangeShouldYieldEmptyQueue)
+{
+  std::vector<int> ivec;
+  PriorityQueue<int> pq(ivec.begin(), ivec.end());
+  EXPECT_TRUE(pq.empty());
+  pq.push(3);
+  EXPECT_EQ(3, pq.top());
+}
+
+
+TEST(TestPriorityQueue, PushRangeShouldPreserveInvariant)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(),
+                           std::default_random_engine(79));
+  std::vector<int> ivec;
+  for (int i = 0; i < 500; ++i) ivec.push_back(randInt());
+
+  PriorityQueue<int, std::greater<int>> pq;
+  // large batches rebuild the heap, small batches bubble up
+  pq.push_range(ivec.begin(), ivec.begin() + 300);
+  pq.push_range(ivec.begin() + 300, ivec.begin() + 302);
+  pq.push_range(ivec.begin() + 302, ivec.end());
+  EXPECT_EQ(500, pq.size());
+
+  std::vector<int> ordered;
+  while (not pq.empty()) {
+    ordered.push_back(pq.top());
+    pq.pop();
+  }
+  std::sort(ivec.begin(), ivec.end(), std::greater<int>());
+  EXPECT_EQ(ivec, ordered);
+}
+
+
+TEST(TestPriorityQueue, MergeShouldMoveAllItemsAndEmptyOther)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(),
+                           std::default_random_engine(83));
+  std::vector<int> ivec;
+  for (int i = 0; i < 600; ++i) ivec.push_back(randInt());
+
+  // merge a large queue into a small one, then a small one into the result
+  PriorityQueue<int, std::greater<int>, std::allocator<int>, 4> pq1(
+    ivec.begin(), ivec.begin() + 10);
+  PriorityQueue<int, std::greater<int>, std::allocator<int>, 4> pq2(
+    ivec.begin() + 10, ivec.begin() + 597);
+  PriorityQueue<int, std::greater<int>, std::allocator<int>, 4> pq3(
+    ivec.begin() + 597, ivec.end());
+
+  pq1.merge(std::move(pq2));
+  EXPECT_TRUE(pq2.empty());
+  EXPECT_EQ(597, pq1.size());
+  pq1.merge(std::move(pq3));
+  EXPECT_TRUE(pq3.empty());
+  EXPECT_EQ(600, pq1.size());
+
+  std::vector<int> ordered;
+  pq1.drain_sorted(std::back_inserter(ordered));
+  std::sort(ivec.begin(), ivec.end(), std::greater<int>());
+  EXPECT_EQ(ivec, ordered);
+
+  // the emptied queues are still usable
+  pq2.push(4);
+  pq2.merge(std::move(pq1));
+  EXPECT_EQ(4, pq2.top());
+}
+
+
+TEST(TestPriorityQueue, MergeShouldNotCopyItems)
+{
+  PriorityQueue<CountingCopy, std::less<CountingCopy>> pq1, pq2;
+  for (int i = 0; i < 20; ++i) {
+    pq1.push(CountingCopy(i));
+    pq2.push(CountingCopy(i * 3));
+  }
+
+  CountingCopy::copies = 0;
+  pq1.merge(std::move(pq2));
+  EXPECT_EQ(0, CountingCopy::copies);
+  EXPECT_EQ(40, pq1.size());
+  EXPECT_EQ(0, pq1.top().value);
+}
+
+
 TEST(TestPriorityQueue, PushShouldPushCorrectNumberOfEntries)
 {
   PriorityQueue<int> pq;
@@ -171,21 +369,798 @@ TEST(TestPriorityQueue, CapacityShouldDoubleCorrectly)
 }
 
 
-// Test toString
-// TODO: implement test when priority queue iter is ready
-TEST(TestPriorityQueue, DISABLED_toString)
+TEST(TestPriorityQueue, DefaultArityShouldBeBinary)
 {
-  PriorityQueue<int> pq;
+  EXPECT_EQ(2, PriorityQueue<int>::arity);
+  EXPECT_EQ(4, (PriorityQueue<int, std::less<int>, std::allocator<int>, 4>::arity));
+}
+
+
+TEST(TestPriorityQueue, PoppingDaryQueueShouldYieldSortedElements)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(),
+                           std::default_random_engine(73));
+  std::vector<int> ivec;
+  for (int i = 0; i < 1000; ++i) ivec.push_back(randInt());
+
+  PriorityQueue<int, std::less<int>, std::allocator<int>, 4>
+    pq4(ivec.cbegin(), ivec.cend());
+  PriorityQueue<int, std::greater<int>, std::allocator<int>, 8>
+    pq8(ivec.cbegin(), ivec.cend());
+  EXPECT_EQ(ivec.size(), pq4.size());
+  EXPECT_EQ(ivec.size(), pq8.size());
+
+  std::vector<int> ascending, descending;
+  while (not pq4.empty()) {
+    ascending.push_back(pq4.top());
+    pq4.pop();
+  }
+  while (not pq8.empty()) {
+    descending.push_back(pq8.top());
+    pq8.pop();
+  }
+
+  std::sort(ivec.begin(), ivec.end());
+  EXPECT_EQ(ivec, ascending);
+  std::reverse(ivec.begin(), ivec.end());
+  EXPECT_EQ(ivec, descending);
+}
+
+
+TEST(TestPriorityQueue, DaryQueueWithPartialLastFamilyShouldPopCorrectly)
+{
+  PriorityQueue<int, std::less<int>, std::allocator<int>, 3> pq;
+  pq.push(5);
+  pq.push(4);
+  pq.push(9);
+  pq.push(1);
+  pq.push(7);
+
+  EXPECT_EQ(1, pq.top());
+  pq.pop();
+  EXPECT_EQ(4, pq.top());
+  pq.pop();
+  EXPECT_EQ(5, pq.top());
+  pq.pop();
+  EXPECT_EQ(7, pq.top());
+  pq.pop();
+  EXPECT_EQ(9, pq.top());
+  pq.pop();
   EXPECT_TRUE(pq.empty());
 }
 
 
-// Test hashCode
-// TODO: implement test
-TEST(TestPriorityQueue, DISABLED_hashCode)
+TEST(TestPriorityQueue, GrowthPoliciesShouldComputeCapacity)
+{
+  EXPECT_EQ(16, ospp::DoublingGrowth::grow(8, 9));
+  EXPECT_EQ(1, ospp::DoublingGrowth::grow(0, 1));
+  EXPECT_EQ(12, ospp::HalfAgainGrowth::grow(8, 9));
+  EXPECT_EQ(2, ospp::HalfAgainGrowth::grow(1, 2));
+  EXPECT_EQ(40, ospp::ChunkGrowth<32>::grow(8, 9));
+}
+
+
+TEST(TestPriorityQueue, GrowthPolicyShouldSetCapacity)
+{
+  PriorityQueue<int, std::less<int>, std::allocator<int>, 2,
+                ospp::ChunkGrowth<4>> pq;
+  for (int i = 0; i < 9; ++i)
+    pq.push(i);
+  EXPECT_EQ(12, pq.capacity());
+  EXPECT_EQ(0, pq.top());
+}
+
+
+TEST(TestPriorityQueue, ReserveShouldOnlyGrowCapacity)
+{
+  PriorityQueue<std::string> pq;
+  pq.push("b");
+  pq.push("a");
+
+  pq.reserve(100);
+  EXPECT_EQ(100, pq.capacity());
+  EXPECT_EQ(2, pq.size());
+  EXPECT_EQ("a", pq.top());
+
+  pq.reserve(10);
+  EXPECT_EQ(100, pq.capacity());
+}
+
+
+TEST(TestPriorityQueue, ShrinkToFitShouldKeepItems)
+{
+  PriorityQueue<std::string> pq(50);
+  pq.push("c");
+  pq.push("a");
+  pq.push("b");
+
+  pq.shrink_to_fit();
+  EXPECT_EQ(3, pq.capacity());
+  EXPECT_EQ("a", pq.top());
+  pq.pop();
+  EXPECT_EQ("b", pq.top());
+
+  pq.push("d");
+  pq.push("e");
+  EXPECT_EQ(4, pq.size());
+  EXPECT_EQ("b", pq.top());
+}
+
+
+TEST(TestPriorityQueue, PushingItemFromQueueShouldSurviveGrowth)
+{
+  PriorityQueue<std::string> pq(1);
+  pq.push("only");
+  pq.push(pq.top());
+  EXPECT_EQ(2, pq.size());
+  EXPECT_EQ("only", pq.top());
+  pq.pop();
+  EXPECT_EQ("only", pq.top());
+}
+
+
+TEST(TestPriorityQueue, FailedGrowthShouldLeaveQueueUnchanged)
+{
+  PriorityQueue<ThrowingCopy> pq(2);
+  ThrowingCopy::copiesLeft = 100;
+  pq.push(ThrowingCopy(3));
+  pq.push(ThrowingCopy(1));
+
+  // the new item and the first relocated item are copied, the second throws
+  ThrowingCopy::copiesLeft = 2;
+  EXPECT_THROW(pq.push(ThrowingCopy(2)), std::runtime_error);
+  ThrowingCopy::copiesLeft = 100;
+  EXPECT_EQ(2, pq.size());
+  EXPECT_EQ(2, pq.capacity());
+  EXPECT_EQ(1, pq.top().value);
+
+  ThrowingCopy::copiesLeft = 1;
+  EXPECT_THROW(pq.reserve(10), std::runtime_error);
+  ThrowingCopy::copiesLeft = 100;
+  EXPECT_EQ(2, pq.capacity());
+  EXPECT_EQ(1, pq.top().value);
+}
+
+
+TEST(TestPriorityQueue, CopyAndMoveShouldPreserveItems)
+{
+  PriorityQueue<std::string> pq;
+  pq.push("b");
+  pq.push("a");
+  pq.push("c");
+
+  PriorityQueue<std::string> copy(pq);
+  EXPECT_TRUE(copy == pq);
+
+  PriorityQueue<std::string> moved(std::move(copy));
+  EXPECT_TRUE(moved == pq);
+  EXPECT_TRUE(copy.empty());
+
+  copy.push("z");
+  EXPECT_EQ("z", copy.top());
+
+  copy = pq;
+  EXPECT_TRUE(copy == pq);
+
+  PriorityQueue<std::string> assigned;
+  assigned = std::move(moved);
+  EXPECT_EQ(3, assigned.size());
+  EXPECT_EQ("a", assigned.top());
+}
+
+
+TEST(TestPriorityQueue, TopShouldReturnReference)
+{
+  PriorityQueue<std::string> pq;
+  pq.push("x");
+  const std::string& top = pq.top();
+  EXPECT_EQ(&top, &pq.top());
+  EXPECT_EQ("x", top);
+}
+
+
+TEST(TestPriorityQueue, PushAndPopShouldNotCopyItems)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(),
+                           std::default_random_engine(83));
+  PriorityQueue<CountingCopy> pq;
+  CountingCopy::copies = 0;
+
+  for (int i = 0; i < 200; ++i)
+    pq.push(CountingCopy(randInt()));
+
+  int last = pq.top().value;
+  while (not pq.empty()) {
+    auto val = pq.pop_value();
+    EXPECT_LE(last, val.value);
+    last = val.value;
+  }
+
+  EXPECT_EQ(0, CountingCopy::copies);
+}
+
+
+TEST(TestPriorityQueue, MoveOnlyItemsShouldBeSupported)
+{
+  PriorityQueue<std::unique_ptr<int>, PtrLess> pq;
+  for (int i : {5, 3, 9, 1})
+    pq.push(std::unique_ptr<int>(new int(i)));
+
+  EXPECT_EQ(1, *pq.top());
+  EXPECT_EQ(1, *pq.pop_value());
+  EXPECT_EQ(3, *pq.pop_value());
+
+  pq.replace_top(std::unique_ptr<int>(new int(10)));
+  EXPECT_EQ(9, *pq.top());
+
+  auto popped = pq.pushpop(std::unique_ptr<int>(new int(2)));
+  EXPECT_EQ(2, *popped);
+  popped = pq.pushpop(std::unique_ptr<int>(new int(12)));
+  EXPECT_EQ(9, *popped);
+  EXPECT_EQ(2, pq.size());
+  EXPECT_EQ(10, *pq.top());
+}
+
+
+TEST(TestPriorityQueue, ReplaceTopShouldMatchPopThenPush)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(0, 1000),
+                           std::default_random_engine(89));
+  PriorityQueue<int, std::less<int>, std::allocator<int>, 4> pq1, pq2;
+  for (int i = 0; i < 100; ++i) {
+    auto r = randInt();
+    pq1.push(r);
+    pq2.push(r);
+  }
+
+  for (int i = 0; i < 100; ++i) {
+    auto r = randInt();
+    pq1.replace_top(r);
+    pq2.pop();
+    pq2.push(r);
+    EXPECT_EQ(pq2.top(), pq1.top());
+  }
+}
+
+
+TEST(TestPriorityQueue, PushPopShouldReturnBestValue)
 {
   PriorityQueue<int> pq;
+  EXPECT_EQ(4, pq.pushpop(4));
   EXPECT_TRUE(pq.empty());
+
+  pq.push(3);
+  pq.push(6);
+  EXPECT_EQ(1, pq.pushpop(1));
+  EXPECT_EQ(3, pq.pushpop(5));
+  EXPECT_EQ(2, pq.size());
+  EXPECT_EQ(5, pq.top());
+}
+
+
+TEST(TestPriorityQueue, BottomUpPopShouldYieldSortedElements)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(0, 100),
+                           std::default_random_engine(97));
+  std::vector<int> ivec;
+  for (int i = 0; i < 1000; ++i) ivec.push_back(randInt());
+
+  PriorityQueue<int, std::less<int>, std::allocator<int>, 2,
+                ospp::DoublingGrowth, ospp::BottomUpPop>
+    pq2(ivec.cbegin(), ivec.cend());
+  PriorityQueue<int, std::less<int>, std::allocator<int>, 4,
+                ospp::DoublingGrowth, ospp::BottomUpPop>
+    pq4(ivec.cbegin(), ivec.cend());
+
+  std::vector<int> ordered2, ordered4;
+  while (not pq2.empty())
+    ordered2.push_back(pq2.pop_value());
+  while (not pq4.empty())
+    ordered4.push_back(pq4.pop_value());
+
+  std::sort(ivec.begin(), ivec.end());
+  EXPECT_EQ(ivec, ordered2);
+  EXPECT_EQ(ivec, ordered4);
+}
+
+
+TEST(TestPriorityQueue, BottomUpPopShouldCompareLess)
+{
+  int count = 0;
+  auto comp = [&count](int a, int b) { ++count; return a < b; };
+  using Comp = decltype(comp);
+
+  auto randInt = std::bind(std::uniform_int_distribution<>(),
+                           std::default_random_engine(101));
+  std::vector<int> ivec;
+  for (int i = 0; i < 4096; ++i) ivec.push_back(randInt());
+
+  PriorityQueue<int, Comp> topDown(comp);
+  PriorityQueue<int, Comp, std::allocator<int>, 2,
+                ospp::DoublingGrowth, ospp::BottomUpPop> bottomUp(comp);
+  for (auto i : ivec) {
+    topDown.push(i);
+    bottomUp.push(i);
+  }
+
+  count = 0;
+  while (not topDown.empty())
+    topDown.pop();
+  auto topDownCount = count;
+
+  count = 0;
+  while (not bottomUp.empty())
+    bottomUp.pop();
+  auto bottomUpCount = count;
+
+  EXPECT_LT(bottomUpCount, topDownCount * 3 / 4);
+}
+
+
+TEST(TestPriorityQueue, DrainSortedShouldEmptyQueueInPopOrder)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(0, 500),
+                           std::default_random_engine(109));
+  std::vector<int> ivec;
+  for (int i = 0; i < 777; ++i) ivec.push_back(randInt());
+
+  PriorityQueue<int, std::greater<int>, std::allocator<int>, 4> pq(
+    ivec.begin(), ivec.end());
+  auto capacity = pq.capacity();
+
+  std::vector<int> drained;
+  pq.drain_sorted(std::back_inserter(drained));
+
+  EXPECT_TRUE(pq.empty());
+  EXPECT_EQ(capacity, pq.capacity());
+  std::sort(ivec.begin(), ivec.end(), std::greater<int>());
+  EXPECT_EQ(ivec, drained);
+}
+
+
+TEST(TestPriorityQueue, BHeapLayoutShouldYieldSortedElements)
+{
+  using ospp::BHeapLayout;
+  using ospp::BottomUpPop;
+  using ospp::DoublingGrowth;
+  using ospp::TopDownPop;
+
+  // small pages, so that the heaps span many blocks
+  for (int count : {1, 2, 15, 16, 17, 300, 5000}) {
+    std::vector<int> ivec;
+    for (int i = 0; i < count; ++i) ivec.push_back((i * 7919) % 10007);
+    std::vector<int> sorted(ivec);
+    std::sort(sorted.begin(), sorted.end());
+
+    PriorityQueue<int, std::less<int>, std::allocator<int>, 2,
+                  DoublingGrowth, TopDownPop, BHeapLayout<16>> pq2;
+    for (auto i : ivec)
+      pq2.push(i);
+    PriorityQueue<int, std::less<int>, std::allocator<int>, 2,
+                  DoublingGrowth, BottomUpPop, BHeapLayout<128>>
+      pqBottomUp(ivec.begin(), ivec.end());
+
+    std::vector<int> ordered, orderedBottomUp;
+    while (not pq2.empty())
+      ordered.push_back(pq2.pop_value());
+    pqBottomUp.drain_sorted(std::back_inserter(orderedBottomUp));
+
+    EXPECT_EQ(sorted, ordered);
+    EXPECT_EQ(sorted, orderedBottomUp);
+  }
+}
+
+
+TEST(TestPriorityQueue, BHeapLayoutShouldSupportBatchesAndMerge)
+{
+  using Queue = PriorityQueue<int, std::greater<int>, std::allocator<int>, 2,
+                              ospp::DoublingGrowth, ospp::TopDownPop,
+                              ospp::BHeapLayout<32>>;
+
+  auto randInt = std::bind(std::uniform_int_distribution<>(),
+                           std::default_random_engine(113));
+  std::vector<int> ivec;
+  for (int i = 0; i < 2000; ++i) ivec.push_back(randInt());
+
+  // a large batch rebuilds the heap, a small one bubbles up
+  Queue pq1, pq2;
+  pq1.push_range(ivec.begin(), ivec.begin() + 1000);
+  pq1.push_range(ivec.begin() + 1000, ivec.begin() + 1003);
+  for (int i = 1003; i < 2000; ++i)
+    pq2.push(ivec[i]);
+
+  pq1.merge(std::move(pq2));
+  EXPECT_EQ(2000, pq1.size());
+
+  std::vector<int> ordered;
+  pq1.drain_sorted(std::back_inserter(ordered));
+  std::sort(ivec.begin(), ivec.end(), std::greater<int>());
+  EXPECT_EQ(ivec, ordered);
+}
+
+
+/**
+ * Pop a queue in batches of growing size and check the popped items against
+ * the sorted input.
+ */
+template<typename Queue, typename Item>
+void checkPopN(const std::vector<Item>& items, const std::vector<Item>& sorted)
+{
+  Queue pq(items.begin(), items.end());
+  std::vector<Item> popped;
+  for (std::size_t k = 0; !pq.empty(); k = k * 2 + 1)
+  {
+    auto before = popped.size();
+    pq.pop_n(k, std::back_inserter(popped));
+    EXPECT_EQ(std::min(k, sorted.size() - before), popped.size() - before);
+    EXPECT_EQ(items.size(), popped.size() + pq.size());
+    if (!pq.empty()) {
+      EXPECT_EQ(sorted[popped.size()], pq.top());
+    }
+  }
+  EXPECT_EQ(sorted, popped);
+}
+
+
+TEST(TestPriorityQueue, PopNShouldPopTheBestItemsInOrder)
+{
+  using ospp::BHeapLayout;
+  using ospp::BottomUpPop;
+  using ospp::DoublingGrowth;
+  using ospp::TopDownPop;
+  using Item = std::pair<int, int>;
+  using Greater = std::greater<Item>;
+
+  auto randInt = std::bind(std::uniform_int_distribution<>(0, 3000),
+                           std::default_random_engine(127));
+  for (int count : {1, 2, 5, 64, 1000, 5000}) {
+    std::vector<Item> items;
+    for (int i = 0; i < count; ++i) items.emplace_back(randInt(), i % 3);
+    std::vector<Item> sorted(items);
+    std::sort(sorted.begin(), sorted.end(), Greater());
+
+    // pairs are fixed once per batch, ints are popped one at a time
+    checkPopN<PriorityQueue<Item, Greater>>(items, sorted);
+    checkPopN<PriorityQueue<Item, Greater, std::allocator<Item>, 4,
+                            DoublingGrowth, BottomUpPop>>(items, sorted);
+    checkPopN<PriorityQueue<Item, Greater, std::allocator<Item>, 2,
+                            DoublingGrowth, TopDownPop, BHeapLayout<32>>>(
+      items, sorted);
+
+    std::vector<int> ints, sortedInts;
+    for (auto& item : items) ints.push_back(item.first);
+    for (auto& item : sorted) sortedInts.push_back(item.first);
+    checkPopN<PriorityQueue<int, std::greater<int>>>(ints, sortedInts);
+  }
+}
+
+
+TEST(TestPriorityQueue, PopNShouldMoveItemsAndKeepTheHash)
+{
+  PriorityQueue<std::unique_ptr<int>,
+                std::function<bool(const std::unique_ptr<int>&,
+                                   const std::unique_ptr<int>&)>>
+    ptrs([](const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) {
+      return *a < *b;
+    });
+  for (int i = 0; i < 100; ++i)
+    ptrs.push(std::unique_ptr<int>(new int(i * 37 % 100)));
+
+  std::vector<std::unique_ptr<int>> best;
+  ptrs.pop_n(10, std::back_inserter(best));
+  ASSERT_EQ(10, best.size());
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(i, *best[i]);
+  EXPECT_EQ(10, *ptrs.top());
+
+  struct Hash
+  {
+    std::size_t operator()(const std::string& s) const
+    { return std::hash<std::string>()(s); }
+  };
+  PriorityQueue<std::string> pq;
+  for (int i = 0; i < 500; ++i) pq.push(std::to_string(i * 7 % 331));
+  std::vector<std::string> popped;
+  pq.pop_n(100, std::back_inserter(popped));
+  EXPECT_EQ(100, popped.size());
+  EXPECT_EQ(pq.hashCode(Hash()), pq.hashCode());
+}
+
+
+TEST(TestPriorityQueue, CountingStatsShouldCountTheWork)
+{
+  using ospp::CountingStats;
+  using ospp::DoublingGrowth;
+  using ospp::FlatLayout;
+  using ospp::TopDownPop;
+  using Queue = PriorityQueue<int, std::less<int>, std::allocator<int>, 2,
+                              DoublingGrowth, TopDownPop, FlatLayout,
+                              CountingStats>;
+
+  // the same members without the stats: NoStats only takes padding
+  struct WithoutStats
+  {
+    std::string *ptr;
+    std::allocator<std::string> alloc;
+    std::less<std::string> compare;
+    std::size_t size;
+    std::size_t count;
+    ospp::detail::ItemHash<std::string> hash;
+  };
+  static_assert(sizeof(PriorityQueue<std::string>) == sizeof(WithoutStats),
+                "the default stats policy should not change the size");
+
+  // pushing increasing keys never sifts, so only the parents are compared
+  Queue pq;
+  for (int i = 0; i < 100; ++i) pq.push(i);
+  auto stats = pq.stats().snapshot();
+  EXPECT_EQ(99, stats.comparisons);
+  EXPECT_EQ(100, stats.siftUp[0]);
+  EXPECT_EQ(4, stats.reallocations);
+  EXPECT_EQ(stats.bytesReallocated / sizeof(int), stats.moves);
+
+  // the last key sinks from the root, with two comparisons per level
+  pq.stats().reset();
+  pq.pop();
+  stats = pq.stats().snapshot();
+  std::uint64_t sifts = 0;
+  std::uint64_t levels = 0;
+  for (std::size_t d = 0; d < ospp::StatsSnapshot::DEPTHS; ++d)
+  {
+    sifts += stats.siftDown[d];
+    levels += d * stats.siftDown[d];
+  }
+  EXPECT_EQ(1, sifts);
+  EXPECT_EQ(levels, stats.moves);
+  EXPECT_EQ(2 * levels, stats.comparisons);
+  EXPECT_EQ(0, stats.reallocations);
+
+  std::ostringstream oss;
+  oss << stats;
+  EXPECT_EQ(0, oss.str().find("{\"comparisons\": "));
+
+  // a copy counts its own work
+  Queue copy(pq);
+  EXPECT_EQ(0, copy.stats().snapshot().comparisons);
+}
+
+
+TEST(TestPriorityQueue, LoadShouldRestoreTheSavedHeap)
+{
+  const std::string path = makeTempFile();
+  using Queue = PriorityQueue<std::int64_t, std::greater<std::int64_t>,
+                              std::allocator<std::int64_t>, 4>;
+
+  Queue pq;
+  for (int i = 0; i < 5000; ++i)
+    pq.push((i * 7919) % 5003);
+  pq.save(path);
+
+  // the items are adopted as they were saved, in heap order
+  Queue loaded;
+  loaded.push(-1);
+  loaded.load(path);
+  EXPECT_EQ(pq.size(), loaded.size());
+  EXPECT_EQ(pq, loaded);
+  EXPECT_EQ(pq.hashCode(), loaded.hashCode());
+
+  loaded.push(6000);
+  EXPECT_EQ(6000, loaded.top());
+  loaded.pop();
+  while (!pq.empty())
+  {
+    ASSERT_EQ(pq.top(), loaded.top());
+    pq.pop();
+    loaded.pop();
+  }
+  EXPECT_TRUE(loaded.empty());
+
+  // an empty queue round trips too
+  pq.save(path);
+  loaded.push(1);
+  loaded.load(path);
+  EXPECT_TRUE(loaded.empty());
+  std::remove(path.c_str());
+}
+
+
+TEST(TestPriorityQueue, ConcurrentSavesShouldNotTearTheSnapshot)
+{
+  const std::string path = makeTempFile();
+  std::vector<PriorityQueue<std::int64_t>> queues(2);
+  for (std::int64_t i = 0; i < 100000; ++i) {
+    queues[0].push(i);
+    queues[1].push(-i);
+  }
+
+  // each save writes its own file, so the last rename wins whole
+  std::vector<std::thread> threads;
+  for (auto& pq : queues)
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 20; ++i)
+        pq.save(path);
+    });
+  for (auto& thread : threads)
+    thread.join();
+
+  PriorityQueue<std::int64_t> loaded;
+  loaded.load(path);
+  EXPECT_TRUE(loaded == queues[0] || loaded == queues[1]);
+  std::remove(path.c_str());
+}
+
+
+TEST(TestPriorityQueue, LoadShouldRejectOtherSnapshots)
+{
+  const std::string path = makeTempFile();
+  PriorityQueue<int> pq2;
+  for (int i = 0; i < 100; ++i)
+    pq2.push(i);
+  pq2.save(path);
+
+  // another arity would see a broken heap
+  PriorityQueue<int, std::less<int>, std::allocator<int>, 4> pq4;
+  pq4.push(7);
+  EXPECT_THROW(pq4.load(path), std::system_error);
+  EXPECT_EQ(1, pq4.size());
+
+  // so would another item type
+  PriorityQueue<std::int64_t> pq64;
+  EXPECT_THROW(pq64.load(path), std::system_error);
+
+  // a truncated file
+  std::FILE *file = std::fopen(path.c_str(), "r+b");
+  ASSERT_NE(nullptr, file);
+  std::fseek(file, 0, SEEK_END);
+  auto length = std::ftell(file);
+  std::fclose(file);
+  ASSERT_EQ(0, truncate(path.c_str(), length - 1));
+  PriorityQueue<int> truncated;
+  EXPECT_THROW(truncated.load(path), std::system_error);
+  EXPECT_TRUE(truncated.empty());
+
+  std::remove(path.c_str());
+  EXPECT_THROW(truncated.load(path), std::system_error);
+  EXPECT_THROW(pq2.save("/nonexistent/ospp.snapshot"), std::system_error);
+}
+
+
+TEST(TestPriorityQueue, ToStringShouldMatchOutputOperator)
+{
+  PriorityQueue<int> ipq;
+  EXPECT_EQ("{}", ipq.toString());
+
+  for (auto i : {5, -12, 0, 2147483647, -2147483647 - 1, 42})
+    ipq.push(i);
+  std::ostringstream iss;
+  iss << ipq;
+  EXPECT_EQ(iss.str(), ipq.toString());
+
+  PriorityQueue<double> dpq;
+  for (auto d : {3.25, -0.001, 1e300, 123456789.0, 0.0})
+    dpq.push(d);
+  std::ostringstream dss;
+  dss << dpq;
+  EXPECT_EQ(dss.str(), dpq.toString());
+
+  PriorityQueue<std::string> spq;
+  spq.push("pear");
+  spq.push("apple");
+  EXPECT_EQ("{apple, pear}", spq.toString());
+
+  PriorityQueue<char> cpq;
+  cpq.push('b');
+  cpq.push('a');
+  EXPECT_EQ("{a, b}", cpq.toString());
+}
+
+
+TEST(TestPriorityQueue, HashCodeShouldNotDependOnOrder)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(-50, 50),
+                           std::default_random_engine(89));
+  std::vector<int> ivec;
+  for (int i = 0; i < 300; ++i) ivec.push_back(randInt());
+
+  PriorityQueue<int> pq1(ivec.begin(), ivec.end());
+  PriorityQueue<int, std::less<int>, std::allocator<int>, 4> pq2;
+  for (auto it = ivec.rbegin(); it != ivec.rend(); ++it)
+    pq2.push(*it);
+
+  EXPECT_EQ(pq1.hashCode(), pq2.hashCode());
+  EXPECT_NE(PriorityQueue<int>().hashCode(), pq1.hashCode());
+
+  // the kept hash matches hashing every item
+  struct Hash
+  {
+    std::size_t operator()(int i) const { return std::hash<int>()(i); }
+  };
+  EXPECT_EQ(pq1.hashCode(Hash()), pq1.hashCode());
+
+  // {1, 3} and {2, 2} have the same sum
+  PriorityQueue<int> pq3, pq4;
+  pq3.push(1);
+  pq3.push(3);
+  pq4.push(2);
+  pq4.push(2);
+  EXPECT_NE(pq3.hashCode(), pq4.hashCode());
+}
+
+
+TEST(TestPriorityQueue, HashCodeShouldFollowEveryChange)
+{
+  struct Hash
+  {
+    std::size_t operator()(int i) const { return std::hash<int>()(i); }
+  };
+  auto check = [](const PriorityQueue<int>& pq) {
+    return pq.hashCode() == pq.hashCode(Hash());
+  };
+
+  PriorityQueue<int> pq;
+  for (int i = 0; i < 100; ++i) pq.push(i * 7 % 31);
+  EXPECT_TRUE(check(pq));
+  pq.pop();
+  pq.replace_top(77);
+  pq.pushpop(-5);
+  pq.pushpop(500);
+  EXPECT_TRUE(check(pq));
+
+  std::vector<int> more{4, 8, 15, 16, 23, 42};
+  pq.push_range(more.begin(), more.end());
+  PriorityQueue<int> other(more.begin(), more.end());
+  pq.merge(std::move(other));
+  EXPECT_TRUE(check(pq));
+  EXPECT_TRUE(check(other));
+
+  PriorityQueue<int> copy(pq);
+  EXPECT_EQ(pq.hashCode(), copy.hashCode());
+  copy.shrink_to_fit();
+  EXPECT_EQ(pq.hashCode(), copy.hashCode());
+
+  PriorityQueue<int> moved(std::move(copy));
+  EXPECT_EQ(pq.hashCode(), moved.hashCode());
+  EXPECT_TRUE(check(copy));
+
+  moved.swap(other);
+  EXPECT_EQ(pq.hashCode(), other.hashCode());
+  EXPECT_TRUE(check(moved));
+
+  std::vector<int> sorted;
+  pq.drain_sorted(std::back_inserter(sorted));
+  EXPECT_EQ(PriorityQueue<int>().hashCode(), pq.hashCode());
+  other.clear();
+  EXPECT_EQ(PriorityQueue<int>().hashCode(), other.hashCode());
+}
+
+
+TEST(TestPriorityQueue, HashCodeShouldFollowItemsMovedOut)
+{
+  // the hash of an item must be taken before the item is moved out
+  struct Hash
+  {
+    std::size_t operator()(const std::string& s) const
+    {
+      return std::hash<std::string>()(s);
+    }
+  };
+
+  std::vector<std::string> words;
+  for (int i = 0; i < 50; ++i)
+    words.push_back("a word long enough to be allocated " + std::to_string(i));
+  std::sort(words.begin(), words.end());
+
+  PriorityQueue<std::string> pq(words.begin(), words.end());
+  EXPECT_EQ(words[0], pq.pop_value());
+  EXPECT_EQ(words[1], pq.pop_value());
+  std::vector<std::string> best;
+  pq.pop_n(5, std::back_inserter(best));
+  EXPECT_EQ(std::vector<std::string>(words.begin() + 2, words.begin() + 7),
+            best);
+
+  PriorityQueue<std::string> fresh(words.begin() + 7, words.end());
+  EXPECT_EQ(fresh.hashCode(), pq.hashCode());
+  EXPECT_EQ(pq.hashCode(Hash()), pq.hashCode());
 }
 
 } // anonymous namespace
@@ -0,0 +1,196 @@
+/**
+ * @file test_radix_queue.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/radix_queue.hh"
+
+
+namespace {
+
+
+using ospp::RadixPriorityQueue;
+
+
+/**
+ * An allocator that fails once its copies have made a number of allocations.
+ */
+template<typename T>
+struct LimitedAllocator
+{
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+
+  LimitedAllocator() : budget(nullptr) {}
+  explicit LimitedAllocator(std::size_t *budget) : budget(budget) {}
+
+  template<typename U>
+  LimitedAllocator(const LimitedAllocator<U>& other) : budget(other.budget) {}
+
+  T* allocate(std::size_t n)
+  {
+    if (*budget == 0)
+      throw std::bad_alloc();
+    --*budget;
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T *ptr, std::size_t n)
+  {
+    std::allocator<T>().deallocate(ptr, n);
+  }
+
+  std::size_t *budget;
+};
+
+template<typename T, typename U>
+bool operator==(const LimitedAllocator<T>& a, const LimitedAllocator<U>& b)
+{
+  return a.budget == b.budget;
+}
+
+template<typename T, typename U>
+bool operator!=(const LimitedAllocator<T>& a, const LimitedAllocator<U>& b)
+{
+  return !(a == b);
+}
+
+
+TEST(TestRadixPriorityQueue, DefaultCtorShouldYieldEmptyQueue)
+{
+  RadixPriorityQueue<unsigned> pq;
+  EXPECT_TRUE(pq.empty());
+  EXPECT_EQ(0, pq.size());
+}
+
+
+TEST(TestRadixPriorityQueue, PopShouldYieldKeysInOrder)
+{
+  RadixPriorityQueue<std::uint64_t> pq;
+  for (std::uint64_t k : {7, 3, 9, 3, 1 << 20, 0, 12})
+    pq.push(k);
+
+  EXPECT_EQ(7, pq.size());
+  std::vector<std::uint64_t> ordered;
+  while (not pq.empty()) {
+    ordered.push_back(pq.top());
+    pq.pop();
+  }
+  EXPECT_EQ(std::vector<std::uint64_t>({0, 3, 3, 7, 9, 12, 1 << 20}), ordered);
+}
+
+
+TEST(TestRadixPriorityQueue, SignedKeysShouldBeOrdered)
+{
+  RadixPriorityQueue<int> pq;
+  for (int k : {5, -3, 0, -100, 42})
+    pq.push(k);
+
+  std::vector<int> ordered;
+  while (not pq.empty()) {
+    ordered.push_back(pq.top());
+    pq.pop();
+  }
+  EXPECT_EQ(std::vector<int>({-100, -3, 0, 5, 42}), ordered);
+}
+
+
+TEST(TestRadixPriorityQueue, PushAfterRunningDryShouldWork)
+{
+  RadixPriorityQueue<unsigned> pq;
+  pq.push(4);
+  pq.pop();
+  EXPECT_TRUE(pq.empty());
+
+  pq.push(10);
+  pq.push(4);
+  EXPECT_EQ(4, pq.top());
+  pq.pop();
+  EXPECT_EQ(10, pq.top());
+}
+
+
+TEST(TestRadixPriorityQueue, KeyBelowTopButAboveLastPoppedShouldBeAllowed)
+{
+  RadixPriorityQueue<unsigned> pq;
+  pq.push(5);
+  pq.push(10);
+  pq.pop();
+  pq.push(6);
+  EXPECT_EQ(6, pq.top());
+  pq.pop();
+  EXPECT_EQ(10, pq.top());
+}
+
+
+TEST(TestRadixPriorityQueue, MonotoneWorkloadShouldMatchSortedOrder)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<std::uint32_t>(0, 999),
+                           std::default_random_engine(107));
+  RadixPriorityQueue<std::uint32_t> pq;
+  std::vector<std::uint32_t> popped;
+
+  for (int i = 0; i < 100; ++i)
+    pq.push(randInt());
+
+  // hold model: pop the minimum, push a larger key
+  for (int i = 0; i < 5000; ++i) {
+    auto k = pq.top();
+    popped.push_back(k);
+    pq.pop();
+    pq.push(k + randInt());
+  }
+
+  EXPECT_EQ(100, pq.size());
+  EXPECT_TRUE(std::is_sorted(popped.begin(), popped.end()));
+}
+
+
+TEST(TestRadixPriorityQueue, FailedSplitShouldLeaveQueueUnchanged)
+{
+  std::size_t budget = 100;
+  RadixPriorityQueue<unsigned, LimitedAllocator<unsigned>> pq{
+    LimitedAllocator<unsigned>(&budget)};
+  pq.push(0);
+  for (unsigned k = 100; k < 108; ++k)
+    pq.push(k);
+  pq.pop();
+
+  // the split moves 100 into bucket 0, then fails to allocate bucket 1
+  budget = 0;
+  EXPECT_THROW(pq.pop(), std::bad_alloc);
+  EXPECT_EQ(8, pq.size());
+  EXPECT_EQ(100, pq.top());
+
+  budget = 100;
+  std::vector<unsigned> ordered;
+  while (not pq.empty()) {
+    ordered.push_back(pq.top());
+    pq.pop();
+  }
+  EXPECT_EQ(std::vector<unsigned>({100, 101, 102, 103, 104, 105, 106, 107}),
+            ordered);
+}
+
+
+TEST(TestRadixPriorityQueue, ClearShouldResetMonotoneContract)
+{
+  RadixPriorityQueue<unsigned> pq;
+  pq.push(100);
+  pq.pop();
+  pq.clear();
+  pq.push(1);
+  EXPECT_EQ(1, pq.top());
+}
+
+} // anonymous namespace
@@ -0,0 +1,216 @@
+/**
+ * @file test_ring_queue.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/ring_queue.hh"
+
+
+namespace {
+
+
+using ospp::RingKind;
+using ospp::RingQueue;
+
+
+/**
+ * Counts how many objects are alive.
+ */
+struct Tracked
+{
+  static int alive;
+  int value;
+
+  Tracked(int v = 0) : value(v) { ++alive; }
+  Tracked(const Tracked& other) : value(other.value) { ++alive; }
+  Tracked& operator=(const Tracked&) = default;
+  ~Tracked() { --alive; }
+};
+
+int Tracked::alive = 0;
+
+
+TEST(TestRingQueue, CapacityShouldBeRoundedUpToPowerOfTwo)
+{
+  RingQueue<int> q(5);
+  EXPECT_EQ(8, q.capacity());
+  EXPECT_TRUE(q.empty());
+
+  RingQueue<int, RingKind::SPSC> s(16);
+  EXPECT_EQ(16, s.capacity());
+}
+
+
+TEST(TestRingQueue, TryPushShouldFailWhenFull)
+{
+  RingQueue<int> q(4);
+  for (int i = 0; i < 4; ++i)
+    EXPECT_TRUE(q.try_push(i));
+  EXPECT_FALSE(q.try_push(4));
+  EXPECT_EQ(4, q.size());
+
+  int value;
+  EXPECT_TRUE(q.try_pop(value));
+  EXPECT_EQ(0, value);
+  EXPECT_TRUE(q.try_push(4));
+}
+
+
+TEST(TestRingQueue, TryPopShouldFailWhenEmpty)
+{
+  RingQueue<int, RingKind::MPSC> q(4);
+  int value = -1;
+  EXPECT_FALSE(q.try_pop(value));
+  EXPECT_EQ(-1, value);
+}
+
+
+TEST(TestRingQueue, ItemsShouldComeOutInFifoOrder)
+{
+  RingQueue<int> mpmc(8);
+  RingQueue<int, RingKind::MPSC> mpsc(8);
+  RingQueue<int, RingKind::SPSC> spsc(8);
+
+  // wrap around the ring a few times
+  for (int round = 0; round < 5; ++round) {
+    for (int i = 0; i < 6; ++i) {
+      mpmc.push(round * 10 + i);
+      mpsc.push(round * 10 + i);
+      spsc.push(round * 10 + i);
+    }
+    for (int i = 0; i < 6; ++i) {
+      int a, b, c;
+      mpmc.pop(a);
+      mpsc.pop(b);
+      spsc.pop(c);
+      EXPECT_EQ(round * 10 + i, a);
+      EXPECT_EQ(round * 10 + i, b);
+      EXPECT_EQ(round * 10 + i, c);
+    }
+  }
+}
+
+
+TEST(TestRingQueue, MoveOnlyItemsShouldBeSupported)
+{
+  RingQueue<std::unique_ptr<int>> q(2);
+  std::unique_ptr<int> p(new int(7));
+  EXPECT_TRUE(q.try_push(std::move(p)));
+  EXPECT_EQ(nullptr, p);
+
+  std::unique_ptr<int> out;
+  EXPECT_TRUE(q.try_pop(out));
+  EXPECT_EQ(7, *out);
+}
+
+
+TEST(TestRingQueue, DestructorShouldDestroyRemainingItems)
+{
+  Tracked::alive = 0;
+  {
+    RingQueue<Tracked> q(4);
+    RingQueue<Tracked, RingKind::SPSC> s(4);
+    q.push(Tracked(1));
+    q.push(Tracked(2));
+    s.push(Tracked(3));
+    EXPECT_EQ(3, Tracked::alive);
+  }
+  EXPECT_EQ(0, Tracked::alive);
+}
+
+
+TEST(TestRingQueue, SpscShouldPreserveOrderAcrossThreads)
+{
+  const int count = 100000;
+  RingQueue<int, RingKind::SPSC> q(64);
+
+  std::thread producer([&q]() {
+    for (int i = 0; i < count; ++i)
+      q.push(i);
+  });
+
+  bool ordered = true;
+  for (int i = 0; i < count; ++i) {
+    int value;
+    q.pop(value);
+    ordered = ordered && value == i;
+  }
+  producer.join();
+
+  EXPECT_TRUE(ordered);
+  EXPECT_TRUE(q.empty());
+}
+
+
+TEST(TestRingQueue, MpmcShouldDeliverEveryItemOnce)
+{
+  const int threads = 4;
+  const int perThread = 20000;
+  RingQueue<int> q(128);
+  std::vector<std::vector<int>> popped(threads);
+  std::vector<std::thread> workers;
+
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&q, t]() {
+      for (int i = 0; i < perThread; ++i)
+        q.push(t * perThread + i);
+    });
+    workers.emplace_back([&q, &popped, t]() {
+      for (int i = 0; i < perThread; ++i) {
+        int value;
+        q.pop(value);
+        popped[t].push_back(value);
+      }
+    });
+  }
+  for (auto& w : workers)
+    w.join();
+
+  std::vector<int> all;
+  for (auto& p : popped)
+    all.insert(all.end(), p.begin(), p.end());
+  std::sort(all.begin(), all.end());
+
+  ASSERT_EQ(threads * perThread, all.size());
+  for (int i = 0; i < threads * perThread; ++i)
+    EXPECT_EQ(i, all[i]);
+}
+
+
+TEST(TestRingQueue, MpscShouldKeepPerProducerOrder)
+{
+  const int producers = 3;
+  const int perThread = 20000;
+  RingQueue<int, RingKind::MPSC> q(64);
+  std::vector<std::thread> workers;
+
+  for (int t = 0; t < producers; ++t) {
+    workers.emplace_back([&q, t]() {
+      for (int i = 0; i < perThread; ++i)
+        q.push(t * perThread + i);
+    });
+  }
+
+  std::vector<int> last(producers, -1);
+  bool ordered = true;
+  for (int i = 0; i < producers * perThread; ++i) {
+    int value;
+    q.pop(value);
+    auto t = value / perThread;
+    ordered = ordered && value > last[t];
+    last[t] = value;
+  }
+  for (auto& w : workers)
+    w.join();
+
+  EXPECT_TRUE(ordered);
+}
+
+} // anonymous namespace
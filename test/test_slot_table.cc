@@ -0,0 +1,112 @@
+/**
+ * @file test_slot_table.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/slot_table.hh"
+
+
+namespace {
+
+
+using ospp::SlotTable;
+
+
+/**
+ * Counts how many times values of this type are moved or copied.
+ */
+struct Counted
+{
+  static int moves;
+  int id;
+
+  explicit Counted(int i) : id(i) {}
+  Counted(const Counted& other) : id(other.id) { ++moves; }
+  Counted(Counted&& other) : id(other.id) { ++moves; }
+};
+
+int Counted::moves = 0;
+
+
+TEST(TestSlotTable, DefaultCtorShouldYieldEmptyTable)
+{
+  SlotTable<int> table;
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(0, table.size());
+  EXPECT_EQ(0, table.capacity());
+  EXPECT_EQ(1024, SlotTable<int>::block);
+  EXPECT_EQ(16, (SlotTable<std::pair<char[1000], int>>::block));
+}
+
+
+TEST(TestSlotTable, GrowingShouldNotMoveTheItems)
+{
+  SlotTable<Counted> table;
+  std::vector<const Counted*> addresses;
+
+  Counted::moves = 0;
+  for (int i = 0; i < 10000; ++i)
+    addresses.push_back(&table.emplace_back(i));
+  EXPECT_EQ(0, Counted::moves);
+  EXPECT_EQ(10000, table.size());
+  EXPECT_LE(10000, table.capacity());
+
+  for (int i = 0; i < 10000; ++i) {
+    ASSERT_EQ(addresses[i], &table[i]);
+    ASSERT_EQ(i, table[i].id);
+  }
+}
+
+
+TEST(TestSlotTable, PopAndClearShouldKeepTheBlocks)
+{
+  SlotTable<std::string> table;
+  for (int i = 0; i < 1000; ++i)
+    table.emplace_back(std::to_string(i));
+  auto capacity = table.capacity();
+
+  table.pop_back();
+  EXPECT_EQ(999, table.size());
+  EXPECT_EQ("998", table[998]);
+
+  table.clear();
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(capacity, table.capacity());
+
+  table.reserve(5000);
+  EXPECT_LE(5000, table.capacity());
+}
+
+
+TEST(TestSlotTable, CopyAndMoveShouldKeepTheItems)
+{
+  SlotTable<std::string> table;
+  for (int i = 0; i < 3000; ++i)
+    table.emplace_back(std::to_string(i));
+  auto first = &table[0];
+
+  SlotTable<std::string> copy(table);
+  ASSERT_EQ(3000, copy.size());
+  EXPECT_EQ("2999", copy[2999]);
+  EXPECT_NE(first, &copy[0]);
+
+  // moving hands over the blocks
+  SlotTable<std::string> moved(std::move(table));
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(first, &moved[0]);
+
+  table = copy;
+  EXPECT_EQ(3000, table.size());
+  EXPECT_EQ("1234", table[1234]);
+  copy = std::move(moved);
+  EXPECT_EQ(first, &copy[0]);
+}
+
+
+} // anonymous namespace
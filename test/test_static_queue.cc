@@ -0,0 +1,152 @@
+/**
+ * @file test_static_queue.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/static_queue.hh"
+
+
+namespace {
+
+
+using ospp::StaticPriorityQueue;
+
+
+std::vector<int> randomInts(int n, unsigned seed)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(-1000, 1000),
+                           std::default_random_engine(seed));
+  std::vector<int> ivec;
+  for (int i = 0; i < n; ++i) ivec.push_back(randInt());
+  return ivec;
+}
+
+
+TEST(TestStaticPriorityQueue, CtorShouldCreateEmptyQueue)
+{
+  StaticPriorityQueue<int, 16> pq;
+  EXPECT_TRUE(pq.empty());
+  EXPECT_FALSE(pq.full());
+  EXPECT_EQ(0, pq.size());
+
+  static_assert(StaticPriorityQueue<int, 16>::capacity() == 16,
+                "the capacity is known at compile time");
+}
+
+
+TEST(TestStaticPriorityQueue, ShouldYieldSortedElements)
+{
+  for (auto n : {1, 2, 3, 7, 8, 9, 63, 64})
+  {
+    auto ivec = randomInts(n, n);
+    StaticPriorityQueue<int, 64> pq;
+    for (auto i : ivec)
+      pq.push(i);
+
+    EXPECT_EQ(static_cast<std::size_t>(n), pq.size());
+    EXPECT_EQ(n == 64, pq.full());
+
+    std::vector<int> out;
+    while (!pq.empty())
+      out.push_back(pq.pop_value());
+
+    std::sort(ivec.begin(), ivec.end());
+    EXPECT_EQ(ivec, out);
+  }
+}
+
+
+TEST(TestStaticPriorityQueue, TryPushShouldRejectItemsWhenFull)
+{
+  StaticPriorityQueue<int, 3, std::greater<int>> pq;
+  EXPECT_TRUE(pq.try_push(2));
+  EXPECT_TRUE(pq.try_push(7));
+  EXPECT_TRUE(pq.try_push(5));
+  EXPECT_TRUE(pq.full());
+
+  EXPECT_FALSE(pq.try_push(9));
+  EXPECT_EQ(7, pq.top());
+
+  pq.pop();
+  EXPECT_TRUE(pq.try_push(9));
+  EXPECT_EQ(9, pq.top());
+}
+
+
+TEST(TestStaticPriorityQueue, ReplaceTopShouldKeepHeapOrder)
+{
+  StaticPriorityQueue<int, 32> pq;
+  for (auto i : randomInts(32, 5))
+    pq.push(i);
+
+  for (auto i : randomInts(200, 6))
+  {
+    if (i > pq.top())
+      pq.replace_top(i);
+  }
+
+  auto prev = pq.pop_value();
+  while (!pq.empty())
+  {
+    EXPECT_LE(prev, pq.top());
+    prev = pq.pop_value();
+  }
+}
+
+
+TEST(TestStaticPriorityQueue, ShouldHoldItemsThatOwnMemory)
+{
+  std::vector<std::string> svec{"pear", "fig", "apple", "kiwi", "plum", "date"};
+
+  StaticPriorityQueue<std::string, 8> pq;
+  for (auto& s : svec)
+    pq.emplace(s);
+
+  auto copy = pq;
+  auto moved = std::move(copy);
+  pq.pop();
+  pq.pop();
+
+  StaticPriorityQueue<std::string, 8> assigned;
+  assigned.push("zebra");
+  assigned = moved;
+
+  std::sort(svec.begin(), svec.end());
+  std::vector<std::string> out;
+  while (!assigned.empty())
+    out.push_back(assigned.pop_value());
+
+  EXPECT_EQ(svec, out);
+  EXPECT_EQ("fig", pq.top());
+}
+
+
+TEST(TestStaticPriorityQueue, ShouldHoldTypesWithoutDefaultCtor)
+{
+  StaticPriorityQueue<std::unique_ptr<int>, 4,
+                      std::function<bool(const std::unique_ptr<int>&,
+                                         const std::unique_ptr<int>&)>>
+    pq([](const std::unique_ptr<int>& a, const std::unique_ptr<int>& b)
+       { return *a < *b; });
+
+  pq.emplace(new int(3));
+  pq.emplace(new int(1));
+  pq.emplace(new int(2));
+
+  EXPECT_EQ(1, *pq.pop_value());
+  EXPECT_EQ(2, *pq.pop_value());
+  EXPECT_EQ(3, *pq.top());
+}
+
+
+} // anonymous namespace
@@ -0,0 +1,242 @@
+/**
+ * @file test_timer_wheel.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/timer_wheel.hh"
+
+
+namespace {
+
+
+using ospp::TimerWheel;
+
+
+TEST(TestTimerWheel, CtorShouldStartEmpty)
+{
+  TimerWheel<int> wheel(100);
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_EQ(0, wheel.size());
+  EXPECT_EQ(100, wheel.now());
+  EXPECT_EQ(6, (TimerWheel<int>::levels));
+}
+
+
+TEST(TestTimerWheel, AdvanceShouldExpireTimersAtTheirDeadline)
+{
+  TimerWheel<std::string> wheel;
+  auto h1 = wheel.schedule(10, "ten");
+  wheel.schedule(5, "five");
+  wheel.schedule(5000, "five thousand");
+  EXPECT_EQ(3, wheel.size());
+  EXPECT_EQ("ten", wheel.get(h1));
+  EXPECT_EQ(10, wheel.deadline(h1));
+
+  std::vector<std::string> expired;
+  auto collect = [&](std::string s) { expired.push_back(s); };
+
+  EXPECT_EQ(0, wheel.advance(4, collect));
+  EXPECT_EQ(1, wheel.advance(9, collect));
+  EXPECT_EQ(std::vector<std::string>{"five"}, expired);
+  EXPECT_EQ(1, wheel.advance(4999, collect));
+  EXPECT_FALSE(wheel.contains(h1));
+  EXPECT_EQ(1, wheel.size());
+  EXPECT_EQ(1, wheel.advance(5000, collect));
+  EXPECT_EQ(5000, wheel.now());
+  EXPECT_TRUE(wheel.empty());
+
+  std::vector<std::string> order{"five", "ten", "five thousand"};
+  EXPECT_EQ(order, expired);
+}
+
+
+TEST(TestTimerWheel, AdvanceShouldExpireInDeadlineOrder)
+{
+  // three levels reach 262144 ticks ahead, so the far timers wrap around
+  TimerWheel<std::pair<uint64_t, int>, 3> wheel(77);
+  auto randTime = std::bind(std::uniform_int_distribution<uint64_t>(0, 1000000),
+                            std::default_random_engine(5));
+  std::vector<std::pair<uint64_t, int>> timers;
+  for (int i = 0; i < 5000; ++i)
+  {
+    auto deadline = 78 + randTime();
+    timers.emplace_back(deadline, i);
+    wheel.schedule(deadline, timers.back());
+  }
+
+  std::vector<std::pair<uint64_t, int>> expired;
+  uint64_t now = 77;
+  while (!wheel.empty())
+  {
+    auto before = now;
+    now += randTime() % 20000;
+    wheel.advance(now, [&](std::pair<uint64_t, int> t) {
+      EXPECT_GT(t.first, before);
+      EXPECT_LE(t.first, now);
+      expired.push_back(t);
+    });
+  }
+
+  EXPECT_TRUE(std::is_sorted(expired.begin(), expired.end(),
+                             [](const std::pair<uint64_t, int>& a,
+                                const std::pair<uint64_t, int>& b) {
+                               return a.first < b.first;
+                             }));
+  std::sort(timers.begin(), timers.end());
+  std::sort(expired.begin(), expired.end());
+  EXPECT_EQ(timers, expired);
+}
+
+
+TEST(TestTimerWheel, CancelShouldRemoveThePendingTimer)
+{
+  TimerWheel<int> wheel;
+  auto h1 = wheel.schedule(100, 1);
+  auto h2 = wheel.schedule(100, 2);
+  auto h3 = wheel.schedule(300, 3);
+
+  EXPECT_TRUE(wheel.cancel(h2));
+  EXPECT_FALSE(wheel.cancel(h2));
+  EXPECT_FALSE(wheel.contains(h2));
+  EXPECT_EQ(2, wheel.size());
+
+  // the entry of the cancelled timer is reused, but not its handle
+  auto h4 = wheel.schedule(200, 4);
+  EXPECT_NE(h2, h4);
+  EXPECT_FALSE(wheel.cancel(h2));
+  EXPECT_TRUE(wheel.contains(h4));
+
+  std::vector<int> expired;
+  wheel.advance(1000, [&](int i) { expired.push_back(i); });
+  EXPECT_EQ((std::vector<int>{1, 4, 3}), expired);
+  EXPECT_FALSE(wheel.cancel(h1));
+  EXPECT_FALSE(wheel.cancel(h3));
+}
+
+
+TEST(TestTimerWheel, CancelShouldReleaseTheValue)
+{
+  TimerWheel<std::shared_ptr<int>> wheel;
+  auto ptr = std::make_shared<int>(7);
+  auto handle = wheel.schedule(50, ptr);
+  EXPECT_EQ(2, ptr.use_count());
+
+  wheel.cancel(handle);
+  EXPECT_EQ(1, ptr.use_count());
+}
+
+
+TEST(TestTimerWheel, CancelShouldReuseEntriesWithoutAllocating)
+{
+  TimerWheel<int> wheel;
+  static_assert(noexcept(wheel.cancel(0)), "cancel must not allocate");
+
+  std::vector<TimerWheel<int>::handle_type> handles;
+  for (int i = 0; i < 1000; ++i)
+    handles.push_back(wheel.schedule(1 + i % 300, i));
+
+  // a copy gets the free entries too, and frees into them
+  auto copy = wheel;
+  for (int i = 0; i < 1000; i += 2) {
+    EXPECT_TRUE(wheel.cancel(handles[i]));
+    EXPECT_TRUE(copy.cancel(handles[i + 1]));
+  }
+  for (int i = 0; i < 500; ++i) {
+    wheel.schedule(400 + i, 1000 + i);
+    copy.schedule(400 + i, 1000 + i);
+  }
+
+  std::vector<int> expired, expiredCopy;
+  wheel.advance(1000, [&](int i) { expired.push_back(i); });
+  copy.advance(1000, [&](int i) { expiredCopy.push_back(i); });
+  EXPECT_EQ(1000, expired.size());
+  EXPECT_EQ(1000, expiredCopy.size());
+  for (int i = 0; i < 500; ++i) {
+    EXPECT_EQ(1000 + i, expired[500 + i]);
+    EXPECT_EQ(1000 + i, expiredCopy[500 + i]);
+  }
+  EXPECT_TRUE(std::all_of(expired.begin(), expired.begin() + 500,
+                          [](int i) { return i % 2 == 1; }));
+  EXPECT_TRUE(std::all_of(expiredCopy.begin(), expiredCopy.begin() + 500,
+                          [](int i) { return i % 2 == 0; }));
+}
+
+
+TEST(TestTimerWheel, PastDeadlineShouldExpireOnTheNextTick)
+{
+  TimerWheel<int> wheel(1000);
+  wheel.schedule(10, 1);
+  wheel.schedule(1000, 2);
+
+  std::vector<int> expired;
+  EXPECT_EQ(2, wheel.advance(1001, [&](int i) { expired.push_back(i); }));
+  EXPECT_EQ((std::vector<int>{1, 2}), expired);
+}
+
+
+TEST(TestTimerWheel, CallbackShouldBeAbleToScheduleAndCancel)
+{
+  TimerWheel<int> wheel;
+  auto victim = wheel.schedule(20, -1);
+  wheel.schedule(10, 0);
+
+  std::vector<std::pair<uint64_t, int>> expired;
+  wheel.advance(100, [&](int i) {
+    expired.emplace_back(wheel.now(), i);
+    if (i == 0)
+      wheel.cancel(victim);
+    if (i < 3)
+      wheel.schedule(wheel.now() + 30, i + 1);
+  });
+
+  std::vector<std::pair<uint64_t, int>> order{
+    {10, 0}, {40, 1}, {70, 2}, {100, 3}};
+  EXPECT_EQ(order, expired);
+  EXPECT_TRUE(wheel.empty());
+}
+
+
+TEST(TestTimerWheel, FarTimersShouldGoAroundTheTopLevel)
+{
+  // two levels reach 4096 ticks ahead
+  TimerWheel<int, 2> wheel;
+  wheel.schedule(1000000, 1);
+  wheel.schedule(4096, 2);
+  wheel.schedule(4095, 3);
+
+  std::vector<std::pair<uint64_t, int>> expired;
+  auto collect = [&](int i) { expired.emplace_back(wheel.now(), i); };
+  EXPECT_EQ(2, wheel.advance(999999, collect));
+  EXPECT_EQ(1, wheel.advance(2000000, collect));
+
+  std::vector<std::pair<uint64_t, int>> order{
+    {4095, 3}, {4096, 2}, {1000000, 1}};
+  EXPECT_EQ(order, expired);
+}
+
+
+TEST(TestTimerWheel, ClearShouldCancelAllTimers)
+{
+  TimerWheel<int> wheel;
+  auto handle = wheel.schedule(10, 1);
+  wheel.schedule(20, 2);
+  wheel.clear();
+
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_FALSE(wheel.contains(handle));
+  EXPECT_EQ(0, wheel.advance(100, [](int) {}));
+}
+
+
+} // anonymous namespace
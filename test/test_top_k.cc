@@ -0,0 +1,147 @@
+/**
+ * @file test_top_k.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/top_k.hh"
+
+
+namespace {
+
+
+using ospp::TopK;
+
+
+std::vector<int> randomInts(int n, unsigned seed)
+{
+  auto randInt = std::bind(std::uniform_int_distribution<>(-1000, 1000),
+                           std::default_random_engine(seed));
+  std::vector<int> ivec;
+  for (int i = 0; i < n; ++i) ivec.push_back(randInt());
+  return ivec;
+}
+
+
+TEST(TestTopK, CtorShouldReserveK)
+{
+  TopK<int> top(100);
+  EXPECT_TRUE(top.empty());
+  EXPECT_FALSE(top.full());
+  EXPECT_EQ(0, top.size());
+  EXPECT_EQ(100, top.capacity());
+}
+
+
+TEST(TestTopK, OfferShouldKeepTheBestK)
+{
+  auto ivec = randomInts(5000, 3);
+  TopK<int> top(25);
+  for (auto i : ivec)
+    top.offer(i);
+
+  EXPECT_TRUE(top.full());
+  EXPECT_EQ(25, top.size());
+
+  std::vector<int> best;
+  top.drain_sorted(std::back_inserter(best));
+  EXPECT_TRUE(top.empty());
+
+  std::sort(ivec.begin(), ivec.end());
+  ivec.resize(25);
+  EXPECT_EQ(ivec, best);
+}
+
+
+TEST(TestTopK, WorstShouldBeTheNextItemEvicted)
+{
+  TopK<int, std::greater<int>> top(3);
+  EXPECT_TRUE(top.offer(5));
+  EXPECT_TRUE(top.offer(1));
+  EXPECT_TRUE(top.offer(9));
+  EXPECT_EQ(1, top.worst());
+
+  EXPECT_FALSE(top.offer(0));
+  EXPECT_FALSE(top.offer(1));
+  EXPECT_EQ(1, top.worst());
+
+  EXPECT_TRUE(top.offer(7));
+  EXPECT_EQ(5, top.worst());
+  EXPECT_EQ(3, top.size());
+}
+
+
+TEST(TestTopK, RangeOfferShouldMatchItemOffer)
+{
+  auto ivec = randomInts(3000, 11);
+  TopK<int, std::greater<int>, std::allocator<int>, 4> byRange(40);
+  TopK<int, std::greater<int>, std::allocator<int>, 4> byItem(40);
+
+  auto accepted = byRange.offer(ivec.begin(), ivec.end());
+  std::size_t expected = 0;
+  for (auto i : ivec)
+    expected += byItem.offer(i);
+  EXPECT_EQ(expected, accepted);
+
+  std::vector<int> a, b;
+  byRange.drain_sorted(std::back_inserter(a));
+  byItem.drain_sorted(std::back_inserter(b));
+  EXPECT_EQ(b, a);
+
+  std::sort(ivec.begin(), ivec.end(), std::greater<int>());
+  ivec.resize(40);
+  EXPECT_EQ(ivec, a);
+}
+
+
+TEST(TestTopK, InputRangeOfferShouldKeepTheBestK)
+{
+  std::istringstream in("4 8 15 16 23 42 1 2 3");
+  TopK<int> top(4);
+  auto accepted = top.offer(std::istream_iterator<int>(in),
+                            std::istream_iterator<int>());
+  EXPECT_EQ(7, accepted);
+
+  std::vector<int> best;
+  top.drain_sorted(std::back_inserter(best));
+  EXPECT_EQ(std::vector<int>({1, 2, 3, 4}), best);
+}
+
+
+TEST(TestTopK, ShortStreamShouldKeepEverything)
+{
+  TopK<std::string> top(10);
+  top.offer(std::string("pear"));
+  top.offer(std::string("apple"));
+  top.offer(std::string("fig"));
+  EXPECT_FALSE(top.full());
+
+  std::vector<std::string> best;
+  top.drain_sorted(std::back_inserter(best));
+  EXPECT_EQ(std::vector<std::string>({"apple", "fig", "pear"}), best);
+}
+
+
+TEST(TestTopK, ZeroLimitShouldRejectEverything)
+{
+  TopK<int> top(0);
+  EXPECT_TRUE(top.full());
+  EXPECT_FALSE(top.offer(1));
+
+  std::vector<int> ivec({3, 2, 1});
+  EXPECT_EQ(0, top.offer(ivec.begin(), ivec.end()));
+  EXPECT_TRUE(top.empty());
+}
+
+
+} // namespace
@@ -0,0 +1,65 @@
+/**
+ * @file test_worker_pool.cc
+ * @author Omar A Serrano
+ * @date 2026-10-17
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "queue/worker_pool.hh"
+
+
+namespace {
+
+
+using ospp::WorkerPool;
+
+
+TEST(TestWorkerPool, ThreadsShouldCountTheCallingThread)
+{
+  EXPECT_EQ(1, WorkerPool(0).threads());
+  EXPECT_EQ(1, WorkerPool(1).threads());
+  EXPECT_EQ(4, WorkerPool(4).threads());
+}
+
+
+TEST(TestWorkerPool, RunShouldRunEveryTaskOnce)
+{
+  for (std::size_t threads : {1, 2, 5}) {
+    WorkerPool pool(threads);
+    std::vector<std::atomic<int>> runs(1000);
+    for (auto& count : runs) count = 0;
+
+    for (std::size_t tasks : {0, 1, 7, 1000}) {
+      pool.run(tasks, [&](std::size_t i) { ++runs[i]; });
+      for (std::size_t i = 0; i < runs.size(); ++i)
+        ASSERT_EQ(i < tasks, runs[i].load() == 1) << i;
+      for (auto& count : runs) count = 0;
+    }
+  }
+}
+
+
+TEST(TestWorkerPool, BatchesShouldRunOneAfterTheOther)
+{
+  // each batch reads what the one before wrote
+  WorkerPool pool(4);
+  std::vector<long> values(64, 1);
+  for (int batch = 0; batch < 200; ++batch) {
+    std::vector<long> next(values.size());
+    pool.run(values.size(), [&](std::size_t i) {
+      next[i] = values[i] + values[(i + 1) % values.size()];
+    });
+    values.swap(next);
+    for (auto& value : values) value %= 1000003;
+  }
+
+  for (auto value : values)
+    EXPECT_EQ(values[0], value);
+}
+
+
+} // anonymous namespace